@@ -56,6 +56,10 @@
 #                  *.h lexfer file.  If not defined, the output path is the same
 #                  path as the token list file path, with a file name of *_lexer.h
 #
+# Besides the keyword table, the cpp file holds a lookup function which finds a keyword
+# with a switch on its length and first character, and a comparison with the few
+# keywords left.  DSNLEXER uses it instead of hashing every symbol it reads.
+#
 # Use the max_lexer() CMake function from functions.cmake for invocation convenience.
 
 
@@ -150,6 +154,8 @@ set( sourceFileHeader
  * your DSN lexer.
  */
 
+#include <cstring>
+
 #include <${outHeaderFile}>
 
 using namespace ${enum};
@@ -240,6 +246,9 @@ class ${LEXERCLASS} : public DSNLEXER
     static const KEYWORD  keywords[];
     static const unsigned keyword_count;
 
+    /// Auto generated keyword lookup, see KEYWORD_LOOKUP.
+    static int lookupKeyword( const char* aToken, size_t aLength );
+
 public:
     /**
      * Constructor ( const std::string&, const wxString& )
@@ -248,7 +257,7 @@ public:
      *   If left empty, then _(\"clipboard\") is used.
      */
     ${LEXERCLASS}( const std::string& aSExpression, const wxString& aSource = wxEmptyString ) :
-        DSNLEXER( keywords, keyword_count, aSExpression, aSource )
+        DSNLEXER( keywords, keyword_count, aSExpression, aSource, lookupKeyword )
     {
     }
 
@@ -262,7 +271,7 @@ public:
      * @param aFilename is the name of the opened file, needed for error reporting.
      */
     ${LEXERCLASS}( FILE* aFile, const wxString& aFilename ) :
-        DSNLEXER( keywords, keyword_count, aFile, aFilename )
+        DSNLEXER( keywords, keyword_count, aFile, aFilename, lookupKeyword )
     {
     }
 
@@ -278,7 +287,7 @@ public:
      *  STRING_LINE_READER or FILE_LINE_READER.  No ownership is taken of aLineReader.
      */
     ${LEXERCLASS}( LINE_READER* aLineReader ) :
-        DSNLEXER( keywords, keyword_count, aLineReader )
+        DSNLEXER( keywords, keyword_count, aLineReader, lookupKeyword )
     {
     }
 
@@ -383,5 +392,79 @@ const char* ${LEXERCLASS}::TokenName( T aTok )
 
     return ret;
 }
+
+
+int ${LEXERCLASS}::lookupKeyword( const char* aToken, size_t aLength )
+{
+    switch( aLength )
+    {
+"
+)
+
+# Sort the keywords by length, then by first character, to emit the switch cases.  The
+# length is zero padded so it sorts as a number.
+set( lookupKeys "" )
+
+foreach( token ${tokens} )
+    string( LENGTH "${token}" tokenLength )
+
+    if( tokenLength LESS 10 )
+        list( APPEND lookupKeys "00${tokenLength}:${token}" )
+    elseif( tokenLength LESS 100 )
+        list( APPEND lookupKeys "0${tokenLength}:${token}" )
+    else()
+        list( APPEND lookupKeys "${tokenLength}:${token}" )
+    endif()
+endforeach()
+
+list( SORT lookupKeys )
+
+set( curLength "" )
+set( curFirst "" )
+
+foreach( key ${lookupKeys} )
+    string( REGEX REPLACE "^0*([0-9]+):.*$" "\\1" tokenLength "${key}" )
+    string( REGEX REPLACE "^[0-9]+:" "" token "${key}" )
+    string( SUBSTRING "${token}" 0 1 first )
+    string( SUBSTRING "${token}" 1 -1 rest )
+
+    if( NOT tokenLength STREQUAL curLength )
+        if( NOT curLength STREQUAL "" )
+            file( APPEND "${outCppFile}" "            break;\n        }\n        break;\n\n" )
+        endif()
+
+        file( APPEND "${outCppFile}" "    case ${tokenLength}:\n        switch( aToken[0] )\n        {\n" )
+        set( curLength "${tokenLength}" )
+        set( curFirst "" )
+    endif()
+
+    if( NOT first STREQUAL curFirst )
+        if( NOT curFirst STREQUAL "" )
+            file( APPEND "${outCppFile}" "            break;\n" )
+        endif()
+
+        file( APPEND "${outCppFile}" "        case '${first}':\n" )
+        set( curFirst "${first}" )
+    endif()
+
+    if( tokenLength EQUAL 1 )
+        file( APPEND "${outCppFile}" "            return T_${token};\n" )
+    else()
+        math( EXPR restLength "${tokenLength} - 1" )
+        file( APPEND "${outCppFile}"
+              "            if( !memcmp( aToken + 1, \"${rest}\", ${restLength} ) )\n"
+              "                return T_${token};\n" )
+    endif()
+endforeach()
+
+if( NOT curLength STREQUAL "" )
+    file( APPEND "${outCppFile}" "            break;\n        }\n        break;\n" )
+endif()
+
+file( APPEND "${outCppFile}"
+"    }
+
+    return DSN_SYMBOL;      // not a keyword, some arbitrary symbol.
+}
 "
 )
@@ -39,6 +39,7 @@
 #include <title_block.h>
 #include <common.h>
 #include <base_units.h>
+#include <kicad_string.h>
 #include "libeval/numeric_evaluator.h"
 
 
@@ -62,31 +63,32 @@
 
 std::string Double2Str( double aValue )
 {
-    char    buf[50];
-    int     len;
+    std::string buf;
 
     if( aValue != 0.0 && fabs( aValue ) <= 0.0001 )
     {
         // For these small values, %f works fine,
         // and %g gives an exponent
-        len = sprintf( buf,  "%.16f", aValue );
+        buf = FormatDouble( "%.16f", aValue );
+
+        size_t len = buf.size();
 
         while( --len > 0 && buf[len] == '0' )
-            buf[len] = '\0';
+            ;
 
-        if( buf[len] == '.' )
-            buf[len] = '\0';
-        else
+        if( buf[len] != '.' )
             ++len;
+
+        buf.resize( len );
     }
     else
     {
         // For these values, %g works fine, and sometimes %f
         // gives a bad value (try aValue = 1.222222222222, with %.16f format!)
-        len = sprintf( buf, "%.16g", aValue );
+        buf = FormatDouble( "%.16g", aValue );
     }
 
-    return std::string( buf, len );
+    return buf;
 }
 
 
@@ -464,45 +466,59 @@ wxString GetAbbreviatedUnitsLabel( EDA_UNITS_T aUnit, bool aUseMils )
 
 std::string FormatInternalUnits( int aValue )
 {
-    char    buf[50];
-    double  engUnits = aValue;
-    int     len;
-
-#ifndef EESCHEMA
-    engUnits /= IU_PER_MM;
-#endif
-
-    if( engUnits != 0.0 && fabs( engUnits ) <= 0.0001 )
+#ifdef EESCHEMA
+    // Schematic internal units are written as they are
+    return std::to_string( aValue );
+#else
+    // Internal units are a power of ten of millimeters, so the value in mm is written exactly
+    // with integer arithmetic.  This is what "%.10g" gives for any int, and it is neither
+    // locale dependent nor slowed down by the double conversions.
+    static const int64_t iuPerMM = KiROUND( IU_PER_MM );
+    static const int     fractionDigits = KiROUND( log10( IU_PER_MM ) );
+
+    char     buf[50];
+    char*    end = buf + sizeof( buf );
+    char*    cp = end;
+    int64_t  magnitude = std::abs( (int64_t) aValue );
+    int64_t  whole = magnitude / iuPerMM;
+    int64_t  fraction = magnitude % iuPerMM;
+    int      digits = fractionDigits;
+
+    // No trailing 0 in the fraction
+    while( digits > 0 && fraction % 10 == 0 )
     {
-        len = snprintf( buf, sizeof(buf), "%.10f", engUnits );
+        fraction /= 10;
+        digits--;
+    }
 
-        while( --len > 0 && buf[len] == '0' )
-            buf[len] = '\0';
+    if( digits > 0 )
+    {
+        for( ; digits > 0; digits-- )
+        {
+            *--cp = '0' + fraction % 10;
+            fraction /= 10;
+        }
 
-#ifndef EESCHEMA
-        if( buf[len] == '.' )
-            buf[len] = '\0';
-        else
-#endif
-            ++len;
+        *--cp = '.';
     }
-    else
+
+    do
     {
-        len = snprintf( buf, sizeof(buf), "%.10g", engUnits );
-    }
+        *--cp = '0' + whole % 10;
+        whole /= 10;
+    } while( whole );
+
+    if( aValue < 0 )
+        *--cp = '-';
 
-    return std::string( buf, len );
+    return std::string( cp, end );
+#endif
 }
 
 
 std::string FormatAngle( double aAngle )
 {
-    char temp[50];
-    int len;
-
-    len = snprintf( temp, sizeof(temp), "%.10g", aAngle / 10.0 );
-
-    return std::string( temp, len );
+    return FormatDouble( "%.10g", aAngle / 10.0 );
 }
 
 
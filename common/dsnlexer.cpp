@@ -24,6 +24,7 @@
  */
 
 
+#include <algorithm>
 #include <cstdarg>
 #include <cstdio>
 #include <cstdlib>         // bsearch()
@@ -55,6 +56,10 @@ void DSNLEXER::init()
     curOffset = 0;
 
 #if 1
+    // The generated lookup needs no table
+    if( keywordLookup )
+        return;
+
     if( keywordCount > 11 )
     {
         // resize the hashtable bucket count
@@ -74,14 +79,15 @@ void DSNLEXER::init()
 
 
 DSNLEXER::DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
-                    FILE* aFile, const wxString& aFilename ) :
+                    FILE* aFile, const wxString& aFilename, KEYWORD_LOOKUP aKeywordLookup ) :
     iOwnReaders( true ),
     start( NULL ),
     next( NULL ),
     limit( NULL ),
     reader( NULL ),
     keywords( aKeywordTable ),
-    keywordCount( aKeywordCount )
+    keywordCount( aKeywordCount ),
+    keywordLookup( aKeywordLookup )
 {
     FILE_LINE_READER* fileReader = new FILE_LINE_READER( aFile, aFilename );
     PushReader( fileReader );
@@ -90,14 +96,16 @@ DSNLEXER::DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
 
 
 DSNLEXER::DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
-                    const std::string& aClipboardTxt, const wxString& aSource ) :
+                    const std::string& aClipboardTxt, const wxString& aSource,
+                    KEYWORD_LOOKUP aKeywordLookup ) :
     iOwnReaders( true ),
     start( NULL ),
     next( NULL ),
     limit( NULL ),
     reader( NULL ),
     keywords( aKeywordTable ),
-    keywordCount( aKeywordCount )
+    keywordCount( aKeywordCount ),
+    keywordLookup( aKeywordLookup )
 {
     STRING_LINE_READER* stringReader = new STRING_LINE_READER( aClipboardTxt, aSource.IsEmpty() ?
                                         wxString( FMT_CLIPBOARD ) : aSource );
@@ -107,14 +115,15 @@ DSNLEXER::DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
 
 
 DSNLEXER::DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
-                    LINE_READER* aLineReader ) :
+                    LINE_READER* aLineReader, KEYWORD_LOOKUP aKeywordLookup ) :
     iOwnReaders( false ),
     start( NULL ),
     next( NULL ),
     limit( NULL ),
     reader( NULL ),
     keywords( aKeywordTable ),
-    keywordCount( aKeywordCount )
+    keywordCount( aKeywordCount ),
+    keywordLookup( aKeywordLookup )
 {
     if( aLineReader )
         PushReader( aLineReader );
@@ -131,7 +140,8 @@ DSNLEXER::DSNLEXER( const std::string& aSExpression, const wxString& aSource ) :
     limit( NULL ),
     reader( NULL ),
     keywords( empty_keywords ),
-    keywordCount( 0 )
+    keywordCount( 0 ),
+    keywordLookup( NULL )
 {
     STRING_LINE_READER* stringReader = new STRING_LINE_READER( aSExpression, aSource.IsEmpty() ?
                                         wxString( FMT_CLIPBOARD ) : aSource );
@@ -242,6 +252,9 @@ static int compare( const void* a1, const void* a2 )
 
 int DSNLEXER::findToken( const std::string& tok )
 {
+    if( keywordLookup )
+        return keywordLookup( tok.c_str(), tok.size() );
+
     KEYWORD search;
 
     search.name = tok.c_str();
@@ -259,6 +272,9 @@ int DSNLEXER::findToken( const std::string& tok )
 
 inline int DSNLEXER::findToken( const std::string& tok )
 {
+    if( keywordLookup )
+        return keywordLookup( tok.c_str(), tok.size() );
+
     KEYWORD_MAP::const_iterator it = keyword_hash.find( tok.c_str() );
     if( it != keyword_hash.end() )
         return it->second;
@@ -776,14 +792,15 @@ L_read:
         }
     }           // specctraMode
 
-    // non-quoted token, read it into curText.
-    curText.clear();
-
+    // non-quoted token, find its end and copy it into curText in one go.  curText keeps
+    // its capacity between tokens, so this does not allocate once it has grown.
     head = cur;
     while( head<limit && !isSep( *head ) )
-        curText += *head++;
+        ++head;
+
+    curText.assign( cur, head );
 
-    if( isNumber( curText.c_str(), curText.c_str() + curText.size() ) )
+    if( isNumber( cur, head ) )
     {
         curTok = DSN_NUMBER;
         goto exit;
@@ -829,3 +846,76 @@ wxArrayString* DSNLEXER::ReadCommentLines()
 
     return ret;
 }
+
+
+std::string DSNLEXER::ReadUnparsedList()
+{
+    // Keep the keyword column, the opening paren being just before it
+    std::string text( std::max( curOffset - 1, 0 ), ' ' );
+
+    text += '(';
+    text += curText;
+
+    const char* cur = next;
+    const char* lineStart = cur;
+    int         depth = 1;
+    bool        quoted = false;
+    bool        tokenStart = false;
+
+    while( depth > 0 )
+    {
+        if( cur >= limit )
+        {
+            text.append( lineStart, cur );
+
+            if( readLine() == 0 )
+            {
+                curTok = DSN_EOF;
+                curOffset = 0;
+                Expecting( DSN_RIGHT );
+            }
+
+            cur = lineStart = start;
+
+            // Quoted strings do not span lines
+            quoted = false;
+            tokenStart = true;
+            continue;
+        }
+
+        char cc = *cur++;
+
+        if( quoted )
+        {
+            if( cc == '\\' && !specctraMode && cur < limit )
+                ++cur;
+            else if( cc == stringDelimiter )
+                quoted = false;
+        }
+        else if( cc == stringDelimiter && tokenStart )
+        {
+            quoted = true;
+        }
+        else if( cc == '(' )
+        {
+            ++depth;
+        }
+        else if( cc == ')' )
+        {
+            --depth;
+        }
+
+        tokenStart = isSep( cc );
+    }
+
+    text.append( lineStart, cur );
+
+    // As if the closing paren was just read
+    prevTok   = curTok;
+    curTok    = DSN_RIGHT;
+    curText   = ")";
+    curOffset = cur - 1 - start;
+    next      = cur;
+
+    return text;
+}
@@ -117,10 +117,16 @@ EDGE_PTR TRIANGULATION::InitTwoEnclosingTriangles( NODES_CONTAINER::iterator aFi
     double dx = ( xmax - xmin ) / fac;
     double dy = ( ymax - ymin ) / fac;
 
-    NODE_PTR n1 = std::make_shared<NODE>( xmin - dx, ymin - dy );
-    NODE_PTR n2 = std::make_shared<NODE>( xmax + dx, ymin - dy );
-    NODE_PTR n3 = std::make_shared<NODE>( xmax + dx, ymax + dy );
-    NODE_PTR n4 = std::make_shared<NODE>( xmin - dx, ymax + dy );
+    return InitTwoEnclosingTriangles( xmin - dx, ymin - dy, xmax + dx, ymax + dy );
+}
+
+
+EDGE_PTR TRIANGULATION::InitTwoEnclosingTriangles( int aXmin, int aYmin, int aXmax, int aYmax )
+{
+    NODE_PTR n1 = std::make_shared<NODE>( aXmin, aYmin );
+    NODE_PTR n2 = std::make_shared<NODE>( aXmax, aYmin );
+    NODE_PTR n3 = std::make_shared<NODE>( aXmax, aYmax );
+    NODE_PTR n4 = std::make_shared<NODE>( aXmin, aYmax );
 
     // diagonal
     EDGE_PTR e1d = std::make_shared<EDGE>();
@@ -284,6 +290,64 @@ void TRIANGULATION::ReverseSplitTriangle( EDGE_PTR& aEdge )
 }
 
 
+void TRIANGULATION::CreateDelaunay( NODES_CONTAINER::iterator aFirst,
+                                    NODES_CONTAINER::iterator aLast,
+                                    int aXmin, int aYmin, int aXmax, int aYmax )
+{
+    cleanAll();
+
+    EDGE_PTR bedge = InitTwoEnclosingTriangles( aXmin, aYmin, aXmax, aYmax );
+    DART d_iter( bedge );
+
+    for( NODES_CONTAINER::iterator it = aFirst; it != aLast; ++it )
+        m_helper->InsertNode<TTLtraits>( d_iter, *it );
+
+    // The enclosing rectangle is kept, so InsertNode() and RemoveNode() always work on
+    // interior nodes
+}
+
+
+bool TRIANGULATION::InsertNode( const NODE_PTR& aNode )
+{
+    if( m_leadingEdges.empty() )
+        return false;
+
+    DART     dart = CreateDart();
+    NODE_PTR node = aNode;
+
+    return m_helper->InsertNode<TTLtraits>( dart, node );
+}
+
+
+bool TRIANGULATION::RemoveNode( const NODE_PTR& aNode )
+{
+    if( m_leadingEdges.empty() )
+        return false;
+
+    DART dart = CreateDart();
+
+    if( !ttl::TRIANGULATION_HELPER::LocateTriangle<TTLtraits>( aNode, dart ) )
+        return false;
+
+    // The node is a corner of the triangle it was located in, walk to it keeping the dart CCW
+    for( int i = 0; i < 3; ++i )
+    {
+        if( dart.GetNode() == aNode )
+        {
+            if( ttl::TRIANGULATION_HELPER::IsBoundaryNode( dart ) )
+                return false;
+
+            m_helper->RemoveInteriorNode<TTLtraits>( dart );
+            return true;
+        }
+
+        dart.Alpha0().Alpha1();
+    }
+
+    return false;
+}
+
+
 DART TRIANGULATION::CreateDart()
 {
   // Return an arbitrary CCW dart
@@ -321,6 +385,9 @@ void TRIANGULATION::cleanAll()
 {
     for( EDGE_PTR& edge : m_leadingEdges )
         edge->SetNextEdgeInFace( EDGE_PTR() );
+
+    // The triangulation may be created again
+    m_leadingEdges.clear();
 }
 
 
@@ -87,7 +87,7 @@ class WS_DATA_MODEL_FILEIO: public WS_DATA_MODEL_IO
 
 public:
     WS_DATA_MODEL_FILEIO( const wxString& aFilename ):
-        WS_DATA_MODEL_IO()
+        WS_DATA_MODEL_IO(), m_fileout( nullptr )
     {
         try
         {
@@ -104,6 +104,22 @@ public:
     {
         delete m_fileout;
     }
+
+    // Write out the end of the file, which is buffered by the formatter
+    void Finish()
+    {
+        if( !m_fileout )
+            return;
+
+        try
+        {
+            m_fileout->Finish();
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            wxMessageBox( ioe.What(), _( "Error writing page layout design file" ) );
+        }
+    }
 };
 
 
@@ -143,6 +159,7 @@ void WS_DATA_MODEL::Save( const wxString& aFullFileName )
 {
     WS_DATA_MODEL_FILEIO writer( aFullFileName );
     writer.Format( this );
+    writer.Finish();
 }
 
 
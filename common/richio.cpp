@@ -23,11 +23,21 @@
  */
 
 
+#include <algorithm>
 #include <cstdarg>
 #include <config.h> // HAVE_FGETC_NOLOCK
 
 #include <richio.h>
 
+#include <wx/ffile.h>
+
+#if !defined( _WIN32 )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 
 // Fall back to getc() when getc_unlocked() is not available on the target platform.
 #if !defined( HAVE_FGETC_NOLOCK )
@@ -225,13 +235,228 @@ char* FILE_LINE_READER::ReadLine()
 }
 
 
-STRING_LINE_READER::STRING_LINE_READER( const std::string& aString, const wxString& aSource ):
+/// How much of a mapped file is read between two checks of its size
+static const size_t MMAP_SIZE_CHECK_INTERVAL = 1024 * 1024;
+
+
+MMAP_LINE_READER::MMAP_LINE_READER( const wxString& aFileName, bool aNulTerminated,
+            unsigned aStartingLineNumber, unsigned aMaxLineLength ):
+    LINE_READER( 0 ),   // lines are handed out from our own storage, no line buffer is needed
+    m_data( NULL ), m_size( 0 ), m_mapped( false ), m_nulTerminated( aNulTerminated ),
+    m_fd( -1 ), m_ndx( 0 ), m_nextSizeCheck( MMAP_SIZE_CHECK_INTERVAL )
+{
+    m_maxLineLength = aMaxLineLength;
+
+    wxString msg = wxString::Format(
+        _( "Unable to open filename \"%s\" for reading" ), aFileName.GetData() );
+
+#if !defined( _WIN32 )
+    int fd = open( aFileName.fn_str(), O_RDONLY );
+
+    if( fd < 0 )
+        THROW_IO_ERROR( msg );
+
+    struct stat st;
+
+    if( fstat( fd, &st ) == 0 && st.st_size > 0 )
+    {
+        void* data = mmap( NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+        if( data != MAP_FAILED )
+        {
+            madvise( data, st.st_size, MADV_SEQUENTIAL );
+            m_data = (char*) data;
+            m_size = st.st_size;
+            m_mapped = true;
+            m_fd = fd;
+        }
+    }
+
+    if( !m_mapped )
+        close( fd );
+#endif
+
+    if( !m_mapped )
+    {
+        wxFFile file( aFileName, wxT( "rb" ) );
+
+        if( !file.IsOpened() )
+            THROW_IO_ERROR( msg );
+
+        wxFileOffset length = file.Length();
+
+        if( length > 0 )
+        {
+            m_data = new char[length];
+            m_size = file.Read( m_data, length );
+        }
+    }
+
+    m_source  = aFileName;
+    m_lineNum = aStartingLineNumber;
+    m_line    = &m_lineCopy[0];
+}
+
+
+MMAP_LINE_READER::~MMAP_LINE_READER()
+{
+#if !defined( _WIN32 )
+    if( m_mapped )
+    {
+        munmap( m_data, m_size );
+        close( m_fd );
+    }
+#endif
+
+    if( !m_mapped )
+        delete[] m_data;
+
+    // m_line points into storage we do not own, keep ~LINE_READER() from deleting it
+    m_line = NULL;
+}
+
+
+void MMAP_LINE_READER::checkFileSize()
+{
+#if !defined( _WIN32 )
+    struct stat st;
+
+    if( m_mapped && ( fstat( m_fd, &st ) != 0 || (size_t) st.st_size != m_size ) )
+    {
+        openFileReader( m_ndx, m_lineNum );
+        return;
+    }
+#endif
+
+    m_nextSizeCheck = m_ndx + MMAP_SIZE_CHECK_INTERVAL;
+}
+
+
+void MMAP_LINE_READER::openFileReader( size_t aOffset, unsigned aLineNumber )
+{
+#if !defined( _WIN32 )
+    if( m_mapped )
+    {
+        munmap( m_data, m_size );
+        close( m_fd );
+        m_data = NULL;
+        m_size = 0;
+        m_mapped = false;
+        m_fd = -1;
+    }
+#endif
+
+    FILE* fp = wxFopen( m_source, wxT( "rb" ) );
+
+    if( !fp )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "Unable to open filename \"%s\" for reading" ),
+                                          m_source.GetData() ) );
+    }
+
+    fseek( fp, aOffset, SEEK_SET );
+
+    m_fileReader.reset( new FILE_LINE_READER( fp, m_source, true, aLineNumber,
+                                              m_maxLineLength ) );
+    m_ndx = aOffset;
+    m_nextSizeCheck = std::string::npos;
+}
+
+
+char* MMAP_LINE_READER::ReadLine()
+{
+    if( m_ndx >= m_nextSizeCheck )
+        checkFileSize();
+
+    if( m_fileReader )
+    {
+        m_line    = m_fileReader->ReadLine();
+        m_length  = m_fileReader->Length();
+        m_lineNum = m_fileReader->LineNumber();
+        m_ndx += m_length;
+
+        if( !m_line )
+        {
+            m_lineCopy.clear();
+            m_line = &m_lineCopy[0];
+            return NULL;
+        }
+
+        return m_line;
+    }
+
+    // incremented even if there was no line read, as in FILE_LINE_READER
+    ++m_lineNum;
+
+    if( m_ndx >= m_size )
+    {
+        m_length = 0;
+        m_lineCopy.clear();
+        m_line = &m_lineCopy[0];
+        return NULL;
+    }
+
+    const char* nl  = (const char*) memchr( m_data + m_ndx, '\n', m_size - m_ndx );
+    size_t      end = nl ? nl - m_data + 1 : m_size;     // include the newline
+
+    if( end - m_ndx >= m_maxLineLength )
+        THROW_IO_ERROR( _( "Maximum line length exceeded" ) );
+
+    m_length = end - m_ndx;
+
+    if( m_nulTerminated || end == m_size )
+    {
+        // The final line is copied too, so every line handed out ends with a newline or a
+        // nul and a parser scanning for either cannot run past the end of the mapping
+        m_lineCopy.assign( m_data + m_ndx, m_length );
+        m_line = &m_lineCopy[0];
+    }
+    else
+    {
+        m_line = m_data + m_ndx;
+    }
+
+    m_ndx = end;
+
+    return m_line;
+}
+
+
+void MMAP_LINE_READER::Rewind()
+{
+    Seek( 0, 0 );
+}
+
+
+void MMAP_LINE_READER::Seek( size_t aOffset, unsigned aLineNumber )
+{
+    unsigned lineNum = aLineNumber > 0 ? aLineNumber - 1 : 0;   // ReadLine() increments it
+
+    m_length = 0;
+    m_lineCopy.clear();
+    m_line = &m_lineCopy[0];
+
+    if( m_fileReader )
+    {
+        openFileReader( aOffset, lineNum );
+        m_lineNum = lineNum;
+        return;
+    }
+
+    m_ndx = std::min( aOffset, m_size );
+    m_lineNum = lineNum;
+}
+
+
+STRING_LINE_READER::STRING_LINE_READER( const std::string& aString, const wxString& aSource,
+                                        unsigned aStartingLineNumber ):
     LINE_READER( LINE_READER_LINE_DEFAULT_MAX ),
     m_lines( aString ), m_ndx( 0 )
 {
     // Clipboard text should be nice and _use multiple lines_ so that
     // we can report _line number_ oriented error messages when parsing.
-    m_source = aSource;
+    m_source  = aSource;
+    m_lineNum = aStartingLineNumber;
 }
 
 
@@ -365,6 +590,18 @@ const char* OUTPUTFORMATTER::GetQuoteChar( const char* wrapee )
 
 int OUTPUTFORMATTER::vprint( const char* fmt,  va_list ap )
 {
+    // Most of the s-expression output is made of constant strings like ")\n", which don't
+    // need to go through vsnprintf
+    if( !strchr( fmt, '%' ) )
+    {
+        int len = strlen( fmt );
+
+        if( len > 0 )
+            write( fmt, len );
+
+        return len;
+    }
+
     // This function can call vsnprintf twice.
     // But internally, vsnprintf retrieves arguments from the va_list identified by arg as if
     // va_arg was used on it, and thus the state of the va_list is likely to be altered by the call.
@@ -405,23 +642,20 @@ int OUTPUTFORMATTER::Print( int nestLevel, const char* fmt, ... )
 {
 #define NESTWIDTH           2   ///< how many spaces per nestLevel
 
-    va_list     args;
+    static const char spaces[] = "                                ";
 
-    va_start( args, fmt );
+    int total = std::max( nestLevel, 0 ) * NESTWIDTH;
 
-    int result = 0;
-    int total  = 0;
+    // The indentation is written in blocks rather than one vsnprintf() per level
+    for( int remaining = total; remaining > 0; remaining -= sizeof( spaces ) - 1 )
+        write( spaces, std::min( remaining, (int) sizeof( spaces ) - 1 ) );
 
-    for( int i=0; i<nestLevel;  ++i )
-    {
-        // no error checking needed, an exception indicates an error.
-        result = sprint( "%*c", NESTWIDTH, ' ' );
+    va_list     args;
 
-        total += result;
-    }
+    va_start( args, fmt );
 
     // no error checking needed, an exception indicates an error.
-    result = vprint( fmt, args );
+    int result = vprint( fmt, args );
 
     va_end( args );
 
@@ -502,11 +736,58 @@ void STRING_FORMATTER::StripUseless()
     }
 }
 
+//-----<BUFFERED_OUTPUTFORMATTER>------------------------------------
+
+BUFFERED_OUTPUTFORMATTER::BUFFERED_OUTPUTFORMATTER( char aQuoteChar ) :
+    OUTPUTFORMATTER( OUTPUTFMTBUFZ, aQuoteChar ),
+    m_outBuffer( OUTPUTFMTBLOCKZ ),
+    m_outCount( 0 )
+{
+}
+
+
+void BUFFERED_OUTPUTFORMATTER::Finish()
+{
+    flushBuffer();
+}
+
+
+void BUFFERED_OUTPUTFORMATTER::flushBuffer()
+{
+    // Empty the buffer first, so a failed flush is not attempted again by the destructor
+    size_t count = m_outCount;
+
+    m_outCount = 0;
+
+    if( count )
+        flush( &m_outBuffer[0], count );
+}
+
+
+void BUFFERED_OUTPUTFORMATTER::write( const char* aOutBuf, int aCount )
+{
+    if( m_outCount + aCount > m_outBuffer.size() )
+    {
+        flushBuffer();
+
+        // No point in copying what fills the buffer on its own
+        if( (size_t) aCount >= m_outBuffer.size() )
+        {
+            flush( aOutBuf, aCount );
+            return;
+        }
+    }
+
+    memcpy( &m_outBuffer[m_outCount], aOutBuf, aCount );
+    m_outCount += aCount;
+}
+
+
 //-----<FILE_OUTPUTFORMATTER>----------------------------------------
 
 FILE_OUTPUTFORMATTER::FILE_OUTPUTFORMATTER( const wxString& aFileName, const wxChar* aMode,
                                             char aQuoteChar ):
-    OUTPUTFORMATTER( OUTPUTFMTBUFZ, aQuoteChar ),
+    BUFFERED_OUTPUTFORMATTER( aQuoteChar ),
     m_filename( aFileName )
 {
     m_fp = wxFopen( aFileName, aMode );
@@ -519,28 +800,67 @@ FILE_OUTPUTFORMATTER::FILE_OUTPUTFORMATTER( const wxString& aFileName, const wxC
 FILE_OUTPUTFORMATTER::~FILE_OUTPUTFORMATTER()
 {
     if( m_fp )
+    {
+        // Errors can't be reported from here, Finish() is there for that
+        try
+        {
+            flushBuffer();
+        }
+        catch( const IO_ERROR& )
+        {
+        }
+
         fclose( m_fp );
+    }
 }
 
 
-void FILE_OUTPUTFORMATTER::write( const char* aOutBuf, int aCount )
+void FILE_OUTPUTFORMATTER::Finish()
 {
-    if( fwrite( aOutBuf, (unsigned) aCount, 1, m_fp ) != 1 )
+    if( !m_fp )
+        return;
+
+    flushBuffer();
+
+    FILE* fp = m_fp;
+
+    m_fp = nullptr;
+
+    if( fclose( fp ) != 0 )
+        THROW_IO_ERROR( strerror( errno ) );
+}
+
+
+void FILE_OUTPUTFORMATTER::flush( const char* aOutBuf, size_t aCount )
+{
+    if( !m_fp || fwrite( aOutBuf, aCount, 1, m_fp ) != 1 )
         THROW_IO_ERROR( strerror( errno ) );
 }
 
 
 //-----<STREAM_OUTPUTFORMATTER>--------------------------------------
 
-void STREAM_OUTPUTFORMATTER::write( const char* aOutBuf, int aCount )
+STREAM_OUTPUTFORMATTER::~STREAM_OUTPUTFORMATTER()
+{
+    try
+    {
+        flushBuffer();
+    }
+    catch( const IO_ERROR& )
+    {
+    }
+}
+
+
+void STREAM_OUTPUTFORMATTER::flush( const char* aOutBuf, size_t aCount )
 {
-    int lastWrite;
+    size_t lastWrite;
 
     // This might delay awhile if you were writing to say a socket, but for
     // a file it should only go through the loop once.
-    for( int total = 0;  total<aCount;  total += lastWrite )
+    for( size_t total = 0;  total<aCount;  total += lastWrite )
     {
-        lastWrite = m_os.Write( aOutBuf, aCount ).LastWrite();
+        lastWrite = m_os.Write( aOutBuf + total, aCount - total ).LastWrite();
 
         if( !m_os.IsOk() )
         {
@@ -548,4 +868,3 @@ void STREAM_OUTPUTFORMATTER::write( const char* aOutBuf, int aCount )
         }
     }
 }
-
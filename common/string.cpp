@@ -31,6 +31,13 @@
 #include <richio.h>                        // StrPrintf
 #include <kicad_string.h>
 
+#include <clocale>
+#include <cstdint>
+
+#if defined( __APPLE__ )
+#include <xlocale.h>
+#endif
+
 
 /**
  * Illegal file name characters used to insure file names will be valid on all supported
@@ -724,3 +731,120 @@ bool ReplaceIllegalFileNameChars( wxString& aName, int aReplaceChar )
 
     return changed;
 }
+
+
+/**
+ * Convert the simple decimal numbers making most of our files, like "-12.7", exactly.
+ *
+ * A mantissa of up to 15 digits and a power of ten up to 22 are both exact doubles, so their
+ * quotient is correctly rounded, as strtod() would do.
+ *
+ * @return false when \a aText needs the full strtod() (exponent, hexadecimal, inf, too many
+ *         digits...).
+ */
+static bool strToSimpleDouble( const char* aText, double& aValue, const char*& aEnd )
+{
+    static const double powersOf10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const char* cp = aText;
+    bool        negative = false;
+    uint64_t    mantissa = 0;
+    int         significantDigits = 0;
+    int         fractionDigits = 0;
+    bool        hasDigits = false;
+
+    if( *cp == '-' || *cp == '+' )
+        negative = ( *cp++ == '-' );
+
+    for( bool fraction = false; ; ++cp )
+    {
+        if( *cp >= '0' && *cp <= '9' )
+        {
+            hasDigits = true;
+            mantissa = mantissa * 10 + ( *cp - '0' );
+
+            if( mantissa && ++significantDigits > 15 )
+                return false;
+
+            if( fraction && ++fractionDigits > 22 )
+                return false;
+        }
+        else if( *cp == '.' && !fraction )
+        {
+            fraction = true;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if( !hasDigits || *cp == 'e' || *cp == 'E' || *cp == 'x' || *cp == 'X' )
+        return false;
+
+    aValue = (double) mantissa / powersOf10[fractionDigits];
+
+    if( negative )
+        aValue = -aValue;
+
+    aEnd = cp;
+    return true;
+}
+
+
+double StrToDouble( const char* aText, char** aEndPtr )
+{
+    const char* start = aText;
+
+    while( isspace( (unsigned char) *start ) )
+        ++start;
+
+    double      value;
+    const char* end;
+
+    if( strToSimpleDouble( start, value, end ) )
+    {
+        if( aEndPtr )
+            *aEndPtr = const_cast<char*>( end );
+
+        return value;
+    }
+
+    // The "C" locale is created once, and never changed afterwards
+#if defined( _WIN32 )
+    static _locale_t cLocale = _create_locale( LC_NUMERIC, "C" );
+
+    return _strtod_l( aText, aEndPtr, cLocale );
+#else
+    static locale_t cLocale = newlocale( LC_NUMERIC_MASK, "C", (locale_t) 0 );
+
+    return strtod_l( aText, aEndPtr, cLocale );
+#endif
+}
+
+
+std::string FormatDouble( const char* aFormat, double aValue )
+{
+    std::string str = StrPrintf( aFormat, aValue );
+
+    // The decimal separator is the only part of a number printf() localizes.  It is found
+    // after the sign and the integer digits, and not followed by an exponent ("1e+20"), nan
+    // or inf.
+    size_t sepStart = str.find_first_not_of( " +-0123456789" );
+
+    if( sepStart != std::string::npos && str[sepStart] != '.'
+            && !strchr( "eEiInN", str[sepStart] ) )
+    {
+        size_t sepEnd = str.find_first_of( " 0123456789eE", sepStart );
+
+        if( sepEnd == std::string::npos )
+            sepEnd = str.size();
+
+        str.replace( sepStart, sepEnd - sepStart, "." );
+    }
+
+    return str;
+}
@@ -0,0 +1,282 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <thread_pool.h>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+
+#include <wx/thread.h>
+
+#include <widgets/progress_reporter.h>
+
+
+// The pool owning the calling thread, if it is a worker, and the index of its queue
+static thread_local const THREAD_POOL* s_workerPool = nullptr;
+static thread_local size_t             s_workerQueue = 0;
+
+
+THREAD_POOL::THREAD_POOL( size_t aThreadCount ) :
+        m_pendingCount( 0 ),
+        m_quit( false )
+{
+    if( aThreadCount == 0 )
+    {
+        size_t cores = std::thread::hardware_concurrency();
+        aThreadCount = cores > 1 ? cores - 1 : 0;
+    }
+
+    for( size_t ii = 0; ii <= aThreadCount; ++ii )
+        m_queues.emplace_back( new TASK_QUEUE );
+
+    for( size_t ii = 0; ii < aThreadCount; ++ii )
+        m_threads.emplace_back( &THREAD_POOL::workerLoop, this, ii );
+}
+
+
+THREAD_POOL::~THREAD_POOL()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_wakeMutex );
+        m_quit = true;
+    }
+
+    m_wakeCondition.notify_all();
+
+    for( std::thread& thread : m_threads )
+        thread.join();
+}
+
+
+THREAD_POOL& THREAD_POOL::GetInstance()
+{
+    static THREAD_POOL pool;
+
+    return pool;
+}
+
+
+size_t THREAD_POOL::ownQueue() const
+{
+    if( s_workerPool == this )
+        return s_workerQueue;
+
+    return m_threads.size();
+}
+
+
+void THREAD_POOL::push( TASK&& aTask )
+{
+    TASK_QUEUE& queue = *m_queues[ ownQueue() ];
+
+    {
+        // The count is raised before the task can be popped, so it never goes below zero
+        std::lock_guard<std::mutex> lock( queue.m_mutex );
+        m_pendingCount++;
+        queue.m_tasks.push_back( std::move( aTask ) );
+    }
+
+    {
+        // Taking the lock avoids missing a thread which is about to sleep
+        std::lock_guard<std::mutex> lock( m_wakeMutex );
+    }
+
+    m_wakeCondition.notify_one();
+}
+
+
+bool THREAD_POOL::pop( TASK& aTask )
+{
+    size_t own = ownQueue();
+
+    // Own tasks are run newest first: they are the most likely to be hot in the cache
+    {
+        TASK_QUEUE&                 queue = *m_queues[ own ];
+        std::lock_guard<std::mutex> lock( queue.m_mutex );
+
+        if( !queue.m_tasks.empty() )
+        {
+            aTask = std::move( queue.m_tasks.back() );
+            queue.m_tasks.pop_back();
+            m_pendingCount--;
+            return true;
+        }
+    }
+
+    // Steal the oldest task of another queue
+    for( size_t ii = 1; ii < m_queues.size(); ++ii )
+    {
+        TASK_QUEUE&                 queue = *m_queues[ ( own + ii ) % m_queues.size() ];
+        std::lock_guard<std::mutex> lock( queue.m_mutex );
+
+        if( !queue.m_tasks.empty() )
+        {
+            aTask = std::move( queue.m_tasks.front() );
+            queue.m_tasks.pop_front();
+            m_pendingCount--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+bool THREAD_POOL::runPendingTask()
+{
+    TASK task;
+
+    if( !pop( task ) )
+        return false;
+
+    task();
+    return true;
+}
+
+
+void THREAD_POOL::workerLoop( size_t aIndex )
+{
+    s_workerPool = this;
+    s_workerQueue = aIndex;
+
+    while( true )
+    {
+        if( runPendingTask() )
+            continue;
+
+        std::unique_lock<std::mutex> lock( m_wakeMutex );
+
+        m_wakeCondition.wait( lock, [&]() { return m_quit || m_pendingCount > 0; } );
+
+        if( m_quit )
+            return;
+    }
+}
+
+
+bool THREAD_POOL::ParallelFor( size_t aCount, const std::function<void( size_t )>& aTask,
+                               PROGRESS_REPORTER* aReporter, bool aCancellable )
+{
+    if( aCount == 0 )
+        return true;
+
+    // State shared by the runners of this loop.  It lives on the stack: the loop does not
+    // return before all its runners have completed.  runnersDone is guarded by m_wakeMutex,
+    // so that the waiting thread sleeps on m_wakeCondition along with the workers and is
+    // woken up by new tasks as well as by the end of the loop.
+    std::atomic<size_t>     nextIndex( 0 );
+    std::atomic<bool>       cancelled( false );
+    size_t                  runnersDone = 0;
+    std::exception_ptr      error;      // guarded by m_wakeMutex
+
+    // An exception must not leave a runner: a worker would terminate, and the calling thread
+    // would leave the loop while the other runners still use its state
+    auto runner = [&]()
+    {
+        try
+        {
+            for( size_t ii = nextIndex++; ii < aCount && !cancelled; ii = nextIndex++ )
+                aTask( ii );
+        }
+        catch( ... )
+        {
+            std::lock_guard<std::mutex> lock( m_wakeMutex );
+
+            if( !error )
+                error = std::current_exception();
+
+            cancelled = true;
+        }
+    };
+
+    // Only the main thread can refresh the progress reporter.  It then keeps the UI alive
+    // while the workers run the loop; any other thread runs its share of the iterations.
+    bool refreshUI = aReporter && wxThread::IsMain() && !m_threads.empty();
+
+    // One runner per thread, but no more than there are iterations
+    size_t runnerCount = std::min( refreshUI ? m_threads.size() : GetParallelism(), aCount );
+    size_t queuedCount = refreshUI ? runnerCount : runnerCount - 1;
+
+    for( size_t ii = 0; ii < queuedCount; ++ii )
+    {
+        push( [&]()
+              {
+                  runner();
+
+                  {
+                      std::lock_guard<std::mutex> lock( m_wakeMutex );
+                      runnersDone++;
+                  }
+
+                  // The loop may have returned already: only members are used from here
+                  m_wakeCondition.notify_all();
+              } );
+    }
+
+    if( !refreshUI )
+        runner();
+
+    while( true )
+    {
+        {
+            std::lock_guard<std::mutex> lock( m_wakeMutex );
+
+            if( runnersDone == queuedCount )
+                break;
+        }
+
+        if( refreshUI )
+        {
+            if( !aReporter->KeepRefreshing() && aCancellable )
+                cancelled = true;
+        }
+        else if( runPendingTask() )
+        {
+            // Helping with the pending tasks (ours, or nested ones) rather than sleeping
+            // is what keeps nested loops from deadlocking
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock( m_wakeMutex );
+
+        if( refreshUI )
+        {
+            m_wakeCondition.wait_for( lock, std::chrono::milliseconds( 100 ),
+                                      [&]() { return runnersDone == queuedCount; } );
+        }
+        else
+        {
+            m_wakeCondition.wait( lock, [&]()
+                                        {
+                                            return runnersDone == queuedCount
+                                                   || m_pendingCount > 0;
+                                        } );
+        }
+    }
+
+    if( error )
+        std::rethrow_exception( error );
+
+    return !cancelled;
+}
@@ -293,7 +293,8 @@ VIEW::VIEW( bool aIsDynamic ) :
     m_dynamic( aIsDynamic ),
     m_useDrawPriority( false ),
     m_nextDrawPriority( 0 ),
-    m_reverseDrawOrder( false )
+    m_reverseDrawOrder( false ),
+    m_bulkLoading( false )
 {
     // Set m_boundary to define the max area size. The default area size
     // is defined here as the max value of a int.
@@ -364,7 +365,12 @@ void VIEW::Add( VIEW_ITEM* aItem, int aDrawPriority )
     for( int i = 0; i < layers_count; ++i )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
-        l.items->Insert( aItem );
+
+        if( m_bulkLoading )
+            l.bulkItems.push_back( aItem );
+        else
+            l.items->Insert( aItem );
+
         MarkTargetDirty( l.target );
     }
 
@@ -401,6 +407,14 @@ void VIEW::Remove( VIEW_ITEM* aItem )
         l.items->Remove( aItem );
         MarkTargetDirty( l.target );
 
+        if( m_bulkLoading )
+        {
+            auto bulkItem = std::find( l.bulkItems.begin(), l.bulkItems.end(), aItem );
+
+            if( bulkItem != l.bulkItems.end() )
+                l.bulkItems.erase( bulkItem );
+        }
+
         // Clear the GAL cache
         int prevGroup = viewData->getGroup( layers[i] );
 
@@ -1114,7 +1128,10 @@ void VIEW::Clear()
     m_allItems->clear();
 
     for( LAYER_MAP_ITER i = m_layers.begin(); i != m_layers.end(); ++i )
+    {
         i->second.items->RemoveAll();
+        i->second.bulkItems.clear();
+    }
 
     m_nextDrawPriority = 0;
 
@@ -1122,6 +1139,30 @@ void VIEW::Clear()
 }
 
 
+void VIEW::BeginBulkLoad()
+{
+    m_bulkLoading = true;
+}
+
+
+void VIEW::EndBulkLoad()
+{
+    m_bulkLoading = false;
+
+    for( LAYER_MAP_ITER i = m_layers.begin(); i != m_layers.end(); ++i )
+    {
+        VIEW_LAYER& l = i->second;
+
+        if( l.bulkItems.empty() )
+            continue;
+
+        l.items->BulkLoad( l.bulkItems );
+        l.bulkItems.clear();
+        l.bulkItems.shrink_to_fit();
+    }
+}
+
+
 void VIEW::ClearTargets()
 {
     if( IsTargetDirty( TARGET_CACHED ) || IsTargetDirty( TARGET_NONCACHED ) )
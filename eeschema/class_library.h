@@ -38,6 +38,7 @@
 
 #include <project.h>
 
+#include <atomic>
 #include <map>
 
 class LIB_ID;
@@ -191,7 +192,7 @@ class PART_LIBS : public PART_LIBS_BASE, public PROJECT::_ELEM
 public:
     KICAD_T Type() override { return PART_LIBS_T; }
 
-    static int s_modify_generation;         ///< helper for GetModifyHash()
+    static std::atomic<int> s_modify_generation;    ///< helper for GetModifyHash()
 
     PART_LIBS()
     {
@@ -42,6 +42,7 @@ bool NETLIST_EXPORTER_KICAD::WriteNetlist( const wxString& aOutFileName, unsigne
     {
         FILE_OUTPUTFORMATTER formatter( aOutFileName );
         Format( &formatter, GNL_ALL );
+        formatter.Finish();
     }
 
     catch( const IO_ERROR& ioe )
@@ -61,7 +61,12 @@ bool NETLIST_EXPORTER_PSPICE::WriteNetlist( const wxString& aOutFileName, unsign
 {
     FILE_OUTPUTFORMATTER outputFile( aOutFileName, wxT( "wt" ), '\'' );
 
-    return Format( &outputFile, aNetlistOptions );
+    if( !Format( &outputFile, aNetlistOptions ) )
+        return false;
+
+    outputFile.Finish();
+
+    return true;
 }
 
 void  NETLIST_EXPORTER_PSPICE::ReplaceForbiddenChars( wxString &aNetName )
@@ -660,7 +660,8 @@ void LEGACY_RESCUER::OpenRescueLibrary()
 
         for( auto alias : aliases )
         {
-            LIB_PART* part = alias->GetPart();
+            // The enumerated symbols may not be complete, FindPart() loads all of the symbol.
+            LIB_PART* part = rescueLib->FindPart( alias->GetName() );
 
             wxCHECK2( part, continue );
 
@@ -298,7 +298,8 @@ public:
      * Populate a list of #LIB_PART aliases contained within the library \a aLibraryPath.
      *
      * @param aAliasList is an array to populate with the #LIB_ALIAS pointers associated with
-     *                   the library.
+     *                   the library.  The plugin may defer loading the draw items of the
+     *                   symbols, use LoadSymbol() to get a complete symbol.
      *
      * @param aLibraryPath is a locator for the "library", usually a directory, file,
      *                     or URL containing one or more #LIB_PART objects.
@@ -21,12 +21,22 @@
  */
 
 #include <cctype>
+#include <cstring>
 #include <algorithm>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
 #include <boost/algorithm/string/join.hpp>
 
+#include <wx/datstrm.h>
 #include <wx/mstream.h>
+#include <wx/filefn.h>
 #include <wx/filename.h>
+#include <wx/thread.h>
 #include <wx/tokenzr.h>
+#include <wx/wfstream.h>
+#include <common.h>
 #include <pgm_base.h>
 #include <gr_text.h>
 #include <kiway.h>
@@ -240,12 +250,12 @@ static double parseDouble( LINE_READER& aReader, const char* aLine,
     if( !*aLine )
         SCH_PARSE_ERROR( _( "unexpected end of line" ), aReader, aLine );
 
-    // Clear errno before calling strtod() in case some other crt call set it.
+    // Clear errno before calling StrToDouble() in case some other crt call set it.
     errno = 0;
 
-    double retv = strtod( aLine, (char**) aOutput );
+    double retv = StrToDouble( aLine, (char**) aOutput );
 
-    // Make sure no error occurred when calling strtod().
+    // Make sure no error occurred when calling StrToDouble().
     if( errno == ERANGE )
         SCH_PARSE_ERROR( "invalid floating point number", aReader, aLine );
 
@@ -468,7 +478,23 @@ static void parseQuotedString( wxString& aString, LINE_READER& aReader,
  */
 class SCH_LEGACY_PLUGIN_CACHE
 {
-    static int      m_modHash;      // Keep track of the modification status of the library.
+    /// Where to find the DRAW section of a part whose draw items are not loaded yet.
+    struct DEFERRED_DRAW
+    {
+        size_t          m_offset;       // Offset of the DRAW line in m_scannedFile.
+        unsigned        m_lineNumber;   // Line number of the DRAW line.
+    };
+
+    /// The extent of a DRAW section, as kept in the library index.
+    struct DRAW_SPAN
+    {
+        size_t          m_end;          // Offset of the ENDDRAW line.
+        unsigned        m_lineCount;    // Number of lines from DRAW to ENDDRAW.
+    };
+
+    typedef std::map<size_t, DRAW_SPAN> DRAW_SPANS;     // Keyed by the offset of the DRAW line.
+
+    static std::atomic<int> m_modHash;  // Keep track of the modification status of the library.
 
     wxString        m_fileName;     // Absolute path and file name.
     wxFileName      m_libFileName;  // Absolute path and file name is required here.
@@ -479,8 +505,22 @@ class SCH_LEGACY_PLUGIN_CACHE
     int             m_versionMajor;
     int             m_versionMinor;
     int             m_libType;      // Is this cache a component or symbol library.
-
-    void                  loadHeader( FILE_LINE_READER& aReader );
+    wxString        m_scannedFile;  // The file the m_deferredDraws offsets refer to.
+    wxString        m_indexPath;    // Folder of the library index, empty for the default one.
+
+    /// The parts whose draw items are read from m_scannedFile on first use.
+    std::map<LIB_PART*, DEFERRED_DRAW> m_deferredDraws;
+
+    void                  loadHeader( LINE_READER& aReader );
+    DEFERRED_DRAW         skipDrawEntries( MMAP_LINE_READER& aReader, const DRAW_SPANS& aIndex,
+                                           DRAW_SPANS& aSpans );
+    void                  loadDrawings( LIB_PART* aPart );
+    void                  loadAllDrawings();
+    wxString              indexFileName() const;
+    bool                  readIndex( long long aModTime, long long aSize,
+                                     DRAW_SPANS& aSpans ) const;
+    void                  writeIndex( long long aModTime, long long aSize,
+                                      const DRAW_SPANS& aSpans ) const;
     static void           loadAliases( std::unique_ptr<LIB_PART>& aPart, LINE_READER& aReader );
     static void           loadField( std::unique_ptr<LIB_PART>& aPart, LINE_READER& aReader );
     static void           loadDrawEntries( std::unique_ptr<LIB_PART>& aPart, LINE_READER& aReader,
@@ -546,13 +586,23 @@ public:
 
     void SetModified( bool aModified = true ) { m_isModified = aModified; }
 
+    /// Keep the library index in \a aPath, see SCH_LEGACY_PLUGIN::PropIndexPath.
+    void SetIndexPath( const wxString& aPath ) { m_indexPath = aPath; }
+
     wxString GetLogicalName() const { return m_libFileName.GetName(); }
 
     void SetFileName( const wxString& aFileName ) { m_libFileName = aFileName; }
 
     wxString GetFileName() const { return m_libFileName.GetFullPath(); }
 
-    static LIB_PART* LoadPart( LINE_READER& aReader, int aMajorVersion, int aMinorVersion );
+    /**
+     * Read one DEF/ENDDEF part entry.
+     *
+     * @param aSkipDrawEntries, if set, is called at the DRAW line instead of loading the draw
+     *                         items of the part, and must leave \a aReader on the ENDDRAW line.
+     */
+    static LIB_PART* LoadPart( LINE_READER& aReader, int aMajorVersion, int aMinorVersion,
+                               const std::function<void( LIB_PART* )>& aSkipDrawEntries = nullptr );
     static void      SaveSymbol( LIB_PART* aSymbol, OUTPUTFORMATTER& aFormatter );
 };
 
@@ -585,7 +635,6 @@ SCH_SHEET* SCH_LEGACY_PLUGIN::Load( const wxString& aFileName, KIWAY* aKiway,
 {
     wxASSERT( !aFileName || aKiway != NULL );
 
-    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
     SCH_SHEET*  sheet;
 
     wxFileName fn = aFileName;
@@ -1760,8 +1809,6 @@ void SCH_LEGACY_PLUGIN::Save( const wxString& aFileName, SCH_SCREEN* aScreen, KI
     wxCHECK_RET( aScreen != NULL, "NULL SCH_SCREEN object." );
     wxCHECK_RET( !aFileName.IsEmpty(), "No schematic file name defined." );
 
-    LOCALE_IO   toggle;     // toggles on, then off, the C locale, to write floating point values.
-
     init( aKiway, aProperties );
 
     wxFileName fn = aFileName;
@@ -1775,6 +1822,8 @@ void SCH_LEGACY_PLUGIN::Save( const wxString& aFileName, SCH_SCREEN* aScreen, KI
     m_out = &formatter;     // no ownership
 
     Format( aScreen );
+
+    formatter.Finish();
 }
 
 
@@ -2056,7 +2105,8 @@ void SCH_LEGACY_PLUGIN::saveBitmap( SCH_BITMAP* aBitmap )
 
     m_out->Print( 0, "$Bitmap\n" );
     m_out->Print( 0, "Pos %-4d %-4d\n", aBitmap->GetPosition().x, aBitmap->GetPosition().y );
-    m_out->Print( 0, "Scale %f\n", aBitmap->GetImage()->GetScale() );
+    m_out->Print( 0, "Scale %s\n",
+                  FormatDouble( "%f", aBitmap->GetImage()->GetScale() ).c_str() );
     m_out->Print( 0, "Data\n" );
 
     wxMemoryOutputStream stream;
@@ -2283,7 +2333,7 @@ void SCH_LEGACY_PLUGIN::saveBusAlias( std::shared_ptr<BUS_ALIAS> aAlias )
 }
 
 
-int SCH_LEGACY_PLUGIN_CACHE::m_modHash = 1;     // starts at 1 and goes up
+std::atomic<int> SCH_LEGACY_PLUGIN_CACHE::m_modHash( 1 );     // starts at 1 and goes up
 
 
 SCH_LEGACY_PLUGIN_CACHE::SCH_LEGACY_PLUGIN_CACHE( const wxString& aFullPathAndFileName ) :
@@ -2394,6 +2444,7 @@ LIB_ALIAS* SCH_LEGACY_PLUGIN_CACHE::removeAlias( LIB_ALIAS* aAlias )
 
     if( !alias )
     {
+        m_deferredDraws.erase( part );
         delete part;
 
         if( m_aliases.size() > 1 )
@@ -2448,6 +2499,11 @@ void SCH_LEGACY_PLUGIN_CACHE::Load()
                                             "Use the Manage Symbol Libraries dialog to fix the "
                                             "path (or remove the library)." ),
                                          m_libFileName.GetFullPath() );
+
+        // Libraries loaded in parallel leave the reporting to the caller.
+        if( !wxIsMainThread() )
+            THROW_IO_ERROR( msg );
+
         KIDIALOG dlg( Pgm().App().GetTopWindow(), msg, KIDIALOG::KD_ERROR );
         dlg.DoNotShowCheckbox( __FILE__, __LINE__ );
         dlg.ShowModal();
@@ -2461,7 +2517,31 @@ void SCH_LEGACY_PLUGIN_CACHE::Load()
     wxLogTrace( traceSchLegacyPlugin, "Loading legacy symbol file \"%s\"",
                 m_libFileName.GetFullPath() );
 
-    FILE_LINE_READER reader( m_libFileName.GetFullPath() );
+    // The draw items of the parts are only read when they are first needed, so the scan
+    // below only has to find where they are.  The index gives the extent of each DRAW
+    // section of an unmodified file, which spares reading them line by line.
+    wxString     fileName = m_libFileName.GetFullPath();
+    wxStructStat stat;
+    bool         useIndex = wxStat( fileName, &stat ) == 0;
+    DRAW_SPANS   index;
+    DRAW_SPANS   spans;
+
+    if( useIndex )
+        readIndex( stat.st_mtime, stat.st_size, index );
+
+    // The parsing functions scan the lines up to their nul
+    MMAP_LINE_READER reader( fileName, true );
+    DEFERRED_DRAW    draw;
+    bool             drawSkipped;
+
+    m_scannedFile = fileName;
+    m_deferredDraws.clear();
+
+    auto skipDraw = [&]( LIB_PART* )
+    {
+        draw = skipDrawEntries( reader, index, spans );
+        drawSkipped = true;
+    };
 
     if( !reader.ReadLine() )
         THROW_IO_ERROR( _( "unexpected end of file" ) );
@@ -2516,7 +2596,12 @@ void SCH_LEGACY_PLUGIN_CACHE::Load()
         if( strCompare( "DEF", line ) )
         {
             // Read one DEF/ENDDEF part entry from library:
-            LIB_PART * part = LoadPart( reader, m_versionMajor, m_versionMinor );
+            drawSkipped = false;
+
+            LIB_PART * part = LoadPart( reader, m_versionMajor, m_versionMinor, skipDraw );
+
+            if( drawSkipped )
+                m_deferredDraws[part] = draw;
 
             // Add aliases to cache
             for( size_t ii = 0; ii < part->GetAliasCount(); ++ii )
@@ -2569,11 +2654,232 @@ void SCH_LEGACY_PLUGIN_CACHE::Load()
     // reload the cache as needed.
     m_fileModTime = GetLibModificationTime();
 
+    if( useIndex && spans.size() != index.size() )
+        writeIndex( stat.st_mtime, stat.st_size, spans );
+
     if( USE_OLD_DOC_FILE_FORMAT( m_versionMajor, m_versionMinor ) )
         loadDocs();
 }
 
 
+SCH_LEGACY_PLUGIN_CACHE::DEFERRED_DRAW SCH_LEGACY_PLUGIN_CACHE::skipDrawEntries(
+        MMAP_LINE_READER& aReader, const DRAW_SPANS& aIndex, DRAW_SPANS& aSpans )
+{
+    size_t   begin = aReader.Tell() - aReader.Length();
+    unsigned lineNumber = aReader.LineNumber();
+
+    DRAW_SPANS::const_iterator it = aIndex.find( begin );
+
+    if( it != aIndex.end() )
+    {
+        aReader.Seek( it->second.m_end, lineNumber + it->second.m_lineCount - 1 );
+
+        if( aReader.ReadLine() && strCompare( "ENDDRAW", aReader.Line() ) )
+        {
+            aSpans[begin] = it->second;
+            return { begin, lineNumber };
+        }
+
+        // The index does not match the file after all, read the section.
+        aReader.Seek( begin, lineNumber );
+        aReader.ReadLine();
+    }
+
+    while( aReader.ReadLine() )
+    {
+        if( strCompare( "ENDDRAW", aReader.Line() ) )
+        {
+            aSpans[begin] = { aReader.Tell() - aReader.Length(),
+                              aReader.LineNumber() - lineNumber + 1 };
+            return { begin, lineNumber };
+        }
+    }
+
+    SCH_PARSE_ERROR( "file ended prematurely loading component draw element", aReader,
+                     aReader.Line() );
+}
+
+
+void SCH_LEGACY_PLUGIN_CACHE::loadDrawings( LIB_PART* aPart )
+{
+    auto it = m_deferredDraws.find( aPart );
+
+    if( it == m_deferredDraws.end() )
+        return;
+
+    DEFERRED_DRAW location = it->second;
+
+    // Forget it first, so a part which fails to load is not loaded twice.
+    m_deferredDraws.erase( it );
+
+    FILE* fp = wxFopen( m_scannedFile, wxT( "rb" ) );
+
+    if( !fp )
+        THROW_IO_ERROR( wxString::Format( _( "Unable to open filename \"%s\" for reading" ),
+                                          m_scannedFile ) );
+
+    FILE_LINE_READER reader( fp, m_scannedFile, true, location.m_lineNumber - 1 );
+
+    if( fseek( fp, (long) location.m_offset, SEEK_SET ) != 0 || !reader.ReadLine()
+            || !strCompare( "DRAW", reader.Line() ) )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "Library file \"%s\" changed while loading "
+                                             "symbol \"%s\"" ),
+                                          m_scannedFile, aPart->GetName() ) );
+    }
+
+    // loadDrawEntries() works on the parser's owning pointer, lend it the part.
+    std::unique_ptr<LIB_PART> part( aPart );
+
+    try
+    {
+        loadDrawEntries( part, reader, m_versionMajor, m_versionMinor );
+    }
+    catch( ... )
+    {
+        part.release();
+        throw;
+    }
+
+    part.release();
+}
+
+
+void SCH_LEGACY_PLUGIN_CACHE::loadAllDrawings()
+{
+    while( !m_deferredDraws.empty() )
+        loadDrawings( m_deferredDraws.begin()->first );
+}
+
+
+/// Bump this whenever the layout of the index file changes, older indexes are then rebuilt.
+#define SYMBOL_LIB_INDEX_VERSION    1
+
+/// First bytes of every symbol library index file.
+static const char symbolIndexMagic[] = { 'K', 'i', 'C', 'a', 'd', 'S', 'L', 'I' };
+
+
+wxString SCH_LEGACY_PLUGIN_CACHE::indexFileName() const
+{
+    // The library name keeps the folder readable, the hash of the full path makes it unique
+    size_t     hash = std::hash<std::string>{}( std::string( TO_UTF8( m_fileName ) ) );
+    wxFileName fn;
+
+    if( m_indexPath.IsEmpty() )
+    {
+        fn.AssignDir( GetKicadConfigPath() );
+        fn.AppendDir( wxT( "sym-index" ) );
+    }
+    else
+    {
+        fn.AssignDir( m_indexPath );
+    }
+
+    fn.SetName( wxString::Format( wxT( "%s-%016llx" ), m_libFileName.GetName(),
+                                  (unsigned long long) hash ) );
+    fn.SetExt( wxT( "idx" ) );
+
+    return fn.GetFullPath();
+}
+
+
+bool SCH_LEGACY_PLUGIN_CACHE::readIndex( long long aModTime, long long aSize,
+                                         DRAW_SPANS& aSpans ) const
+{
+    wxString indexFile = indexFileName();
+
+    if( !wxFileName::FileExists( indexFile ) )
+        return false;
+
+    wxFileInputStream file( indexFile );
+    char              magic[sizeof( symbolIndexMagic )];
+
+    if( !file.IsOk() || file.Read( magic, sizeof( magic ) ).LastRead() != sizeof( magic )
+            || memcmp( magic, symbolIndexMagic, sizeof( magic ) ) != 0 )
+    {
+        return false;
+    }
+
+    wxDataInputStream data( file );
+
+    // The index is only good for the very file it was made from
+    if( data.Read32() != SYMBOL_LIB_INDEX_VERSION || data.ReadString() != m_fileName
+            || (long long) data.Read64() != aModTime || (long long) data.Read64() != aSize )
+    {
+        return false;
+    }
+
+    wxUint32 count = data.Read32();
+
+    for( wxUint32 ii = 0; ii < count && file.GetLastError() == wxSTREAM_NO_ERROR; ++ii )
+    {
+        size_t    begin = data.Read64();
+        DRAW_SPAN span;
+
+        span.m_end = data.Read64();
+        span.m_lineCount = data.Read32();
+        aSpans[begin] = span;
+    }
+
+    // A truncated index is as good as no index
+    if( file.GetLastError() != wxSTREAM_NO_ERROR )
+    {
+        aSpans.clear();
+        return false;
+    }
+
+    return true;
+}
+
+
+void SCH_LEGACY_PLUGIN_CACHE::writeIndex( long long aModTime, long long aSize,
+                                          const DRAW_SPANS& aSpans ) const
+{
+    wxFileName fn( indexFileName() );
+
+    if( !fn.DirExists() && !wxFileName::Mkdir( fn.GetPath(), wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL ) )
+        return;
+
+    // Write a temporary file first, so a concurrent reader never sees a partial index.  Its
+    // name is unique, as other instances may be writing the index of the same library.
+    wxString tempFile = wxFileName::CreateTempFileName( fn.GetFullPath() );
+
+    if( tempFile.IsEmpty() )
+        return;
+
+    {
+        wxFileOutputStream file( tempFile );
+
+        if( !file.IsOk() )
+            return;
+
+        wxDataOutputStream data( file );
+
+        file.Write( symbolIndexMagic, sizeof( symbolIndexMagic ) );
+        data.Write32( SYMBOL_LIB_INDEX_VERSION );
+        data.WriteString( m_fileName );
+        data.Write64( (wxUint64) aModTime );
+        data.Write64( (wxUint64) aSize );
+        data.Write32( aSpans.size() );
+
+        for( const std::pair<const size_t, DRAW_SPAN>& span : aSpans )
+        {
+            data.Write64( (wxUint64) span.first );
+            data.Write64( (wxUint64) span.second.m_end );
+            data.Write32( span.second.m_lineCount );
+        }
+
+        if( !file.Close() )
+        {
+            wxRemoveFile( tempFile );
+            return;
+        }
+    }
+
+    wxRenameFile( tempFile, fn.GetFullPath(), true );
+}
+
+
 void SCH_LEGACY_PLUGIN_CACHE::loadDocs()
 {
     const char* line;
@@ -2675,7 +2981,7 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDocs()
 }
 
 
-void SCH_LEGACY_PLUGIN_CACHE::loadHeader( FILE_LINE_READER& aReader )
+void SCH_LEGACY_PLUGIN_CACHE::loadHeader( LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
@@ -2697,8 +3003,9 @@ void SCH_LEGACY_PLUGIN_CACHE::loadHeader( FILE_LINE_READER& aReader )
 }
 
 
-LIB_PART* SCH_LEGACY_PLUGIN_CACHE::LoadPart( LINE_READER& aReader, int aMajorVersion,
-                                             int aMinorVersion )
+LIB_PART* SCH_LEGACY_PLUGIN_CACHE::LoadPart(
+        LINE_READER& aReader, int aMajorVersion, int aMinorVersion,
+        const std::function<void( LIB_PART* )>& aSkipDrawEntries )
 {
     const char* line = aReader.Line();
 
@@ -2859,7 +3166,12 @@ LIB_PART* SCH_LEGACY_PLUGIN_CACHE::LoadPart( LINE_READER& aReader, int aMajorVer
         else if( *line == 'F' )                          // Fields
             loadField( part, aReader );
         else if( strCompare( "DRAW", line, &line ) )     // Drawing objects.
-            loadDrawEntries( part, aReader, aMajorVersion, aMinorVersion );
+        {
+            if( aSkipDrawEntries )
+                aSkipDrawEntries( part.get() );
+            else
+                loadDrawEntries( part, aReader, aMajorVersion, aMinorVersion );
+        }
         else if( strCompare( "$FPLIST", line, &line ) )  // Footprint filter list
             loadFootprintFilters( part, aReader );
         else if( strCompare( "ENDDEF", line, &line ) )   // End of part description
@@ -3633,6 +3945,9 @@ void SCH_LEGACY_PLUGIN_CACHE::Save( bool aSaveDocFile )
     if( !m_isModified )
         return;
 
+    // Everything must be read before the library file gets overwritten.
+    loadAllDrawings();
+
     // Write through symlinks, don't replace them
     wxFileName fn = GetRealFile();
 
@@ -3649,6 +3964,7 @@ void SCH_LEGACY_PLUGIN_CACHE::Save( bool aSaveDocFile )
     }
 
     formatter->Print( 0, "#\n#End Library\n" );
+    formatter->Finish();
     formatter.reset();
 
     m_fileModTime = fn.GetModificationTime();
@@ -4086,7 +4402,8 @@ void SCH_LEGACY_PLUGIN_CACHE::saveText( LIB_TEXT* aText,
         text = wxT( "\"" ) + text + wxT( "\"" );
     }
 
-    aFormatter.Print( 0, "T %g %d %d %d %d %d %d %s", aText->GetTextAngle(),
+    aFormatter.Print( 0, "T %s %d %d %d %d %d %d %s",
+                      FormatDouble( "%g", aText->GetTextAngle() ).c_str(),
                       aText->GetTextPos().x, aText->GetTextPos().y,
                       aText->GetTextWidth(), !aText->IsVisible(),
                       aText->GetUnit(), aText->GetConvert(), TO_UTF8( text ) );
@@ -4144,6 +4461,7 @@ void SCH_LEGACY_PLUGIN_CACHE::saveDocFile()
     }
 
     formatter.Print( 0, "#\n#End Doc Library\n" );
+    formatter.Finish();
 }
 
 
@@ -4162,6 +4480,7 @@ void SCH_LEGACY_PLUGIN_CACHE::DeleteAlias( const wxString& aAliasName )
 
     if( !alias )
     {
+        m_deferredDraws.erase( part );
         delete part;
 
         if( m_aliases.size() > 1 )
@@ -4209,6 +4528,11 @@ void SCH_LEGACY_PLUGIN::cacheLib( const wxString& aLibraryFileName )
         delete m_cache;
         m_cache = new SCH_LEGACY_PLUGIN_CACHE( aLibraryFileName );
 
+        UTF8 indexPath;
+
+        if( m_props && m_props->Value( PropIndexPath, &indexPath ) )
+            m_cache->SetIndexPath( indexPath );
+
         // Because m_cache is rebuilt, increment PART_LIBS::s_modify_generation
         // to modify the hash value that indicate component to symbol links
         // must be updated.
@@ -4250,8 +4574,6 @@ int SCH_LEGACY_PLUGIN::GetModifyHash() const
 size_t SCH_LEGACY_PLUGIN::GetSymbolLibCount( const wxString&   aLibraryPath,
                                              const PROPERTIES* aProperties )
 {
-    LOCALE_IO toggle;
-
     m_props = aProperties;
 
     cacheLib( aLibraryPath );
@@ -4264,8 +4586,6 @@ void SCH_LEGACY_PLUGIN::EnumerateSymbolLib( wxArrayString&    aAliasNameList,
                                             const wxString&   aLibraryPath,
                                             const PROPERTIES* aProperties )
 {
-    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
-
     m_props = aProperties;
 
     bool powerSymbolsOnly = ( aProperties &&
@@ -4286,8 +4606,6 @@ void SCH_LEGACY_PLUGIN::EnumerateSymbolLib( std::vector<LIB_ALIAS*>& aAliasList,
                                             const wxString&   aLibraryPath,
                                             const PROPERTIES* aProperties )
 {
-    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
-
     m_props = aProperties;
 
     bool powerSymbolsOnly = ( aProperties &&
@@ -4307,8 +4625,6 @@ void SCH_LEGACY_PLUGIN::EnumerateSymbolLib( std::vector<LIB_ALIAS*>& aAliasList,
 LIB_ALIAS* SCH_LEGACY_PLUGIN::LoadSymbol( const wxString& aLibraryPath, const wxString& aAliasName,
                                           const PROPERTIES* aProperties )
 {
-    LOCALE_IO toggle;     // toggles on, then off, the C locale.
-
     m_props = aProperties;
 
     cacheLib( aLibraryPath );
@@ -4318,6 +4634,8 @@ LIB_ALIAS* SCH_LEGACY_PLUGIN::LoadSymbol( const wxString& aLibraryPath, const wx
     if( it == m_cache->m_aliases.end() )
         return NULL;
 
+    m_cache->loadDrawings( it->second->GetPart() );
+
     return it->second;
 }
 
@@ -4374,8 +4692,6 @@ void SCH_LEGACY_PLUGIN::CreateSymbolLib( const wxString& aLibraryPath,
             aLibraryPath.GetData() ) );
     }
 
-    LOCALE_IO toggle;
-
     m_props = aProperties;
 
     delete m_cache;
@@ -4468,3 +4784,4 @@ void SCH_LEGACY_PLUGIN::FormatPart( LIB_PART* part, OUTPUTFORMATTER & formatter
 
 const char* SCH_LEGACY_PLUGIN::PropBuffering = "buffering";
 const char* SCH_LEGACY_PLUGIN::PropNoDocFile = "no_doc_file";
+const char* SCH_LEGACY_PLUGIN::PropIndexPath = "index_path";
@@ -95,6 +95,14 @@ public:
      */
     static const char* PropNoDocFile;
 
+    /**
+     * const char* PropIndexPath
+     *
+     * is a property giving the folder where the symbol library indexes are kept, instead of
+     * the sym-index folder of the user configuration path.
+     */
+    static const char* PropIndexPath;
+
     int GetModifyHash() const override;
 
     SCH_SHEET* Load( const wxString& aFileName, KIWAY* aKiway,
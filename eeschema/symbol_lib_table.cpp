@@ -315,7 +315,14 @@ SYMBOL_LIB_TABLE_ROW* SYMBOL_LIB_TABLE::FindRow( const wxString& aNickname )
 void SYMBOL_LIB_TABLE::LoadSymbolLib( std::vector<LIB_ALIAS*>& aAliasList,
                                       const wxString& aNickname, bool aPowerSymbolsOnly )
 {
-    SYMBOL_LIB_TABLE_ROW* row = FindRow( aNickname );
+    LoadSymbolLib( aAliasList, FindRow( aNickname ), aPowerSymbolsOnly );
+}
+
+
+void SYMBOL_LIB_TABLE::LoadSymbolLib( std::vector<LIB_ALIAS*>& aAliasList,
+                                      SYMBOL_LIB_TABLE_ROW* aRow, bool aPowerSymbolsOnly )
+{
+    SYMBOL_LIB_TABLE_ROW* row = aRow;
     wxCHECK( row && row->plugin, /* void */  );
 
     wxString options = row->GetOptions();
@@ -165,6 +165,17 @@ public:
     void LoadSymbolLib( std::vector<LIB_ALIAS*>& aAliasList, const wxString& aNickname,
                         bool aPowerSymbolsOnly = false );
 
+    /**
+     * Load the symbols of the library of \a aRow, a row found beforehand with FindRow().
+     *
+     * The table itself is not looked up, so the libraries of several rows can be loaded from
+     * several threads at once.
+     *
+     * @throw IO_ERROR if the library cannot be loaded.
+     */
+    void LoadSymbolLib( std::vector<LIB_ALIAS*>& aAliasList, SYMBOL_LIB_TABLE_ROW* aRow,
+                        bool aPowerSymbolsOnly = false );
+
     /**
      * Load a #LIB_ALIAS having @a aAliasName from the library given by @a aNickname.
      *
@@ -20,9 +20,10 @@
  */
 
 #include <wx/tokenzr.h>
-#include <wx/progdlg.h>
 
 #include <eda_pattern_match.h>
+#include <thread_pool.h>
+#include <widgets/progress_reporter.h>
 #include <symbol_lib_table.h>
 #include <class_libentry.h>
 #include <generate_alias_info.h>
@@ -32,8 +33,6 @@
 
 bool SYMBOL_TREE_MODEL_ADAPTER::m_show_progress = true;
 
-#define PROGRESS_INTERVAL_MILLIS 66
-
 
 SYMBOL_TREE_MODEL_ADAPTER::PTR SYMBOL_TREE_MODEL_ADAPTER::Create( LIB_TABLE* aLibs )
 {
@@ -53,36 +52,93 @@ SYMBOL_TREE_MODEL_ADAPTER::~SYMBOL_TREE_MODEL_ADAPTER()
 void SYMBOL_TREE_MODEL_ADAPTER::AddLibraries( const std::vector<wxString>& aNicknames,
                                               wxWindow* aParent )
 {
-    wxProgressDialog* prg = nullptr;
-    wxLongLong        nextUpdate = wxGetUTCTimeMillis() + (PROGRESS_INTERVAL_MILLIS / 2);
+    std::unique_ptr<WX_PROGRESS_REPORTER> reporter;
 
     if( m_show_progress )
     {
-        prg = new wxProgressDialog( _( "Loading Symbol Libraries" ), wxEmptyString,
-                                    aNicknames.size(), aParent );
+        reporter.reset( new WX_PROGRESS_REPORTER( aParent, _( "Loading Symbol Libraries" ), 1,
+                                                  false ) );
+        reporter->SetMaxProgress( aNicknames.size() );
     }
 
-    unsigned int ii = 0;
+    bool                                 onlyPowerSymbols = ( GetFilter() == CMP_FILTER_POWER );
+    std::vector<std::vector<LIB_ALIAS*>> aliases( aNicknames.size() );
+    std::vector<wxString>                errors( aNicknames.size() );
+    std::vector<SYMBOL_LIB_TABLE_ROW*>   rows( aNicknames.size(), nullptr );
+
+    // Finding the rows indexes the table and instantiates their plugins, which is not thread
+    // safe.  The workers only use the rows found here: the libraries themselves are independent
+    // of each other and are loaded in parallel.
+    for( size_t ii = 0; ii < aNicknames.size(); ++ii )
+    {
+        try
+        {
+            rows[ii] = m_libs->FindRow( aNicknames[ii] );
+
+            if( !rows[ii] || !rows[ii]->plugin )
+                errors[ii] = _( "Library not found in the symbol library table." );
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            errors[ii] = ioe.What();
+        }
+    }
+
+    auto load_lambda = [&]( size_t aIndex )
+    {
+        if( errors[aIndex].IsEmpty() )
+        {
+            if( reporter )
+                reporter->Report( wxString::Format( _( "Loading library \"%s\"" ),
+                                                    aNicknames[aIndex] ) );
+
+            try
+            {
+                m_libs->LoadSymbolLib( aliases[aIndex], rows[aIndex], onlyPowerSymbols );
+            }
+            catch( const IO_ERROR& ioe )
+            {
+                aliases[aIndex].clear();
+                errors[aIndex] = ioe.What();
+            }
+        }
+
+        if( reporter )
+            reporter->AdvanceProgress();
+    };
 
-    for( const auto& nickname : aNicknames )
+    THREAD_POOL::GetInstance().ParallelFor( aNicknames.size(), load_lambda, reporter.get(),
+                                            false );
+
+    // The tree is filled in the order of the table, whichever library was loaded first.
+    wxString errorText;
+
+    for( size_t ii = 0; ii < aNicknames.size(); ++ii )
     {
-        if( prg && wxGetUTCTimeMillis() > nextUpdate )
+        if( !errors[ii].IsEmpty() )
         {
-            prg->Update( ii, wxString::Format( _( "Loading library \"%s\"" ), nickname ) );
-            nextUpdate = wxGetUTCTimeMillis() + PROGRESS_INTERVAL_MILLIS;
+            if( !errorText.IsEmpty() )
+                errorText += wxT( "\n\n" );
+
+            errorText += wxString::Format( _( "Error loading symbol library %s.\n\n%s" ),
+                                           aNicknames[ii], errors[ii] );
         }
+        else if( aliases[ii].size() > 0 )
+        {
+            std::vector<LIB_TREE_ITEM*> comp_list( aliases[ii].begin(), aliases[ii].end() );
 
-        AddLibrary( nickname );
-        ii++;
+            DoAddLibrary( aNicknames[ii], m_libs->GetDescription( aNicknames[ii] ), comp_list,
+                          false );
+        }
     }
 
+    if( !errorText.IsEmpty() )
+        wxLogError( errorText );
+
     m_tree.AssignIntrinsicRanks();
 
-    if( prg )
-    {
-        prg->Destroy();
+    if( reporter )
         m_show_progress = false;
-    }
 }
 
 
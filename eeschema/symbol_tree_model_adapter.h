@@ -44,7 +44,9 @@ public:
 
     /**
      * Add all the libraries in a SYMBOL_LIB_TABLE to the model.
-     * Displays a progress dialog attached to the parent frame the first time it is run.
+     * The libraries are loaded in parallel, and the errors are reported together once they
+     * are all loaded.  Displays a progress dialog attached to the parent frame the first
+     * time it is run.
      *
      * @param aNicknames is the list of library nicknames
      * @param aParent is the parent window to display the progress dialog
@@ -180,6 +180,13 @@ public:
     BOARD_ITEM* GetMainItem( BOARD* aBoard ) const;
     BOARD_ITEM* GetAuxiliaryItem( BOARD* aBoard ) const;
 
+    /**
+     * Access to the weak references of A and B items, to match them against known items
+     * without searching the whole BOARD
+     */
+    const void* GetMainItemWeakRef() const { return m_mainItemWeakRef; }
+    const void* GetAuxiliaryItemWeakRef() const { return m_auxItemWeakRef; }
+
     /**
      * Function ShowHtml
      * translates this object into a fragment of HTML suitable for the
@@ -42,6 +42,17 @@ struct KEYWORD
     const char* name;       ///< unique keyword.
     int         token;      ///< a zero based index into an array of KEYWORDs
 };
+
+/**
+ * Function pointer type KEYWORD_LOOKUP
+ * finds the token of a keyword, without building a hashtable of the keywords.  Such
+ * functions are generated along with the keyword tables by TokenList2DsnLexer.cmake.
+ *
+ * @param aToken is the text to look up, not necessarily nul terminated.
+ * @param aLength is the length of @a aToken.
+ * @return the token of the keyword, or DSN_SYMBOL if @a aToken is not a keyword.
+ */
+typedef int (*KEYWORD_LOOKUP)( const char* aToken, size_t aLength );
 #endif
 
 // something like this macro can be used to help initialize a KEYWORD table.
@@ -107,9 +118,11 @@ protected:
 
     int                 curTok;                 ///< the current token obtained on last NextTok()
     std::string         curText;                ///< the text of the current token
+    std::string         curLine;                ///< nul terminated copy of the current line
 
     const KEYWORD*      keywords;               ///< table sorted by CMake for bsearch()
     unsigned            keywordCount;           ///< count of keywords table
+    KEYWORD_LOOKUP      keywordLookup;          ///< generated lookup, used instead of keyword_hash
     KEYWORD_MAP         keyword_hash;           ///< fast, specialized "C string" hashtable
 
     void init();
@@ -169,9 +182,10 @@ public:
      * @param aKeywordCount is the count of tokens in aKeywordTable.
      * @param aFile is an open file, which will be closed when this is destructed.
      * @param aFileName is the name of the file
+     * @param aKeywordLookup is an optional function finding the keywords of aKeywordTable.
      */
     DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
-              FILE* aFile, const wxString& aFileName );
+              FILE* aFile, const wxString& aFileName, KEYWORD_LOOKUP aKeywordLookup = NULL );
 
     /**
      * Constructor ( const KEYWORD*, unsigned, const std::string&, const wxString& )
@@ -182,9 +196,11 @@ public:
      * @param aKeywordCount is the count of tokens in aKeywordTable.
      * @param aSExpression is text to feed through a STRING_LINE_READER
      * @param aSource is a description of aSExpression, used for error reporting.
+     * @param aKeywordLookup is an optional function finding the keywords of aKeywordTable.
      */
     DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
-              const std::string& aSExpression, const wxString& aSource = wxEmptyString );
+              const std::string& aSExpression, const wxString& aSource = wxEmptyString,
+              KEYWORD_LOOKUP aKeywordLookup = NULL );
 
     /**
      * Constructor ( const std::string&, const wxString& )
@@ -209,9 +225,11 @@ public:
      *
      * @param aLineReader is any subclassed instance of LINE_READER, such as
      *  STRING_LINE_READER or FILE_LINE_READER.  No ownership is taken.
+     *
+     * @param aKeywordLookup is an optional function finding the keywords of aKeywordTable.
      */
     DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
-              LINE_READER* aLineReader = NULL );
+              LINE_READER* aLineReader = NULL, KEYWORD_LOOKUP aKeywordLookup = NULL );
 
     virtual ~DSNLEXER();
 
@@ -389,6 +407,21 @@ public:
      */
     wxArrayString* ReadCommentLines();
 
+    /**
+     * Function ReadUnparsedList
+     * reads the rest of the list whose opening paren and first keyword were just read,
+     * without tokenizing it, so that it can be parsed later, possibly by another lexer.
+     * Upon return, CurTok() is the closing DSN_RIGHT of the list.
+     *
+     * The text starts with the opening paren and the keyword, padded with spaces to keep
+     * the keyword column, and keeps the lines of the list.  So a lexer reading it from a
+     * STRING_LINE_READER starting at the keyword line reports the same error locations.
+     *
+     * @return std::string - the text of the list.
+     * @throw IO_ERROR if the end of the input is reached before the end of the list.
+     */
+    std::string ReadUnparsedList();
+
     /**
      * Function IsSymbol
      * tests a token to see if it is a symbol.  This means it cannot be a
@@ -516,7 +549,13 @@ public:
      */
     const char* CurLine()
     {
-        return (const char*)(*reader);
+        // The lines of some readers are not nul terminated, see MMAP_LINE_READER
+        if( reader->Line() )
+            curLine.assign( reader->Line(), reader->Length() );
+        else
+            curLine.clear();
+
+        return curLine.c_str();
     }
 
     /**
@@ -32,6 +32,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <vector>
 
 #define ASSERT assert    // RTree uses ASSERT( condition )
 
@@ -48,7 +49,15 @@
 #define RTREE_SEARCH_QUAL       RTree<DATATYPE, ELEMTYPE, NUMDIMS, ELEMTYPEREAL, TMAXNODES, \
     TMINNODES, VISITOR>
 
-#define RTREE_DONT_USE_MEMPOOLS     // This version does not contain a fixed memory allocator, fill in lines with EXAMPLE to implement one.
+// Nodes are allocated from a per-tree pool of node blocks, released all at once when the tree
+// is cleared.  Define RTREE_DONT_USE_MEMPOOLS to allocate and free each node separately by
+// default; each tree can also choose when it is constructed.
+//#define RTREE_DONT_USE_MEMPOOLS
+#ifdef RTREE_DONT_USE_MEMPOOLS
+#define RTREE_USE_MEMPOOLS_DEFAULT false
+#else
+#define RTREE_USE_MEMPOOLS_DEFAULT true
+#endif
 #define RTREE_USE_SPHERICAL_VOLUME  // Better split classification, may be slower on some systems
 
 // Fwd decl
@@ -96,11 +105,23 @@ public:
         int totalItems;
     };
 
+    /// An entry of a bulk load
+    struct BulkItem
+    {
+        ELEMTYPE    m_min[NUMDIMS];                 ///< Min of bounding rect
+        ELEMTYPE    m_max[NUMDIMS];                 ///< Max of bounding rect
+        DATATYPE    m_data;                         ///< Data Id or Ptr
+    };
+
 public:
 
-    RTree();
+    /// \param a_useMemPool Allocate the nodes from a pool owned by the tree rather than one by one
+    RTree( bool a_useMemPool = RTREE_USE_MEMPOOLS_DEFAULT );
     virtual ~RTree();
 
+    /// Whether the nodes come from the pool of the tree
+    bool UsesMemPool() const { return m_useMemPool; }
+
     /// Insert entry
     /// \param a_min Min of bounding rect
     /// \param a_max Max of bounding rect
@@ -118,6 +139,13 @@ public:
                  const ELEMTYPE     a_max[NUMDIMS],
                  const DATATYPE&    a_dataId );
 
+    /// Rebuild the tree with the given entries in addition to the existing ones, as a packed
+    /// tree (Sort-Tile-Recursive): nodes are full, barely overlap and lie contiguously in
+    /// memory, so searches are faster than after inserting the entries one by one.  Inserts
+    /// and removals are still allowed afterwards.
+    /// \param a_items Entries to add
+    void BulkLoad( const std::vector<BulkItem>& a_items );
+
     /// Find all within search rectangle
     /// \param a_min Min of search bounding rect
     /// \param a_max Max of search bounding rect
@@ -508,6 +536,8 @@ protected:
     }
 
     void    RemoveAllRec( Node* a_node );
+    void    CollectLeavesRec( Node* a_node, std::vector<Branch>& a_branches );
+    void    SortTileRec( Branch* a_branches, size_t a_count, int a_dim );
     void    Reset();
     void    CountRec( Node* a_node, int& a_count );
 
@@ -516,6 +546,16 @@ protected:
 
     Node*           m_root;                         ///< Root of tree
     ELEMTYPEREAL    m_unitSphereVolume;             ///< Unit sphere constant for required number of dimensions
+    bool            m_useMemPool;                   ///< Nodes come from the blocks below
+
+    /// Size of the n-th block of the node pool: blocks grow geometrically, so that the many
+    /// small trees (e.g. the view layers) stay small while big ones use few allocations
+    static size_t   PoolBlockSize( size_t a_index ) { return a_index < 8 ? 4 << a_index : 1024; }
+
+    std::vector<Node*> m_nodeBlocks;                ///< Node pool blocks
+    size_t          m_nodeBlockSize;                ///< Size of the last block
+    size_t          m_nodeBlockUsed;                ///< Nodes handed out from the last block
+    Node*           m_freeNodes;                    ///< Freed nodes, chained by their first branch
 };
 
 
@@ -600,7 +640,8 @@ public:
 };
 
 
-RTREE_TEMPLATE RTREE_QUAL::RTree()
+RTREE_TEMPLATE RTREE_QUAL::RTree( bool a_useMemPool ) :
+    m_useMemPool( a_useMemPool )
 {
     ASSERT( MAXNODES > MINNODES );
     ASSERT( MINNODES > 0 );
@@ -622,6 +663,10 @@ RTREE_TEMPLATE RTREE_QUAL::RTree()
         0.082146f, 0.046622f, 0.025807f,    // Dimension  18,19,20
     };
 
+    m_nodeBlockSize = 0;
+    m_nodeBlockUsed = 0;
+    m_freeNodes     = nullptr;
+
     m_root = AllocNode();
     m_root->m_level     = 0;
     m_unitSphereVolume  = (ELEMTYPEREAL) UNIT_SPHERE_VOLUMES[NUMDIMS];
@@ -982,6 +1027,147 @@ bool RTREE_QUAL::SaveRec( Node* a_node, RTFileStream& a_stream )
 }
 
 
+RTREE_TEMPLATE
+void RTREE_QUAL::BulkLoad( const std::vector<BulkItem>& a_items )
+{
+    std::vector<Branch> branches;
+    branches.reserve( a_items.size() );
+
+    CollectLeavesRec( m_root, branches );
+
+    for( const BulkItem& item : a_items )
+    {
+        Branch branch;
+
+        for( int index = 0; index < NUMDIMS; ++index )
+        {
+            ASSERT( item.m_min[index] <= item.m_max[index] );
+            branch.m_rect.m_min[index] = item.m_min[index];
+            branch.m_rect.m_max[index] = item.m_max[index];
+        }
+
+        // Set like InsertRectRec() does, as removals compare the whole pointer
+        branch.m_child = (Node*) item.m_data;
+        branches.push_back( branch );
+    }
+
+    Reset();
+
+    if( m_useMemPool )
+    {
+        // Allocate all the nodes in one block, so that they are contiguous
+        size_t nodeCount = 0;
+
+        for( size_t count = branches.size(); nodeCount == 0 || count > 1; )
+        {
+            count = std::max<size_t>( ( count + MAXNODES - 1 ) / MAXNODES, 1 );
+            nodeCount += count;
+        }
+
+        m_nodeBlockSize = nodeCount;
+        m_nodeBlocks.push_back( new Node[ m_nodeBlockSize ] );
+        m_nodeBlockUsed = 0;
+    }
+
+    if( branches.empty() )
+    {
+        m_root = AllocNode();
+        m_root->m_level = 0;
+        return;
+    }
+
+    // Pack each level in nodes of neighbouring branches, then the covers of these nodes
+    // in the next level, up to the root
+    for( int level = 0; ; ++level )
+    {
+        SortTileRec( branches.data(), branches.size(), 0 );
+
+        std::vector<Branch> parents;
+        parents.reserve( ( branches.size() + MAXNODES - 1 ) / MAXNODES );
+
+        for( size_t first = 0; first < branches.size(); first += MAXNODES )
+        {
+            Node* node = AllocNode();
+            node->m_level = level;
+            node->m_count = (int) std::min<size_t>( MAXNODES, branches.size() - first );
+            std::copy( &branches[first], &branches[first] + node->m_count, node->m_branch );
+
+            Branch parent;
+            parent.m_rect = NodeCover( node );
+            parent.m_child = node;
+            parents.push_back( parent );
+        }
+
+        if( parents.size() == 1 )
+        {
+            m_root = parents[0].m_child;
+            return;
+        }
+
+        branches.swap( parents );
+    }
+}
+
+
+RTREE_TEMPLATE
+void RTREE_QUAL::CollectLeavesRec( Node* a_node, std::vector<Branch>& a_branches )
+{
+    if( a_node->IsInternalNode() )
+    {
+        for( int index = 0; index < a_node->m_count; ++index )
+            CollectLeavesRec( a_node->m_branch[index].m_child, a_branches );
+    }
+    else
+    {
+        a_branches.insert( a_branches.end(), a_node->m_branch,
+                           a_node->m_branch + a_node->m_count );
+    }
+}
+
+
+// Sort-Tile-Recursive ordering: the branches are sorted by their center along a_dim and cut
+// in slabs, whose branches are ordered the same way along the next dimensions.  Consecutive
+// runs of MAXNODES branches then make compact nodes.
+RTREE_TEMPLATE
+void RTREE_QUAL::SortTileRec( Branch* a_branches, size_t a_count, int a_dim )
+{
+    auto center = [a_dim]( const Branch& a_branch ) -> ELEMTYPEREAL
+    {
+        return (ELEMTYPEREAL) a_branch.m_rect.m_min[a_dim] + a_branch.m_rect.m_max[a_dim];
+    };
+
+    std::sort( a_branches, a_branches + a_count,
+               [&center]( const Branch& a, const Branch& b ) { return center( a ) < center( b ); } );
+
+    if( a_dim == NUMDIMS - 1 )
+        return;
+
+    size_t nodeCount = ( a_count + MAXNODES - 1 ) / MAXNODES;
+    size_t slabCount = (size_t) ceil( pow( (double) nodeCount, 1.0 / ( NUMDIMS - a_dim ) ) );
+    size_t distinctCount = 1;
+
+    for( size_t index = 1; index < a_count && distinctCount <= slabCount; ++index )
+    {
+        if( center( a_branches[index] ) != center( a_branches[index - 1] ) )
+            distinctCount++;
+    }
+
+    if( distinctCount <= slabCount )
+    {
+        // Few distinct positions (e.g. a layer dimension): slabs along this dimension would
+        // each span the whole extent of the others, so only tile the next dimensions
+        SortTileRec( a_branches, a_count, a_dim + 1 );
+    }
+    else
+    {
+        size_t slabSize = ( ( nodeCount + slabCount - 1 ) / slabCount ) * MAXNODES;
+
+        for( size_t first = 0; first < a_count; first += slabSize )
+            SortTileRec( a_branches + first, std::min( slabSize, a_count - first ), a_dim + 1 );
+    }
+}
+
+
 RTREE_TEMPLATE
 void RTREE_QUAL::RemoveAll()
 {
@@ -996,13 +1182,21 @@ void RTREE_QUAL::RemoveAll()
 RTREE_TEMPLATE
 void RTREE_QUAL::Reset()
 {
-#ifdef RTREE_DONT_USE_MEMPOOLS
-    // Delete all existing nodes
-    RemoveAllRec( m_root );
-#else    // RTREE_DONT_USE_MEMPOOLS
+    if( !m_useMemPool )
+    {
+        // Delete all existing nodes
+        RemoveAllRec( m_root );
+        return;
+    }
+
     // Just reset memory pools.  We are not using complex types
-    // EXAMPLE
-#endif    // RTREE_DONT_USE_MEMPOOLS
+    for( Node* block : m_nodeBlocks )
+        delete[] block;
+
+    m_nodeBlocks.clear();
+    m_nodeBlockSize = 0;
+    m_nodeBlockUsed = 0;
+    m_freeNodes = nullptr;
 }
 
 
@@ -1029,11 +1223,27 @@ typename RTREE_QUAL::Node* RTREE_QUAL::AllocNode()
 {
     Node* newNode;
 
-#ifdef RTREE_DONT_USE_MEMPOOLS
-    newNode = new Node;
-#else       // RTREE_DONT_USE_MEMPOOLS
-    // EXAMPLE
-#endif      // RTREE_DONT_USE_MEMPOOLS
+    if( !m_useMemPool )
+    {
+        newNode = new Node;
+    }
+    else if( m_freeNodes )
+    {
+        newNode = m_freeNodes;
+        m_freeNodes = newNode->m_branch[0].m_child;
+    }
+    else
+    {
+        if( m_nodeBlockUsed == m_nodeBlockSize )
+        {
+            m_nodeBlockSize = PoolBlockSize( m_nodeBlocks.size() );
+            m_nodeBlocks.push_back( new Node[ m_nodeBlockSize ] );
+            m_nodeBlockUsed = 0;
+        }
+
+        newNode = &m_nodeBlocks.back()[ m_nodeBlockUsed++ ];
+    }
+
     InitNode( newNode );
     return newNode;
 }
@@ -1044,35 +1254,30 @@ void RTREE_QUAL::FreeNode( Node* a_node )
 {
     ASSERT( a_node );
 
-#ifdef RTREE_DONT_USE_MEMPOOLS
-    delete a_node;
-#else       // RTREE_DONT_USE_MEMPOOLS
-    // EXAMPLE
-#endif      // RTREE_DONT_USE_MEMPOOLS
+    if( !m_useMemPool )
+    {
+        delete a_node;
+        return;
+    }
+
+    a_node->m_branch[0].m_child = m_freeNodes;
+    m_freeNodes = a_node;
 }
 
 
 // Allocate space for a node in the list used in DeletRect to
-// store Nodes that are too empty.
+// store Nodes that are too empty.  Only removals need them, so they are not pooled.
 RTREE_TEMPLATE
 typename RTREE_QUAL::ListNode* RTREE_QUAL::AllocListNode()
 {
-#ifdef RTREE_DONT_USE_MEMPOOLS
     return new ListNode;
-#else       // RTREE_DONT_USE_MEMPOOLS
-    // EXAMPLE
-#endif      // RTREE_DONT_USE_MEMPOOLS
 }
 
 
 RTREE_TEMPLATE
 void RTREE_QUAL::FreeListNode( ListNode* a_listNode )
 {
-#ifdef RTREE_DONT_USE_MEMPOOLS
     delete a_listNode;
-#else       // RTREE_DONT_USE_MEMPOOLS
-    // EXAMPLE
-#endif      // RTREE_DONT_USE_MEMPOOLS
 }
 
 
@@ -188,6 +188,26 @@ wxString GetIllegalFileNameWxChars();
 bool ReplaceIllegalFileNameChars( std::string* aName, int aReplaceChar = 0 );
 bool ReplaceIllegalFileNameChars( wxString& aName, int aReplaceChar = 0 );
 
+/**
+ * Convert the start of \a aText to a double like strtod(), but always with '.' as decimal
+ * separator whatever the current locale is.
+ *
+ * Unlike strtod() it does not need a LOCALE_IO, so it can be used from any thread.
+ *
+ * @param aText is the text to convert.  Leading white space is skipped.
+ * @param aEndPtr if not NULL, receives the position after the last character converted.
+ * @return the converted value.  errno is set to ERANGE when out of range, as by strtod().
+ */
+double StrToDouble( const char* aText, char** aEndPtr = NULL );
+
+/**
+ * Print \a aValue with the printf() style \a aFormat, which must have a single double
+ * conversion, but always with '.' as decimal separator whatever the current locale is.
+ *
+ * Unlike printf() it does not need a LOCALE_IO, so it can be used from any thread.
+ */
+std::string FormatDouble( const char* aFormat, double aValue );
+
 #ifndef HAVE_STRTOKR
 // common/strtok_r.c optionally:
 extern "C" char* strtok_r( char* str, const char* delim, char** nextp );
@@ -29,6 +29,7 @@
 // "richio" after its author, Richard Hollenbeck, aka Dick Hollenbeck.
 
 
+#include <memory>
 #include <vector>
 #include <utf8.h>
 
@@ -114,7 +115,8 @@ public:
      * Function ReadLine
      * reads a line of text into the buffer and increments the line number
      * counter.  If the line is larger than aMaxLineLength passed to the
-     * constructor, then an exception is thrown.  The line is nul terminated.
+     * constructor, then an exception is thrown.  The line is nul terminated, except
+     * with the readers which document otherwise.
      * @return char* - The beginning of the read line, or NULL if EOF.
      * @throw IO_ERROR when a line is too long.
      */
@@ -247,6 +249,92 @@ public:
 };
 
 
+/**
+ * Class MMAP_LINE_READER
+ * is a LINE_READER that maps a whole file in memory, read only, and hands out its lines in
+ * place, without copying them into a line buffer.
+ *
+ * Unlike the other readers, the lines are not nul terminated: Length() gives their size, and
+ * all of them but the last one end with their newline.  This suits the DSNLEXER, which reads
+ * no further than Length().  Readers made with @a aNulTerminated copy each line in a buffer
+ * and terminate it, for the parsers which look for the nul.
+ *
+ * The file size is checked again as the reading goes on.  If the file was changed meanwhile,
+ * the end of the mapping may not be backed by the file anymore, so the rest of the file is
+ * read with a FILE_LINE_READER.  The file is read in a buffer where it cannot be mapped.
+ */
+class MMAP_LINE_READER : public LINE_READER
+{
+protected:
+
+    char*       m_data;             ///< the file contents
+    size_t      m_size;             ///< no. bytes in m_data
+    bool        m_mapped;           ///< m_data is a mapping, else a heap buffer
+    bool        m_nulTerminated;    ///< the lines are copied in m_lineCopy
+    int         m_fd;               ///< the mapped file, kept open to check its size
+    size_t      m_ndx;              ///< offset of the next line in the file
+    size_t      m_nextSizeCheck;    ///< offset at which the file size is checked again
+    std::string m_lineCopy;         ///< the current line, when it is not handed out in place
+
+    ///> reads the file from the offset reached, once its size changed
+    std::unique_ptr<FILE_LINE_READER> m_fileReader;
+
+    /// Read the rest of the file with m_fileReader if its size is not the mapped size anymore
+    void checkFileSize();
+
+    /// Drop the mapping and read the file with m_fileReader, from @a aOffset
+    void openFileReader( size_t aOffset, unsigned aLineNumber );
+
+public:
+
+    /**
+     * Constructor MMAP_LINE_READER
+     * maps @a aFileName in memory.
+     *
+     * @param aFileName is the name of the file to read and to use for error reporting purposes.
+     * @param aNulTerminated is true to get nul terminated copies of the lines, as from the
+     *                       other readers, instead of the lines in place.
+     * @param aStartingLineNumber is the initial line number to report on error.
+     * @param aMaxLineLength is the maximum allowed line length.
+     *
+     * @throw IO_ERROR if @a aFileName cannot be opened.
+     */
+    MMAP_LINE_READER( const wxString& aFileName, bool aNulTerminated = false,
+            unsigned aStartingLineNumber = 0,
+            unsigned aMaxLineLength = LINE_READER_LINE_DEFAULT_MAX );
+
+    ~MMAP_LINE_READER();
+
+    /**
+     * Function ReadLine
+     * @return the next line, in place in the mapping and not nul terminated unless the reader
+     *         was made with aNulTerminated.  It must not be modified.
+     */
+    char* ReadLine() override;
+
+    /**
+     * Function Rewind
+     * goes back to the start of the file and resets the line number back to zero.
+     */
+    void Rewind();
+
+    /**
+     * Function Tell
+     * @return the offset in the file of the line the next ReadLine() returns.
+     */
+    size_t Tell() const { return m_ndx; }
+
+    /**
+     * Function Seek
+     * moves to @a aOffset, which must be the start of a line, usually one returned by Tell().
+     *
+     * @param aOffset is the offset of the line the next ReadLine() returns.
+     * @param aLineNumber is the line number of that line.
+     */
+    void Seek( size_t aOffset, unsigned aLineNumber );
+};
+
+
 /**
  * Class STRING_LINE_READER
  * is a LINE_READER that reads from a multiline 8 bit wide std::string
@@ -268,8 +356,12 @@ public:
      *
      * @param aSource describes the source of aString for error reporting purposes
      *  can be anything meaninful, such as wxT( "clipboard" ).
+     *
+     * @param aStartingLineNumber is the initial line number to report on error, for
+     *  a string holding a part of a larger source.
      */
-    STRING_LINE_READER( const std::string& aString, const wxString& aSource );
+    STRING_LINE_READER( const std::string& aString, const wxString& aSource,
+                        unsigned aStartingLineNumber = 0 );
 
     /**
      * Constructor STRING_LINE_READER( const STRING_LINE_READER& )
@@ -307,6 +399,7 @@ public:
 
 
 #define OUTPUTFMTBUFZ    500        ///< default buffer size for any OUTPUT_FORMATTER
+#define OUTPUTFMTBLOCKZ  (256*1024) ///< size of the blocks of a BUFFERED_OUTPUTFORMATTER
 
 /**
  * Class OUTPUTFORMATTER
@@ -484,12 +577,54 @@ protected:
 };
 
 
+/**
+ * Class BUFFERED_OUTPUTFORMATTER
+ * gathers the output in a large buffer and hands it to flush() in blocks of
+ * OUTPUTFMTBLOCKZ bytes, instead of writing each Print() to its destination.
+ * <p>
+ * The output still in the buffer is flushed by the destructor of the derived classes, which
+ * has to ignore errors.  Call Finish() at the end of the output to get them.
+ */
+class BUFFERED_OUTPUTFORMATTER : public OUTPUTFORMATTER
+{
+public:
+    /**
+     * Function Finish
+     * flushes the buffered output.  Nothing may be output after this.
+     *
+     * @throw IO_ERROR, if there is a problem outputting, such as a full disk.
+     */
+    virtual void Finish();
+
+protected:
+    BUFFERED_OUTPUTFORMATTER( char aQuoteChar );
+
+    /**
+     * Function flush
+     * should be coded in the derived classes to write a block of output to its destination.
+     *
+     * @throw IO_ERROR, if there is a problem outputting.
+     */
+    virtual void flush( const char* aOutBuf, size_t aCount ) = 0;
+
+    /// Hand the buffer over to flush() and empty it.
+    void flushBuffer();
+
+    //-----<OUTPUTFORMATTER>------------------------------------------------
+    void write( const char* aOutBuf, int aCount ) override;
+    //-----</OUTPUTFORMATTER>-----------------------------------------------
+
+private:
+    std::vector<char> m_outBuffer;
+    size_t            m_outCount;      ///< bytes used in m_outBuffer
+};
+
+
 /**
  * Class FILE_OUTPUTFORMATTER
- * may be used for text file output.  It is about 8 times faster than
- * STREAM_OUTPUTFORMATTER for file streams.
+ * may be used for text file output.
  */
-class FILE_OUTPUTFORMATTER : public OUTPUTFORMATTER
+class FILE_OUTPUTFORMATTER : public BUFFERED_OUTPUTFORMATTER
 {
 public:
 
@@ -508,10 +643,18 @@ public:
 
     ~FILE_OUTPUTFORMATTER();
 
+    /**
+     * Function Finish
+     * flushes the buffered output and closes the file.
+     *
+     * @throw IO_ERROR, if the file could not be completely written.
+     */
+    void Finish() override;
+
 protected:
-    //-----<OUTPUTFORMATTER>------------------------------------------------
-    void write( const char* aOutBuf, int aCount ) override;
-    //-----</OUTPUTFORMATTER>-----------------------------------------------
+    //-----<BUFFERED_OUTPUTFORMATTER>---------------------------------------
+    void flush( const char* aOutBuf, size_t aCount ) override;
+    //-----</BUFFERED_OUTPUTFORMATTER>--------------------------------------
 
     FILE*       m_fp;               ///< takes ownership
     wxString    m_filename;
@@ -522,8 +665,11 @@ protected:
  * Class STREAM_OUTPUTFORMATTER
  * implements OUTPUTFORMATTER to a wxWidgets wxOutputStream.  The stream is
  * neither opened nor closed by this class.
+ * <p>
+ * Since the output reaches the stream in large blocks, this is also the way to write
+ * compressed files, through a wxZlibOutputStream created with the wxZLIB_GZIP flag.
  */
-class STREAM_OUTPUTFORMATTER : public OUTPUTFORMATTER
+class STREAM_OUTPUTFORMATTER : public BUFFERED_OUTPUTFORMATTER
 {
     wxOutputStream& m_os;
 
@@ -534,15 +680,17 @@ public:
      * to a file, socket, or zip file.
      */
     STREAM_OUTPUTFORMATTER( wxOutputStream& aStream, char aQuoteChar = '"' ) :
-        OUTPUTFORMATTER( OUTPUTFMTBUFZ, aQuoteChar ),
+        BUFFERED_OUTPUTFORMATTER( aQuoteChar ),
         m_os( aStream )
     {
     }
 
+    ~STREAM_OUTPUTFORMATTER();
+
 protected:
-    //-----<OUTPUTFORMATTER>------------------------------------------------
-    void write( const char* aOutBuf, int aCount ) override;
-    //-----</OUTPUTFORMATTER>-----------------------------------------------
+    //-----<BUFFERED_OUTPUTFORMATTER>---------------------------------------
+    void flush( const char* aOutBuf, size_t aCount ) override;
+    //-----</BUFFERED_OUTPUTFORMATTER>--------------------------------------
 };
 
 #endif // RICHIO_H_
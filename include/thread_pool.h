@@ -0,0 +1,127 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class PROGRESS_REPORTER;
+
+
+/**
+ * Class THREAD_POOL
+ * A work-stealing pool of worker threads, used to run the parallel parts of long
+ * operations (zone fills, connectivity, ratsnest...) without creating threads each time,
+ * and without oversubscribing the cores when several such operations overlap.
+ *
+ * Each worker has its own task queue: it runs its own tasks last-in first-out, and steals
+ * the oldest tasks of the other queues when its queue is empty.  A thread waiting for its
+ * tasks to complete runs pending tasks meanwhile, so parallel loops can be nested (e.g. a
+ * parallel loop started from a task of another parallel loop) without deadlocks.
+ */
+class THREAD_POOL
+{
+public:
+    typedef std::function<void()> TASK;
+
+    /**
+     * @param aThreadCount the number of worker threads.  0 uses one less than the number of
+     *                     cores, as the threads submitting work also run tasks.
+     */
+    THREAD_POOL( size_t aThreadCount = 0 );
+    ~THREAD_POOL();
+
+    THREAD_POOL( const THREAD_POOL& ) = delete;
+    THREAD_POOL& operator=( const THREAD_POOL& ) = delete;
+
+    /**
+     * @return the process-wide pool, shared by all the subsystems.
+     */
+    static THREAD_POOL& GetInstance();
+
+    /**
+     * @return the number of threads running tasks in a parallel loop, including the calling
+     *         thread.
+     */
+    size_t GetParallelism() const
+    {
+        return m_threads.size() + 1;
+    }
+
+    /**
+     * Run aTask( i ) for each i in [0, aCount), on the workers and the calling thread, and
+     * return once they have all been run.  The indexes are handed out in increasing order,
+     * one at a time, so long and short tasks are balanced between the threads.
+     *
+     * @param aCount the number of iterations
+     * @param aTask the iteration body.  It is run concurrently for different indexes.
+     * @param aReporter optional progress reporter, refreshed while waiting when called from
+     *                  the main thread.
+     * @param aCancellable if the user cancels from aReporter, the iterations not started yet
+     *                     are skipped.  Loops which must run to completion pass false.
+     * @return false if the loop was cancelled.
+     * @throw the first exception thrown by aTask, once all the running iterations are done.
+     *        The iterations not started yet are skipped.
+     */
+    bool ParallelFor( size_t aCount, const std::function<void( size_t )>& aTask,
+                      PROGRESS_REPORTER* aReporter = nullptr, bool aCancellable = true );
+
+private:
+    struct TASK_QUEUE
+    {
+        std::mutex       m_mutex;
+        std::deque<TASK> m_tasks;
+    };
+
+    ///> Queues a task, on the queue of the calling worker if any.
+    void push( TASK&& aTask );
+
+    ///> Gets the next task for the calling thread, stealing it if needed.
+    bool pop( TASK& aTask );
+
+    ///> Runs one pending task, if any.
+    bool runPendingTask();
+
+    void workerLoop( size_t aIndex );
+
+    ///> Index of the queue of the calling thread (the shared queue for non-worker threads).
+    size_t ownQueue() const;
+
+    std::vector<std::thread>                 m_threads;
+    std::vector<std::unique_ptr<TASK_QUEUE>> m_queues;      ///< one per worker, then a shared one
+    std::atomic<size_t>                      m_pendingCount;
+    std::mutex                               m_wakeMutex;
+    std::condition_variable                  m_wakeCondition;
+    bool                                     m_quit;
+};
+
+
+#endif // THREAD_POOL_H_
@@ -359,12 +359,37 @@ public:
     /// Creates a Delaunay triangulation from a set of points
     void CreateDelaunay( NODES_CONTAINER::iterator aFirst, NODES_CONTAINER::iterator aLast );
 
+    /**
+     * Creates a Delaunay triangulation from a set of points lying strictly inside the given
+     * rectangle.  Unlike the other CreateDelaunay(), the two triangles enclosing the rectangle
+     * are kept, so nodes can later be inserted and removed with InsertNode() and RemoveNode().
+     * The edges ending at the rectangle corners have to be ignored by the caller.
+     */
+    void CreateDelaunay( NODES_CONTAINER::iterator aFirst, NODES_CONTAINER::iterator aLast,
+                         int aXmin, int aYmin, int aXmax, int aYmax );
+
+    /**
+     * Inserts a node inside the enclosing rectangle of a triangulation made by the second
+     * CreateDelaunay(), keeping it Delaunay.
+     * @return false if the node could not be located in the triangulation.
+     */
+    bool InsertNode( const NODE_PTR& aNode );
+
+    /**
+     * Removes a node of a triangulation made by the second CreateDelaunay(), keeping it Delaunay.
+     * @return false if the node could not be found in the triangulation.
+     */
+    bool RemoveNode( const NODE_PTR& aNode );
+
     /// Creates an initial Delaunay triangulation from two enclosing triangles
     //  When using rectangular boundary - loop through all points and expand.
     //  (Called from createDelaunay(...) when starting)
     EDGE_PTR InitTwoEnclosingTriangles( NODES_CONTAINER::iterator aFirst,
                                         NODES_CONTAINER::iterator aLast );
 
+    /// Creates an initial Delaunay triangulation from two triangles enclosing a rectangle
+    EDGE_PTR InitTwoEnclosingTriangles( int aXmin, int aYmin, int aXmax, int aYmax );
+
     // These two functions are required by TTL for Delaunay triangulation
 
     /// Swaps the edge associated with diagonal
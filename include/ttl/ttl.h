@@ -1687,7 +1687,7 @@ void TRIANGULATION_HELPER::SwapEdgesAwayFromInteriorNode( DART_TYPE& aDart,
     // infinite loop with degree > 3.
     bool allowDegeneracy = true;
 
-    int degree = getDegreeOfNode( aDart );
+    int degree = GetDegreeOfNode( aDart );
     DART_TYPE d_iter;
 
     while( degree > 3 )
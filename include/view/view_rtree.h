@@ -55,6 +55,26 @@ public:
         VIEW_RTREE_BASE::Insert( mmin, mmax, aItem );
     }
 
+    /**
+     * Function BulkLoad()
+     * Inserts many items at once, building a packed tree which is faster to query than
+     * inserting them one by one.
+     */
+    void BulkLoad( const std::vector<VIEW_ITEM*>& aItems )
+    {
+        std::vector<VIEW_RTREE_BASE::BulkItem> entries( aItems.size() );
+
+        for( size_t i = 0; i < aItems.size(); i++ )
+        {
+            const BOX2I& bbox = aItems[i]->ViewBBox();
+
+            entries[i] = { { bbox.GetX(), bbox.GetY() }, { bbox.GetRight(), bbox.GetBottom() },
+                           aItems[i] };
+        }
+
+        VIEW_RTREE_BASE::BulkLoad( entries );
+    }
+
     /**
      * Function Remove()
      * Removes an item from the tree. Removal is done by comparing pointers, attepmting to remove a copy
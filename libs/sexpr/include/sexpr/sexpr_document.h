@@ -0,0 +1,169 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef SEXPR_DOCUMENT_H_
+#define SEXPR_DOCUMENT_H_
+
+#include "sexpr/sexpr.h"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace SEXPR
+{
+    /**
+     * A node of a DOCUMENT: a list or an atom.
+     *
+     * Nodes are plain data living in the arena of their document.  The text of strings and
+     * symbols is not copied, it points into the source text held by the document, and the
+     * children of a list are stored next to each other.  A node is only valid as long as its
+     * document is.
+     */
+    class DOCUMENT_NODE
+    {
+    public:
+        SEXPR_TYPE GetType() const { return m_type; }
+        bool IsList() const { return m_type == SEXPR_TYPE::SEXPR_TYPE_LIST; }
+        bool IsSymbol() const { return m_type == SEXPR_TYPE::SEXPR_TYPE_ATOM_SYMBOL; }
+        bool IsString() const { return m_type == SEXPR_TYPE::SEXPR_TYPE_ATOM_STRING; }
+        bool IsDouble() const { return m_type == SEXPR_TYPE::SEXPR_TYPE_ATOM_DOUBLE; }
+        bool IsInteger() const { return m_type == SEXPR_TYPE::SEXPR_TYPE_ATOM_INTEGER; }
+        size_t GetLineNumber() const { return m_lineNumber; }
+
+        size_t GetNumberOfChildren() const;
+        const DOCUMENT_NODE* GetChild( size_t aIndex ) const;
+
+        /// Range-for support over the children of a list.
+        const DOCUMENT_NODE* begin() const;
+        const DOCUMENT_NODE* end() const;
+
+        int64_t GetLongInteger() const;
+        int32_t GetInteger() const { return static_cast<int32_t>( GetLongInteger() ); }
+        double GetDouble() const;
+        float GetFloat() const { return static_cast<float>( GetDouble() ); }
+
+        /**
+         * @return the text of a string (without its quotes) or of a symbol.  The text is
+         *         not nul-terminated, see GetTextLength().
+         */
+        const char* GetText() const;
+        size_t GetTextLength() const;
+
+        /// @return a copy of the text of a string or a symbol.
+        std::string GetString() const { return std::string( GetText(), GetTextLength() ); }
+
+        /// @return true if the node is the symbol \a aSymbol.
+        bool IsSymbol( const char* aSymbol ) const
+        {
+            return IsSymbol() && m_u.m_text.m_length == strlen( aSymbol )
+                   && memcmp( m_u.m_text.m_begin, aSymbol, m_u.m_text.m_length ) == 0;
+        }
+
+    private:
+        friend class DOCUMENT;
+
+        SEXPR_TYPE m_type;
+        size_t     m_lineNumber;
+
+        union
+        {
+            int64_t m_integer;
+            double  m_double;
+
+            struct
+            {
+                const char* m_begin;
+                size_t      m_length;
+            } m_text;
+
+            struct
+            {
+                const DOCUMENT_NODE* m_begin;
+                size_t               m_count;
+            } m_children;
+        } m_u;
+    };
+
+
+    /**
+     * An s-expression document parsed in a single arena.
+     *
+     * This is a lighter alternative to PARSER for code which only reads a tree: the whole
+     * tree is bump-allocated in a few large blocks, strings and symbols are views into the
+     * source text kept by the document, and everything is released at once when the document
+     * is cleared or destroyed, instead of one SEXPR at a time.
+     *
+     * The grammar is the one of PARSER, so both give the same tree for the same text.
+     */
+    class DOCUMENT
+    {
+    public:
+        DOCUMENT();
+        ~DOCUMENT();
+
+        DOCUMENT( const DOCUMENT& ) = delete;
+        DOCUMENT& operator=( const DOCUMENT& ) = delete;
+
+        /**
+         * Parse the first s-expression of \a aText, replacing the current content of the
+         * document.  The text is kept by the document, so move it in when it is not needed
+         * anymore.
+         *
+         * @return the root of the tree, or nullptr if the text holds no s-expression.
+         * @throw PARSE_EXCEPTION if the text is malformed.
+         */
+        const DOCUMENT_NODE* Parse( std::string aText );
+
+        const DOCUMENT_NODE* ParseFromFile( const std::string& aFileName );
+
+        const DOCUMENT_NODE* GetRoot() const { return m_root; }
+
+        /// Release the tree and the source text.
+        void Clear();
+
+        /// @return the number of bytes reserved by the arena, for statistics.
+        size_t GetArenaSize() const { return m_arenaSize; }
+
+    private:
+        /// @return \a aCount uninitialized nodes from the arena.
+        DOCUMENT_NODE* allocate( size_t aCount );
+
+        const DOCUMENT_NODE* parse();
+
+        std::string                      m_source;
+        const DOCUMENT_NODE*             m_root;
+
+        std::vector<std::unique_ptr<DOCUMENT_NODE[]>> m_blocks;
+        DOCUMENT_NODE*                   m_free;        ///< Next free node of the last block
+        size_t                           m_freeCount;   ///< Free nodes left in the last block
+        size_t                           m_arenaSize;
+
+        /// Nodes of the lists being parsed, moved to the arena when their list is closed.
+        std::vector<DOCUMENT_NODE>       m_pending;
+    };
+}
+
+#endif
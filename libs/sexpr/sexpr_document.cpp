@@ -0,0 +1,348 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "sexpr/sexpr_document.h"
+#include "sexpr/sexpr_parser.h"
+#include "sexpr/sexpr_exception.h"
+
+#include <algorithm>
+#include <cstdlib>     /* strtod */
+
+
+namespace SEXPR
+{
+    /// Nodes in a block of the arena, larger lists get a block of their own.
+    static const size_t ARENA_BLOCK_NODES = 4096;
+
+
+    static inline bool isWhitespace( char aChar )
+    {
+        // Same set as PARSER::whitespaceCharacters
+        switch( aChar )
+        {
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+        case '\b':
+        case '\f':
+        case '\v':
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+
+    static inline bool isNumberChar( char aChar )
+    {
+        return ( aChar >= '0' && aChar <= '9' ) || aChar == '.';
+    }
+
+
+    size_t DOCUMENT_NODE::GetNumberOfChildren() const
+    {
+        if( m_type != SEXPR_TYPE::SEXPR_TYPE_LIST )
+        {
+            throw INVALID_TYPE_EXCEPTION("SEXPR is not a list type!");
+        }
+
+        return m_u.m_children.m_count;
+    }
+
+    const DOCUMENT_NODE* DOCUMENT_NODE::GetChild( size_t aIndex ) const
+    {
+        if( m_type != SEXPR_TYPE::SEXPR_TYPE_LIST )
+        {
+            throw INVALID_TYPE_EXCEPTION("SEXPR is not a list type!");
+        }
+
+        return m_u.m_children.m_begin + aIndex;
+    }
+
+    const DOCUMENT_NODE* DOCUMENT_NODE::begin() const
+    {
+        return GetChild( 0 );
+    }
+
+    const DOCUMENT_NODE* DOCUMENT_NODE::end() const
+    {
+        return GetChild( m_u.m_children.m_count );
+    }
+
+    int64_t DOCUMENT_NODE::GetLongInteger() const
+    {
+        if( m_type != SEXPR_TYPE::SEXPR_TYPE_ATOM_INTEGER )
+        {
+            throw INVALID_TYPE_EXCEPTION("SEXPR is not a integer type!");
+        }
+
+        return m_u.m_integer;
+    }
+
+    double DOCUMENT_NODE::GetDouble() const
+    {
+        // As SEXPR::GetDouble(), integers are silently accepted
+        if( m_type == SEXPR_TYPE::SEXPR_TYPE_ATOM_DOUBLE )
+            return m_u.m_double;
+        else if( m_type == SEXPR_TYPE::SEXPR_TYPE_ATOM_INTEGER )
+            return m_u.m_integer;
+        else
+            throw INVALID_TYPE_EXCEPTION("SEXPR is not a double type!");
+    }
+
+    const char* DOCUMENT_NODE::GetText() const
+    {
+        if( m_type != SEXPR_TYPE::SEXPR_TYPE_ATOM_STRING
+                && m_type != SEXPR_TYPE::SEXPR_TYPE_ATOM_SYMBOL )
+        {
+            throw INVALID_TYPE_EXCEPTION("SEXPR is not a string or symbol type!");
+        }
+
+        return m_u.m_text.m_begin;
+    }
+
+    size_t DOCUMENT_NODE::GetTextLength() const
+    {
+        GetText();
+
+        return m_u.m_text.m_length;
+    }
+
+
+    DOCUMENT::DOCUMENT() :
+        m_root( nullptr ),
+        m_free( nullptr ),
+        m_freeCount( 0 ),
+        m_arenaSize( 0 )
+    {
+    }
+
+    DOCUMENT::~DOCUMENT()
+    {
+    }
+
+    void DOCUMENT::Clear()
+    {
+        // Nodes are plain data, dropping the blocks is all it takes
+        m_blocks.clear();
+        m_free = nullptr;
+        m_freeCount = 0;
+        m_arenaSize = 0;
+        m_root = nullptr;
+        m_source.clear();
+        m_source.shrink_to_fit();
+    }
+
+    const DOCUMENT_NODE* DOCUMENT::Parse( std::string aText )
+    {
+        Clear();
+        m_source = std::move( aText );
+        m_root = parse();
+
+        return m_root;
+    }
+
+    const DOCUMENT_NODE* DOCUMENT::ParseFromFile( const std::string& aFileName )
+    {
+        return Parse( PARSER::GetFileContents( aFileName ) );
+    }
+
+    DOCUMENT_NODE* DOCUMENT::allocate( size_t aCount )
+    {
+        if( aCount > m_freeCount )
+        {
+            size_t size = std::max( aCount, ARENA_BLOCK_NODES );
+
+            m_blocks.emplace_back( new DOCUMENT_NODE[size] );
+            m_free = m_blocks.back().get();
+            m_freeCount = size;
+            m_arenaSize += size * sizeof( DOCUMENT_NODE );
+        }
+
+        DOCUMENT_NODE* nodes = m_free;
+
+        m_free += aCount;
+        m_freeCount -= aCount;
+
+        return nodes;
+    }
+
+    const DOCUMENT_NODE* DOCUMENT::parse()
+    {
+        const char* const start = m_source.data();
+        const char* const last = start + m_source.size();
+        const char*       it = start;
+        size_t            lineNumber = 1;
+
+        // Indices in m_pending of the lists which are still open.  Parsing is iterative so
+        // deeply nested documents can't overflow the stack.
+        std::vector<size_t> openLists;
+
+        m_pending.clear();
+
+        // Move the children of the innermost open list to the arena
+        auto closeList =
+                [&]()
+                {
+                    size_t         listIndex = openLists.back();
+                    size_t         count = m_pending.size() - listIndex - 1;
+                    DOCUMENT_NODE* children = count ? allocate( count ) : nullptr;
+
+                    std::copy( m_pending.begin() + listIndex + 1, m_pending.end(), children );
+                    m_pending.resize( listIndex + 1 );
+                    m_pending[listIndex].m_u.m_children.m_begin = children;
+                    m_pending[listIndex].m_u.m_children.m_count = count;
+                    openLists.pop_back();
+                };
+
+        while( it != last )
+        {
+            char c = *it;
+
+            if( isWhitespace( c ) )
+            {
+                if( c == '\n' )
+                    lineNumber++;
+
+                ++it;
+                continue;
+            }
+
+            DOCUMENT_NODE node;
+
+            node.m_lineNumber = lineNumber;
+
+            if( c == '(' )
+            {
+                node.m_type = SEXPR_TYPE::SEXPR_TYPE_LIST;
+                openLists.push_back( m_pending.size() );
+                m_pending.push_back( node );
+                ++it;
+                continue;
+            }
+            else if( c == ')' )
+            {
+                // A stray closing parenthesis ends the document, as with PARSER
+                if( openLists.empty() )
+                    return nullptr;
+
+                closeList();
+                ++it;
+            }
+            else if( c == '"' )
+            {
+                const char* begin = it + 1;
+                const char* closing = begin;
+
+                // find the closing quote character, be sure it is not escaped
+                for( ;; )
+                {
+                    closing = static_cast<const char*>( memchr( closing, '"', last - closing ) );
+
+                    if( !closing || closing[-1] != '\\' )
+                        break;
+
+                    ++closing;
+                }
+
+                if( !closing )
+                    throw PARSE_EXCEPTION( "missing closing quote" );
+
+                lineNumber += std::count( begin, closing, '\n' );
+
+                node.m_type = SEXPR_TYPE::SEXPR_TYPE_ATOM_STRING;
+                node.m_u.m_text.m_begin = begin;
+                node.m_u.m_text.m_length = closing - begin;
+                m_pending.push_back( node );
+                it = closing + 1;
+            }
+            else
+            {
+                const char* closing = it;
+                bool        number = true;
+                bool        dot = false;
+
+                for( ; closing != last; ++closing )
+                {
+                    char t = *closing;
+
+                    if( isWhitespace( t ) || t == '(' || t == ')' )
+                        break;
+
+                    if( t == '.' )
+                        dot = true;
+                    else if( !isNumberChar( t ) && !( closing == it && t == '-' ) )
+                        number = false;
+                }
+
+                if( closing == last )
+                    throw PARSE_EXCEPTION( "format error" );
+
+                // A lone minus sign is a symbol
+                if( c == '-' && closing - it == 1 )
+                    number = false;
+
+                // The token is followed by a separator, so the number conversions stop there
+                if( number && dot )
+                {
+                    node.m_type = SEXPR_TYPE::SEXPR_TYPE_ATOM_DOUBLE;
+                    node.m_u.m_double = strtod( it, nullptr );
+                }
+                else if( number )
+                {
+                    node.m_type = SEXPR_TYPE::SEXPR_TYPE_ATOM_INTEGER;
+                    node.m_u.m_integer = strtoll( it, nullptr, 0 );
+                }
+                else
+                {
+                    node.m_type = SEXPR_TYPE::SEXPR_TYPE_ATOM_SYMBOL;
+                    node.m_u.m_text.m_begin = it;
+                    node.m_u.m_text.m_length = closing - it;
+                }
+
+                m_pending.push_back( node );
+                it = closing;
+            }
+
+            // Only the first s-expression of the text is parsed
+            if( openLists.empty() )
+                break;
+        }
+
+        if( m_pending.empty() )
+            return nullptr;
+
+        // Lists left open at the end of the text are closed implicitly, as with PARSER
+        while( !openLists.empty() )
+            closeList();
+
+        DOCUMENT_NODE* root = allocate( 1 );
+
+        *root = m_pending.front();
+        m_pending.clear();
+
+        return root;
+    }
+}
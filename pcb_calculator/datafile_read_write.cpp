@@ -98,6 +98,8 @@ bool PCB_CALCULATOR_FRAME::WriteDataFile()
 
         while( nestlevel-- )
             formatter.Print( nestlevel, ")\n" );
+
+        formatter.Finish();
     }
     catch( const IO_ERROR& )
     {
@@ -27,6 +27,8 @@
 #include <pcb_edit_frame.h>
 #include <tool/tool_manager.h>
 #include <tools/selection_tool.h>
+#include <tools/drc.h>
+#include <tools/zone_filler_tool.h>
 #include <view/view.h>
 #include <board_commit.h>
 #include <tools/pcb_tool_base.h>
@@ -67,16 +69,38 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
     auto              connectivity = board->GetConnectivity();
     std::set<EDA_ITEM*>      savedModules;
     std::vector<BOARD_ITEM*> itemsToDeselect;
+    ZONE_FILLER_TOOL*        zoneFiller = nullptr;
 
     if( Empty() )
         return;
 
+    if( !m_editModules )
+        zoneFiller = m_toolMgr->GetTool<ZONE_FILLER_TOOL>();
+
+    // Record the items changed by a commit line, so that only the zones they affect
+    // are refilled later
+    auto markZonesDirty = [&]( const COMMIT_LINE& aEnt )
+    {
+        auto item = static_cast<BOARD_ITEM*>( aEnt.m_item );
+        auto copy = static_cast<BOARD_ITEM*>( aEnt.m_copy );
+
+        if( !zoneFiller || item->Type() == PCB_MARKER_T )
+            return;
+
+        zoneFiller->MarkDirty( item );
+
+        if( copy )
+            zoneFiller->MarkDirty( copy );
+    };
+
     for( COMMIT_LINE& ent : m_changes )
     {
         int changeType = ent.m_type & CHT_TYPE;
         int changeFlags = ent.m_type & CHT_FLAGS;
         BOARD_ITEM* boardItem = static_cast<BOARD_ITEM*>( ent.m_item );
 
+        markZonesDirty( ent );
+
         // Module items need to be saved in the undo buffer before modification
         if( m_editModules )
         {
@@ -267,6 +291,8 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
 
                 auto boardItem = static_cast<BOARD_ITEM*>( ent.m_item );
 
+                markZonesDirty( ent );
+
                 if( aCreateUndoEntry )
                 {
                     ITEM_PICKER itemWrapper( boardItem, UR_CHANGED );
@@ -284,6 +310,35 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
         }
     }
 
+    if( !m_editModules )
+    {
+        DRC* drcTool = m_toolMgr->GetTool<DRC>();
+
+        // Online DRC: re-test only what this commit (and the connectivity update) changed
+        if( drcTool && drcTool->IsOnlineDRC() )
+        {
+            std::vector<BOARD_ITEM*> changedItems;
+            std::vector<BOARD_ITEM*> removedItems;
+
+            for( COMMIT_LINE& ent : m_changes )
+            {
+                BOARD_ITEM* boardItem = static_cast<BOARD_ITEM*>( ent.m_item );
+
+                // Markers are the output of the DRC, they do not need to be tested
+                if( boardItem->Type() == PCB_MARKER_T )
+                    continue;
+
+                if( ( ent.m_type & CHT_TYPE ) == CHT_REMOVE )
+                    removedItems.push_back( boardItem );
+                else
+                    changedItems.push_back( boardItem );
+            }
+
+            if( !changedItems.empty() || !removedItems.empty() )
+                drcTool->TestCommitChanges( changedItems, removedItems );
+        }
+    }
+
     if( !m_editModules && aCreateUndoEntry )
         frame->SaveCopyInUndoList( undoList, UR_UNSPECIFIED );
 
@@ -117,6 +117,8 @@ BOARD::BOARD() :
     m_colorsSettings = &dummyColorsSettings;
     m_CurrentZoneContour = NULL;            // This ZONE_CONTAINER handle the
                                             // zone contour currently in progress
+    m_clearanceResolverValid = false;
+    m_designRulesRevision = 0;
 
     BuildListOfNets();                      // prepare pad and netlist containers.
 
@@ -1070,6 +1072,18 @@ NETINFO_ITEM* BOARD::FindNet( const wxString& aNetname ) const
 }
 
 
+const CLEARANCE_RESOLVER& BOARD::GetClearanceResolver()
+{
+    if( !m_clearanceResolverValid )
+    {
+        m_clearanceResolver.Build( this );
+        m_clearanceResolverValid = true;
+    }
+
+    return m_clearanceResolver;
+}
+
+
 MODULE* BOARD::FindModuleByReference( const wxString& aReference ) const
 {
     MODULE* found = nullptr;
@@ -36,6 +36,7 @@
 
 #include <board_design_settings.h>
 #include <board_item_container.h>
+#include <clearance_resolver.h>
 #include <class_module.h>
 #include <class_pad.h>
 #include <colors_design_settings.h>
@@ -198,6 +199,10 @@ private:
 
     std::shared_ptr<CONNECTIVITY_DATA>      m_connectivity;
 
+    CLEARANCE_RESOLVER      m_clearanceResolver;
+    bool                    m_clearanceResolverValid;   ///< false to rebuild m_clearanceResolver
+    unsigned                m_designRulesRevision;      ///< bumped when the netclasses change
+
     BOARD_DESIGN_SETTINGS   m_designSettings;
     ZONE_SETTINGS           m_zoneSettings;
     COLORS_DESIGN_SETTINGS* m_colorsSettings;
@@ -557,6 +562,36 @@ public:
     void SetDesignSettings( const BOARD_DESIGN_SETTINGS& aDesignSettings )
     {
         m_designSettings = aDesignSettings;
+        InvalidateClearanceResolver();
+    }
+
+    /**
+     * Function GetClearanceResolver
+     * returns the clearances of the nets and items of the board, built again if they were
+     * invalidated since the last call.  Call it from the main thread, before starting the
+     * threads which share it.
+     */
+    const CLEARANCE_RESOLVER& GetClearanceResolver();
+
+    /**
+     * Function InvalidateClearanceResolver
+     * must be called when the netclasses or their clearances are modified without
+     * SetDesignSettings() or SynchronizeNetsAndNetClasses().
+     */
+    void InvalidateClearanceResolver()
+    {
+        m_clearanceResolverValid = false;
+        m_designRulesRevision++;
+    }
+
+    /**
+     * Function GetDesignRulesRevision
+     * @return a number changed every time the design settings or the netclasses of the nets
+     *         are changed, to let the results which depend on them know they are outdated.
+     */
+    unsigned GetDesignRulesRevision() const
+    {
+        return m_designRulesRevision;
     }
 
     const PAGE_INFO& GetPageSettings() const                { return m_paper; }
@@ -0,0 +1,143 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <clearance_resolver.h>
+
+#include <algorithm>
+#include <map>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_zone.h>
+#include <netclass.h>
+
+
+CLEARANCE_RESOLVER::CLEARANCE_RESOLVER() :
+    m_classClearance( 1, 0 ),
+    m_pairClearance( 1, 0 ),
+    m_classCount( 1 ),
+    m_defaultClearance( 0 ),
+    m_maxClearance( 0 )
+{
+}
+
+
+void CLEARANCE_RESOLVER::Build( const BOARD* aBoard )
+{
+    const NETCLASSES& netClasses = aBoard->GetDesignSettings().m_NetClasses;
+    std::map<wxString, int> classIndices;
+
+    m_defaultClearance = netClasses.GetDefault()->GetClearance();
+
+    // The default netclass is not in the NETCLASSES map, it gets the index 0
+    m_classClearance.assign( 1, m_defaultClearance );
+    classIndices[ NETCLASS::Default ] = 0;
+
+    for( NETCLASSES::const_iterator clazz = netClasses.begin(); clazz != netClasses.end(); ++clazz )
+    {
+        classIndices[ clazz->first ] = m_classClearance.size();
+        m_classClearance.push_back( clazz->second->GetClearance() );
+    }
+
+    m_classCount = m_classClearance.size();
+    m_maxClearance = *std::max_element( m_classClearance.begin(), m_classClearance.end() );
+    m_pairClearance.resize( m_classCount * m_classCount );
+
+    for( int a = 0; a < m_classCount; ++a )
+    {
+        for( int b = 0; b < m_classCount; ++b )
+        {
+            m_pairClearance[ a * m_classCount + b ] =
+                    std::max( m_classClearance[a], m_classClearance[b] );
+        }
+    }
+
+    int netCount = 0;
+
+    for( NETINFO_LIST::iterator net = aBoard->BeginNets(); net != aBoard->EndNets(); ++net )
+        netCount = std::max( netCount, net->GetNet() + 1 );
+
+    m_netClass.assign( netCount, 0 );
+
+    for( NETINFO_LIST::iterator net = aBoard->BeginNets(); net != aBoard->EndNets(); ++net )
+    {
+        // Items without net use the default netclass, as BOARD_CONNECTED_ITEM::GetClearance()
+        if( net->GetNet() <= 0 )
+            continue;
+
+        auto index = classIndices.find( net->GetClassName() );
+
+        if( index != classIndices.end() )
+            m_netClass[ net->GetNet() ] = index->second;
+    }
+}
+
+
+int CLEARANCE_RESOLVER::GetItemClearance( const BOARD_CONNECTED_ITEM* aItem ) const
+{
+    switch( aItem->Type() )
+    {
+    case PCB_PAD_T:
+    {
+        // A pad local clearance overrides the footprint one, which overrides the netclass one
+        const D_PAD* pad = static_cast<const D_PAD*>( aItem );
+
+        if( pad->GetLocalClearance() )
+            return pad->GetLocalClearance();
+
+        if( pad->GetParent() && pad->GetParent()->GetLocalClearance() )
+            return pad->GetParent()->GetLocalClearance();
+
+        break;
+    }
+
+    case PCB_ZONE_AREA_T:
+    {
+        const ZONE_CONTAINER* zone = static_cast<const ZONE_CONTAINER*>( aItem );
+
+        return std::max( zone->GetZoneClearance(), GetNetClearance( zone->GetNetCode() ) );
+    }
+
+    default:
+        break;
+    }
+
+    return GetNetClearance( aItem->GetNetCode() );
+}
+
+
+int CLEARANCE_RESOLVER::GetClearance( const BOARD_CONNECTED_ITEM* aItemA,
+                                      const BOARD_CONNECTED_ITEM* aItemB ) const
+{
+    auto hasOwnClearance =
+            []( const BOARD_CONNECTED_ITEM* aItem )
+            {
+                return aItem->Type() == PCB_PAD_T || aItem->Type() == PCB_ZONE_AREA_T;
+            };
+
+    if( !hasOwnClearance( aItemA ) && !hasOwnClearance( aItemB ) )
+        return GetNetPairClearance( aItemA->GetNetCode(), aItemB->GetNetCode() );
+
+    return std::max( GetItemClearance( aItemA ), GetItemClearance( aItemB ) );
+}
@@ -0,0 +1,136 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef CLEARANCE_RESOLVER_H
+#define CLEARANCE_RESOLVER_H
+
+#include <vector>
+
+class BOARD;
+class BOARD_CONNECTED_ITEM;
+
+
+/**
+ * CLEARANCE_RESOLVER
+ * answers the clearance queries of the router, the DRC and the zone filler without going
+ * through the NETCLASSPTR of the nets for every pair of items.
+ *
+ * The netclass of every net and the clearance between every pair of netclasses are looked up
+ * once, when the resolver is built.  The per item overrides (pad and footprint local
+ * clearances, zone clearances) are applied on top of it, with the same rules as the
+ * GetClearance() methods of the items.
+ *
+ * The resolver is owned by the BOARD, which rebuilds it after the design settings changed or
+ * nets were added, see BOARD::GetClearanceResolver().  Once built, the queries only read it so
+ * they can be made from several threads.
+ */
+class CLEARANCE_RESOLVER
+{
+public:
+    CLEARANCE_RESOLVER();
+
+    /**
+     * Function Build
+     * reads the netclasses of the nets of \a aBoard and their clearances.
+     */
+    void Build( const BOARD* aBoard );
+
+    /**
+     * @return the clearance of the default netclass, used by the items which do not belong
+     *         to a net.
+     */
+    int GetDefaultClearance() const
+    {
+        return m_defaultClearance;
+    }
+
+    /**
+     * @return the biggest clearance of the netclasses, the clearance of every item which has
+     *         no clearance of its own is below it.
+     */
+    int GetMaxNetClearance() const
+    {
+        return m_maxClearance;
+    }
+
+    /**
+     * Function GetNetClearance
+     * @return the clearance of the netclass of net \a aNetCode.
+     */
+    int GetNetClearance( int aNetCode ) const
+    {
+        return m_classClearance[ classIndex( aNetCode ) ];
+    }
+
+    /**
+     * Function GetNetPairClearance
+     * @return the clearance between two items of nets \a aNetA and \a aNetB, which do not
+     *         have a clearance of their own (tracks and vias).
+     */
+    int GetNetPairClearance( int aNetA, int aNetB ) const
+    {
+        return m_pairClearance[ classIndex( aNetA ) * m_classCount + classIndex( aNetB ) ];
+    }
+
+    /**
+     * Function GetItemClearance
+     * @return the clearance of \a aItem, the same as aItem->GetClearance().
+     */
+    int GetItemClearance( const BOARD_CONNECTED_ITEM* aItem ) const;
+
+    /**
+     * Function GetClearance
+     * @return the clearance between \a aItemA and \a aItemB, the same as
+     *         aItemA->GetClearance( aItemB ).
+     */
+    int GetClearance( const BOARD_CONNECTED_ITEM* aItemA,
+                      const BOARD_CONNECTED_ITEM* aItemB ) const;
+
+private:
+    /**
+     * @return the index of the netclass of net \a aNetCode in the clearance tables.  Unknown
+     *         nets (and items without net) use the default netclass.
+     */
+    int classIndex( int aNetCode ) const
+    {
+        if( aNetCode >= 0 && aNetCode < (int) m_netClass.size() )
+            return m_netClass[aNetCode];
+
+        return 0;
+    }
+
+    ///> Index of the netclass of every net code, 0 is the default netclass
+    std::vector<int> m_netClass;
+
+    ///> Clearance of every netclass
+    std::vector<int> m_classClearance;
+
+    ///> Clearance between two netclasses, m_classCount x m_classCount
+    std::vector<int> m_pairClearance;
+
+    int              m_classCount;
+    int              m_defaultClearance;
+    int              m_maxClearance;
+};
+
+#endif      // CLEARANCE_RESOLVER_H
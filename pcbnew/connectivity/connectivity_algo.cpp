@@ -26,11 +26,11 @@
 #include <widgets/progress_reporter.h>
 #include <geometry/geometry_utils.h>
 #include <board_commit.h>
+#include <thread_pool.h>
 
-#include <thread>
+#include <atomic>
 #include <mutex>
 #include <algorithm>
-#include <future>
 
 #ifdef PROFILE
 #include <profile.h>
@@ -218,48 +218,21 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
 
     if( m_itemList.IsDirty() )
     {
-        size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
-                ( dirtyItems.size() + 7 ) / 8 );
-
-        std::atomic<size_t> nextItem( 0 );
-        std::vector<std::future<size_t>> returns( parallelThreadCount );
-
-        auto conn_lambda = [&nextItem, &dirtyItems]
-                            ( CN_LIST* aItemList, PROGRESS_REPORTER* aReporter) -> size_t
+        auto conn_lambda = [&]( size_t aIndex )
         {
-            for( size_t i = nextItem++; i < dirtyItems.size(); i = nextItem++ )
-            {
-                CN_VISITOR visitor( dirtyItems[i] );
-                aItemList->FindNearby( dirtyItems[i], visitor );
-
-                if( aReporter )
-                    aReporter->AdvanceProgress();
-            }
+            CN_VISITOR visitor( dirtyItems[aIndex] );
+            m_itemList.FindNearby( dirtyItems[aIndex], visitor );
 
-            return 1;
+            if( m_progressReporter )
+                m_progressReporter->AdvanceProgress();
         };
 
-        if( parallelThreadCount <= 1 )
-            conn_lambda( &m_itemList, m_progressReporter );
-        else
-        {
-            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-                returns[ii] = std::async( std::launch::async, conn_lambda,
-                        &m_itemList, m_progressReporter );
-
-            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            {
-                // Here we balance returns with a 100ms timeout to allow UI updating
-                std::future_status status;
-                do
-                {
-                    if( m_progressReporter )
-                        m_progressReporter->KeepRefreshing();
+        // Connectivity must be complete, so the search is not cancellable
+        THREAD_POOL::GetInstance().ParallelFor( dirtyItems.size(), conn_lambda,
+                                                m_progressReporter, false );
 
-                    status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
-                } while( status != std::future_status::ready );
-            }
-        }
+        for( auto item : m_itemList )
+            item->SortConnections();
 
         if( m_progressReporter )
             m_progressReporter->KeepRefreshing();
@@ -290,20 +263,89 @@ CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUSTER_SEA
 }
 
 
+/**
+ * Disjoint sets of items, which several threads can merge at the same time.
+ *
+ * Each set is represented by its lowest index and sets are always linked to a lower index,
+ * so the parent links only decrease and can be updated with compare-and-swap, without locks
+ * and without ever making a loop.
+ */
+class CN_DISJOINT_SETS
+{
+public:
+    CN_DISJOINT_SETS( size_t aCount ) :
+        m_parent( new std::atomic<int>[aCount] )
+    {
+        for( size_t i = 0; i < aCount; i++ )
+            m_parent[i].store( (int) i, std::memory_order_relaxed );
+    }
+
+    int Find( int aIndex )
+    {
+        for( ;; )
+        {
+            int parent = m_parent[aIndex].load();
+
+            if( parent == aIndex )
+                return aIndex;
+
+            int grandParent = m_parent[parent].load();
+
+            // Path halving.  If another thread changed the link meanwhile, the path is
+            // simply not shortened.
+            if( grandParent != parent )
+                m_parent[aIndex].compare_exchange_weak( parent, grandParent );
+
+            aIndex = grandParent;
+        }
+    }
+
+    void Union( int aIndex1, int aIndex2 )
+    {
+        for( ;; )
+        {
+            int root1 = Find( aIndex1 );
+            int root2 = Find( aIndex2 );
+
+            if( root1 == root2 )
+                return;
+
+            if( root1 < root2 )
+                std::swap( root1, root2 );
+
+            // Fails if root1 was linked by another thread, then its new root is looked up
+            int expected = root1;
+
+            if( m_parent[root1].compare_exchange_strong( expected, root2 ) )
+                return;
+
+            aIndex1 = root1;
+            aIndex2 = root2;
+        }
+    }
+
+private:
+    std::unique_ptr<std::atomic<int>[]> m_parent;
+};
+
+
 CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUSTER_SEARCH_MODE aMode,
         const KICAD_T aTypes[], int aSingleNet )
 {
     bool withinAnyNet = ( aMode != CSM_PROPAGATE );
 
-    std::deque<CN_ITEM*> Q;
-    CN_ITEM* head = nullptr;
+    std::vector<CN_ITEM*> items;
     CLUSTERS clusters;
 
     if( m_itemList.IsDirty() )
         searchConnections();
 
-    auto addToSearchList = [&head, withinAnyNet, aSingleNet, aTypes] ( CN_ITEM *aItem )
+    m_itemList.UpdateNetAnchors();
+
+    auto addToSearchList = [&items, withinAnyNet, aSingleNet, aTypes] ( CN_ITEM *aItem )
     {
+        aItem->SetSearchIndex( -1 );
+
         if( withinAnyNet && aItem->Net() <= 0 )
             return;
 
@@ -327,53 +369,56 @@ CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUSTER_SEA
         if( !found )
             return;
 
-        aItem->ListClear();
-        aItem->SetVisited( false );
-
-        if( !head )
-            head = aItem;
-        else
-            head->ListInsert( aItem );
+        aItem->SetSearchIndex( items.size() );
+        items.push_back( aItem );
     };
 
     std::for_each( m_itemList.begin(), m_itemList.end(), addToSearchList );
 
-    while( head )
-    {
-        CN_CLUSTER_PTR cluster ( new CN_CLUSTER() );
-
-        Q.clear();
-        CN_ITEM* root = head;
-        root->SetVisited ( true );
-
-        head = root->ListRemove();
+    // Merge the sets of the connected items, in chunks of items spread over the threads
+    CN_DISJOINT_SETS sets( items.size() );
+    THREAD_POOL&     pool = THREAD_POOL::GetInstance();
+    size_t           chunkSize = std::max<size_t>( 1, items.size() / ( pool.GetParallelism() * 4 ) );
+    size_t           chunkCount = ( items.size() + chunkSize - 1 ) / chunkSize;
 
-        Q.push_back( root );
+    auto union_lambda = [&]( size_t aChunk )
+    {
+        size_t end = std::min( items.size(), ( aChunk + 1 ) * chunkSize );
 
-        while( Q.size() )
+        for( size_t ii = aChunk * chunkSize; ii < end; ++ii )
         {
-            CN_ITEM* current = Q.front();
+            CN_ITEM* item = items[ii];
 
-            Q.pop_front();
-            cluster->Add( current );
-
-            for( auto n : current->ConnectedItems() )
+            for( auto n : item->ConnectedItems() )
             {
-                if( withinAnyNet && n->Net() != root->Net() )
+                if( n->SearchIndex() < 0 )
                     continue;
 
-                if( !n->Visited() && n->Valid() )
-                {
-                    n->SetVisited( true );
-                    Q.push_back( n );
-                    head = n->ListRemove();
-                }
+                if( withinAnyNet && n->Net() != item->Net() )
+                    continue;
+
+                sets.Union( ii, n->SearchIndex() );
             }
         }
+    };
 
-        clusters.push_back( cluster );
-    }
+    pool.ParallelFor( chunkCount, union_lambda, nullptr, false );
+
+    // A set is represented by its first item, so the clusters come in the order of the items
+    std::vector<int> clusterIndex( items.size(), -1 );
 
+    for( size_t ii = 0; ii < items.size(); ++ii )
+    {
+        int root = sets.Find( ii );
+
+        if( clusterIndex[root] < 0 )
+        {
+            clusterIndex[root] = clusters.size();
+            clusters.emplace_back( new CN_CLUSTER() );
+        }
+
+        clusters[clusterIndex[root]]->Add( items[ii] );
+    }
 
     std::sort( clusters.begin(), clusters.end(), []( CN_CLUSTER_PTR a, CN_CLUSTER_PTR b ) {
         return a->OriginNet() < b->OriginNet();
@@ -395,6 +440,8 @@ CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUSTER_SEA
 
 void CN_CONNECTIVITY_ALGO::Build( BOARD* aBoard )
 {
+    m_itemList.BeginBulkLoad();
+
     for( int i = 0; i<aBoard->GetAreaCount(); i++ )
     {
         auto zone = aBoard->GetArea( i );
@@ -410,6 +457,8 @@ void CN_CONNECTIVITY_ALGO::Build( BOARD* aBoard )
             Add( pad );
     }
 
+    m_itemList.EndBulkLoad();
+
     /*wxLogTrace( "CN", "zones : %lu, pads : %lu vias : %lu tracks : %lu\n",
             m_zoneList.Size(), m_padList.Size(),
             m_viaList.Size(), m_trackList.Size() );*/
@@ -418,6 +467,8 @@ void CN_CONNECTIVITY_ALGO::Build( BOARD* aBoard )
 
 void CN_CONNECTIVITY_ALGO::Build( const std::vector<BOARD_ITEM*>& aItems )
 {
+    m_itemList.BeginBulkLoad();
+
     for( auto item : aItems )
     {
         switch( item->Type() )
@@ -442,6 +493,8 @@ void CN_CONNECTIVITY_ALGO::Build( const std::vector<BOARD_ITEM*>& aItems )
                 break;
         }
     }
+
+    m_itemList.EndBulkLoad();
 }
 
 
@@ -729,11 +782,17 @@ void CN_CONNECTIVITY_ALGO::ForEachItem( const std::function<void( CN_ITEM& )>& a
 
 void CN_CONNECTIVITY_ALGO::ForEachAnchor( const std::function<void( CN_ANCHOR& )>& aFunc )
 {
-    ForEachItem( [aFunc] ( CN_ITEM& item ) {
-        for( const auto& anchor : item.Anchors() )
-            aFunc( *anchor );
+    for( const auto& netAnchors : m_itemList.NetAnchors() )
+    {
+        if( !netAnchors )
+            continue;
+
+        for( auto& anchor : *netAnchors )
+        {
+            if( anchor.Item() )
+                aFunc( anchor );
         }
-    );
+    }
 }
 
 
@@ -41,7 +41,6 @@
 #include <functional>
 #include <vector>
 #include <deque>
-#include <intrusive_list.h>
 
 #include <connectivity/connectivity_rtree.h>
 #include <connectivity/connectivity_data.h>
@@ -55,21 +54,27 @@ class BOARD_ITEM;
 class ZONE_CONTAINER;
 class PROGRESS_REPORTER;
 
+/**
+ * An edge between two anchors of a net, given by their index in the anchors of the net.  It
+ * is valid as long as the ratsnest of the net keeps these anchors.
+ */
 class CN_EDGE
 {
 public:
     CN_EDGE() {};
-    CN_EDGE( CN_ANCHOR_PTR aSource, CN_ANCHOR_PTR aTarget, int aWeight = 0 ) :
+    CN_EDGE( CN_NET_ANCHORS* aAnchors, int aSource, int aTarget, int aWeight = 0 ) :
+        m_anchors( aAnchors ),
         m_source( aSource ),
         m_target( aTarget ),
         m_weight( aWeight ) {}
 
-    CN_ANCHOR_PTR GetSourceNode() const { return m_source; }
-    CN_ANCHOR_PTR GetTargetNode() const { return m_target; }
+    CN_ANCHOR& GetSourceNode() const { return ( *m_anchors )[m_source]; }
+    CN_ANCHOR& GetTargetNode() const { return ( *m_anchors )[m_target]; }
+    int GetSourceIndex() const { return m_source; }
+    int GetTargetIndex() const { return m_target; }
+    CN_NET_ANCHORS* GetAnchors() const { return m_anchors; }
     int GetWeight() const { return m_weight; }
 
-    void SetSourceNode( const CN_ANCHOR_PTR& aNode ) { m_source = aNode; }
-    void SetTargetNode( const CN_ANCHOR_PTR& aNode ) { m_target = aNode; }
     void SetWeight( unsigned int weight ) { m_weight = weight; }
 
     void SetVisible( bool aVisible )
@@ -84,17 +89,18 @@ public:
 
     const VECTOR2I GetSourcePos() const
     {
-        return m_source->Pos();
+        return GetSourceNode().Pos();
     }
 
     const VECTOR2I GetTargetPos() const
     {
-        return m_target->Pos();
+        return GetTargetNode().Pos();
     }
 
 private:
-    CN_ANCHOR_PTR m_source;
-    CN_ANCHOR_PTR m_target;
+    CN_NET_ANCHORS* m_anchors = nullptr;
+    int m_source = -1;
+    int m_target = -1;
     unsigned int m_weight = 0;
     bool m_visible = true;
 };
@@ -135,12 +141,12 @@ private:
             m_items.push_back( aItem );
         }
 
-        const std::list<CN_ITEM*> GetItems() const
+        const std::vector<CN_ITEM*>& GetItems() const
         {
             return m_items;
         }
 
-        std::list<CN_ITEM*> m_items;
+        std::vector<CN_ITEM*> m_items;
     };
 
     CN_LIST m_itemList;
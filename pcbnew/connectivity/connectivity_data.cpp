@@ -27,9 +27,8 @@
 #include <profile.h>
 #endif
 
-#include <thread>
+#include <thread_pool.h>
 #include <algorithm>
-#include <future>
 
 #include <connectivity/connectivity_data.h>
 #include <connectivity/connectivity_algo.h>
@@ -106,32 +105,11 @@ void CONNECTIVITY_DATA::updateRatsnest()
     std::copy_if( m_nets.begin() + 1, m_nets.end(), std::back_inserter( dirty_nets ),
             [] ( RN_NET* aNet ) { return aNet->IsDirty() && aNet->GetNodeCount() > 0; } );
 
-    // We don't want to spin up a new thread for fewer than 8 nets (overhead costs)
-    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
-            ( dirty_nets.size() + 7 ) / 8 );
-
-    std::atomic<size_t> nextNet( 0 );
-    std::vector<std::future<size_t>> returns( parallelThreadCount );
-
-    auto update_lambda = [&nextNet, &dirty_nets]() -> size_t
-    {
-        for( size_t i = nextNet++; i < dirty_nets.size(); i = nextNet++ )
-            dirty_nets[i]->Update();
-
-        return 1;
-    };
-
-    if( parallelThreadCount == 1 )
-        update_lambda();
-    else
-    {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, update_lambda );
-
-        // Finalize the ratsnest threads
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii].wait();
-    }
+    THREAD_POOL::GetInstance().ParallelFor( dirty_nets.size(),
+            [&dirty_nets]( size_t aIndex )
+            {
+                dirty_nets[aIndex]->Update();
+            } );
 
     #ifdef PROFILE
     rnUpdate.Show();
@@ -187,6 +165,10 @@ void CONNECTIVITY_DATA::RecalculateRatsnest( BOARD_COMMIT* aCommit  )
 
     m_connAlgo->ClearDirtyFlags();
 
+    // The nodes of the nets changed, index them again at the next dynamic ratsnest
+    if( dirtyNets > 0 )
+        clearDynamicItems();
+
     updateRatsnest();
 }
 
@@ -216,8 +198,8 @@ void CONNECTIVITY_DATA::BlockRatsnestItems( const std::vector<BOARD_ITEM*>& aIte
 
             for( auto cnItem : entry.GetItems() )
             {
-                for( auto anchor : cnItem->Anchors() )
-                    anchor->SetNoLine( true );
+                for( auto& anchor : cnItem->Anchors() )
+                    anchor.SetNoLine( true );
             }
         }
     }
@@ -255,7 +237,14 @@ void CONNECTIVITY_DATA::ComputeDynamicRatsnest( const std::vector<BOARD_ITEM*>&
     }
 
     CONNECTIVITY_DATA connData( aItems );
-    BlockRatsnestItems( aItems );
+
+    // The nodes which do not move are indexed once, when a new set of items starts moving
+    if( aItems != m_dynamicItems )
+    {
+        clearDynamicItems();
+        m_dynamicItems = aItems;
+        BlockRatsnestItems( aItems );
+    }
 
     for( unsigned int nc = 1; nc < connData.m_nets.size(); nc++ )
     {
@@ -264,13 +253,16 @@ void CONNECTIVITY_DATA::ComputeDynamicRatsnest( const std::vector<BOARD_ITEM*>&
         if( dynNet->GetNodeCount() != 0 )
         {
             auto ourNet = m_nets[nc];
-            CN_ANCHOR_PTR nodeA, nodeB;
+            int  nodeA, nodeB;
+
+            if( !ourNet->HasNodeTree() )
+                ourNet->BuildNodeTree();
 
             if( ourNet->NearestBicoloredPair( *dynNet, nodeA, nodeB ) )
             {
                 RN_DYNAMIC_LINE l;
-                l.a = nodeA->Pos();
-                l.b = nodeB->Pos();
+                l.a = ourNet->GetNode( nodeA ).Pos();
+                l.b = dynNet->GetNode( nodeB ).Pos();
                 l.netCode = nc;
 
                 m_dynamicRatsnest.push_back( l );
@@ -290,12 +282,10 @@ void CONNECTIVITY_DATA::ComputeDynamicRatsnest( const std::vector<BOARD_ITEM*>&
 
         for( const auto& edge : edges )
         {
-            const auto& nodeA   = edge.GetSourceNode();
-            const auto& nodeB   = edge.GetTargetNode();
             RN_DYNAMIC_LINE l;
 
-            l.a = nodeA->Pos();
-            l.b = nodeB->Pos();
+            l.a = edge.GetSourcePos();
+            l.b = edge.GetTargetPos();
             l.netCode = 0;
             m_dynamicRatsnest.push_back( l );
         }
@@ -306,10 +296,23 @@ void CONNECTIVITY_DATA::ComputeDynamicRatsnest( const std::vector<BOARD_ITEM*>&
 void CONNECTIVITY_DATA::ClearDynamicRatsnest()
 {
     m_connAlgo->ForEachAnchor( [] ( CN_ANCHOR& anchor ) { anchor.SetNoLine( false ); } );
+    clearDynamicItems();
     HideDynamicRatsnest();
 }
 
 
+void CONNECTIVITY_DATA::clearDynamicItems()
+{
+    m_dynamicItems.clear();
+
+    for( auto net : m_nets )
+    {
+        if( net )
+            net->ClearNodeTree();
+    }
+}
+
+
 void CONNECTIVITY_DATA::HideDynamicRatsnest()
 {
     m_dynamicRatsnest.clear();
@@ -422,11 +425,11 @@ bool CONNECTIVITY_DATA::CheckConnectivity( std::vector<CN_DISJOINT_NET_ENTRY>& a
             for( const auto& edge : net->GetEdges() )
             {
                 CN_DISJOINT_NET_ENTRY ent;
-                ent.net = edge.GetSourceNode()->Parent()->GetNetCode();
-                ent.a   = edge.GetSourceNode()->Parent();
-                ent.b   = edge.GetTargetNode()->Parent();
-                ent.anchorA = edge.GetSourceNode()->Pos();
-                ent.anchorB = edge.GetTargetNode()->Pos();
+                ent.net = edge.GetSourceNode().Parent()->GetNetCode();
+                ent.a   = edge.GetSourceNode().Parent();
+                ent.b   = edge.GetTargetNode().Parent();
+                ent.anchorA = edge.GetSourcePos();
+                ent.anchorB = edge.GetTargetPos();
                 aReport.push_back( ent );
             }
         }
@@ -561,9 +564,9 @@ std::vector<VECTOR2I> CONNECTIVITY_DATA::NearestUnconnectedTargets(
                 if( item->Valid() && item->Parent()->GetNetCode() == refNet
                     && item->Parent()->Type() != PCB_ZONE_AREA_T )
                 {
-                    for( auto anchor : item->Anchors() )
+                    for( const auto& anchor : item->Anchors() )
                     {
-                        anchors.insert( anchor->Pos() );
+                        anchors.insert( anchor.Pos() );
                     }
                 }
             }
@@ -609,9 +612,9 @@ std::vector<BOARD_CONNECTED_ITEM*> CONNECTIVITY_DATA::GetConnectedItems(
 
     for( auto cnItem : entry.GetItems() )
     {
-        for( auto anchor : cnItem->Anchors() )
+        for( const auto& anchor : cnItem->Anchors() )
         {
-            if( anchor->Pos() == aAnchor )
+            if( anchor.Pos() == aAnchor )
             {
                 for( int i = 0; aTypes[i] > 0; i++ )
                 {
@@ -681,11 +684,8 @@ std::vector<CN_EDGE> CONNECTIVITY_DATA::GetRatsnestForComponent( MODULE* aCompon
 
         for ( auto edge : net->GetEdges() )
         {
-            auto srcNode = edge.GetSourceNode();
-            auto dstNode = edge.GetTargetNode();
-
-            auto srcParent = static_cast<D_PAD*>( srcNode->Parent() );
-            auto dstParent = static_cast<D_PAD*>( dstNode->Parent() );
+            auto srcParent = static_cast<D_PAD*>( edge.GetSourceNode().Parent() );
+            auto dstParent = static_cast<D_PAD*>( edge.GetTargetNode().Parent() );
 
             bool srcFound = ( pads.find(srcParent) != pads.end() );
             bool dstFound = ( pads.find(dstParent) != pads.end() );
@@ -199,6 +199,8 @@ public:
      * Function ComputeDynamicRatsnest()
      * Calculates the temporary dynamic ratsnest (i.e. the ratsnest lines that)
      * for the set of items aItems.
+     * While the same items are being moved, the nodes of the board which do not move are
+     * only indexed once, by the first call.
      */
     void ComputeDynamicRatsnest( const std::vector<BOARD_ITEM*>& aItems );
 
@@ -253,9 +255,16 @@ private:
     void    updateRatsnest();
     void    addRatsnestCluster( const std::shared_ptr<CN_CLUSTER>& aCluster );
 
+    ///> Forgets the items of the last ComputeDynamicRatsnest() call and the nodes indexed for them
+    void    clearDynamicItems();
+
     std::shared_ptr<CN_CONNECTIVITY_ALGO> m_connAlgo;
 
     std::vector<RN_DYNAMIC_LINE> m_dynamicRatsnest;
+
+    ///> Items of the last ComputeDynamicRatsnest() call
+    std::vector<BOARD_ITEM*> m_dynamicItems;
+
     std::vector<RN_NET*> m_nets;
 
     PROGRESS_REPORTER* m_progressReporter;
@@ -26,6 +26,9 @@
 
 #include <connectivity/connectivity_items.h>
 
+#include <algorithm>
+#include <unordered_map>
+
 int CN_ITEM::AnchorCount() const
 {
     if( !m_valid )
@@ -109,22 +112,80 @@ VECTOR2I CN_ZONE::GetAnchor( int n ) const
 }
 
 
+void CN_NET_ANCHORS::Remove( int aFirst, int aCount )
+{
+    for( int i = aFirst; i < aFirst + aCount; i++ )
+        m_anchors[i] = CN_ANCHOR();
+
+    m_removedCount += aCount;
+}
+
+
+void CN_ITEM::SetAnchors( const CN_NET_ANCHORS_PTR& aNetAnchors, const VECTOR2I* aPositions,
+                          int aCount )
+{
+    removeAnchors();
+
+    m_netAnchors = aNetAnchors;
+    m_firstAnchor = aNetAnchors->Size();
+    m_anchorCount = aCount;
+
+    for( int i = 0; i < aCount; i++ )
+        aNetAnchors->Add( CN_ANCHOR( aPositions[i], this ) );
+}
+
+
+void CN_ITEM::MoveAnchors( const CN_NET_ANCHORS_PTR& aNetAnchors )
+{
+    if( m_netAnchors == aNetAnchors )
+        return;
+
+    int first = aNetAnchors->Size();
+
+    // The anchors keep their flags and cluster
+    for( int i = 0; i < m_anchorCount; i++ )
+        aNetAnchors->Add( ( *m_netAnchors )[m_firstAnchor + i] );
+
+    removeAnchors();
+
+    m_netAnchors = aNetAnchors;
+    m_firstAnchor = first;
+}
+
+
+void CN_ITEM::removeAnchors()
+{
+    if( m_netAnchors )
+        m_netAnchors->Remove( m_firstAnchor, m_anchorCount );
+}
+
+
+void CN_ITEM::SortConnections()
+{
+    if( !m_connectedUnsorted )
+        return;
+
+    std::sort( m_connected.begin(), m_connected.end() );
+    m_connected.erase( std::unique( m_connected.begin(), m_connected.end() ),
+                       m_connected.end() );
+    m_connectedUnsorted = false;
+}
+
+
 void CN_ITEM::RemoveInvalidRefs()
 {
-    for( auto it = m_connected.begin(); it != m_connected.end(); )
-    {
-        if( !(*it)->Valid() )
-            it = m_connected.erase( it );
-        else
-            ++it;
-    }
+    m_connected.erase( std::remove_if( m_connected.begin(), m_connected.end(),
+                                       []( CN_ITEM* aItem ) { return !aItem->Valid(); } ),
+                       m_connected.end() );
 }
 
 
 CN_ITEM* CN_LIST::Add( D_PAD* pad )
  {
      auto item = new CN_ITEM( pad, false, 1 );
-     item->AddAnchor( pad->ShapePos() );
+     VECTOR2I pos = pad->ShapePos();
+
+     item->SetAnchors( netAnchors( pad->GetNetCode() ), &pos, 1 );
      item->SetLayers( LAYER_RANGE( F_Cu, B_Cu ) );
 
      switch( pad->GetAttribute() )
@@ -158,9 +219,10 @@ CN_ITEM* CN_LIST::Add( D_PAD* pad )
  CN_ITEM* CN_LIST::Add( TRACK* track )
  {
      auto item = new CN_ITEM( track, true );
+     const VECTOR2I ends[2] = { track->GetStart(), track->GetEnd() };
+
      m_items.push_back( item );
-     item->AddAnchor( track->GetStart() );
-     item->AddAnchor( track->GetEnd() );
+     item->SetAnchors( netAnchors( track->GetNetCode() ), ends, 2 );
      item->SetLayer( track->GetLayer() );
      addItemtoTree( item );
      SetDirty();
@@ -170,9 +232,10 @@ CN_ITEM* CN_LIST::Add( D_PAD* pad )
  CN_ITEM* CN_LIST::Add( VIA* via )
  {
      auto item = new CN_ITEM( via, true, 1 );
+     VECTOR2I pos = via->GetStart();
 
      m_items.push_back( item );
-     item->AddAnchor( via->GetStart() );
+     item->SetAnchors( netAnchors( via->GetNetCode() ), &pos, 1 );
      item->SetLayers( LAYER_RANGE( F_Cu, B_Cu ) );
      addItemtoTree( item );
      SetDirty();
@@ -184,14 +247,19 @@ CN_ITEM* CN_LIST::Add( D_PAD* pad )
      const auto& polys = zone->GetFilledPolysList();
 
      std::vector<CN_ITEM*> rv;
+     std::vector<VECTOR2I> points;
 
      for( int j = 0; j < polys.OutlineCount(); j++ )
      {
          CN_ZONE* zitem = new CN_ZONE( zone, false, j );
          const auto& outline = zone->GetFilledPolysList().COutline( j );
 
+         points.clear();
+
          for( int k = 0; k < outline.PointCount(); k++ )
-             zitem->AddAnchor( outline.CPoint( k ) );
+             points.push_back( outline.CPoint( k ) );
+
+         zitem->SetAnchors( netAnchors( zone->GetNetCode() ), points.data(), points.size() );
 
          m_items.push_back( zitem );
          zitem->SetLayer( zone->GetLayer() );
@@ -232,6 +300,56 @@ void CN_LIST::RemoveInvalidItems( std::vector<CN_ITEM*>& aGarbage )
 }
 
 
+const CN_NET_ANCHORS_PTR& CN_LIST::netAnchors( int aNet )
+{
+    size_t net = std::max( aNet, 0 );
+
+    if( net >= m_netAnchors.size() )
+        m_netAnchors.resize( net + 1 );
+
+    if( !m_netAnchors[net] )
+        m_netAnchors[net] = std::make_shared<CN_NET_ANCHORS>();
+
+    return m_netAnchors[net];
+}
+
+
+void CN_LIST::UpdateNetAnchors()
+{
+    // Net propagation changes the nets of the items without adding them again
+    for( auto item : m_items )
+    {
+        if( item->Valid() )
+            item->MoveAnchors( netAnchors( item->Net() ) );
+    }
+
+    // The ratsnest keeps the arrays it indexes, so the anchors go to new arrays
+    std::unordered_map<CN_NET_ANCHORS_PTR, CN_NET_ANCHORS_PTR> compacted;
+
+    for( auto& anchors : m_netAnchors )
+    {
+        if( anchors && anchors->RemovedCount() > anchors->Size() / 2 )
+        {
+            auto newAnchors = std::make_shared<CN_NET_ANCHORS>();
+
+            compacted[anchors] = newAnchors;
+            anchors = newAnchors;
+        }
+    }
+
+    if( compacted.empty() )
+        return;
+
+    for( auto item : m_items )
+    {
+        auto it = compacted.find( item->NetAnchors() );
+
+        if( it != compacted.end() )
+            item->MoveAnchors( it->second );
+    }
+}
+
+
 BOARD_CONNECTED_ITEM* CN_ANCHOR::Parent() const
 {
     assert( m_item->Valid() );
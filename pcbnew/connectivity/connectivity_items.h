@@ -40,7 +40,6 @@
 #include <memory>
 #include <functional>
 #include <vector>
-#include <intrusive_list.h>
 
 #include <connectivity/connectivity_rtree.h>
 #include <connectivity/connectivity_data.h>
@@ -149,15 +148,114 @@ private:
 };
 
 
-typedef std::shared_ptr<CN_ANCHOR>  CN_ANCHOR_PTR;
-typedef std::vector<CN_ANCHOR_PTR>  CN_ANCHORS;
+/**
+ * The anchors of the items of a net, stored next to each other.  The items, the ratsnest
+ * nodes and the ratsnest edges refer to them by their index.
+ *
+ * Removed anchors leave invalid anchors in their place, so the indices stay valid.  When they
+ * outnumber the valid ones, CN_LIST moves the anchors of the net to a new array while the
+ * ratsnest keeps the array its indices refer to.
+ */
+class CN_NET_ANCHORS
+{
+public:
+    /**
+     * Function Add()
+     *
+     * Appends an anchor.
+     * @return the index of the anchor.
+     */
+    int Add( const CN_ANCHOR& aAnchor )
+    {
+        m_anchors.push_back( aAnchor );
+        return m_anchors.size() - 1;
+    }
+
+    /**
+     * Function Remove()
+     *
+     * Replaces aCount anchors, starting at index aFirst, by invalid anchors.
+     */
+    void Remove( int aFirst, int aCount );
+
+    CN_ANCHOR& operator[]( int aIndex )
+    {
+        return m_anchors[aIndex];
+    }
+
+    const CN_ANCHOR& operator[]( int aIndex ) const
+    {
+        return m_anchors[aIndex];
+    }
+
+    int Size() const
+    {
+        return m_anchors.size();
+    }
+
+    int RemovedCount() const
+    {
+        return m_removedCount;
+    }
+
+    using ITER = std::vector<CN_ANCHOR>::iterator;
+
+    ITER begin() { return m_anchors.begin(); };
+    ITER end() { return m_anchors.end(); };
+
+private:
+    std::vector<CN_ANCHOR> m_anchors;
+
+    ///> number of anchors replaced by invalid ones
+    int m_removedCount = 0;
+};
+
+typedef std::shared_ptr<CN_NET_ANCHORS> CN_NET_ANCHORS_PTR;
+
+
+/**
+ * The anchors of an item, a range of the anchors of its net.  Adding anchors to the net
+ * invalidates it.
+ */
+class CN_ITEM_ANCHORS
+{
+public:
+    CN_ITEM_ANCHORS( CN_ANCHOR* aBegin = nullptr, CN_ANCHOR* aEnd = nullptr ) :
+        m_begin( aBegin ),
+        m_end( aEnd )
+    {
+    }
+
+    CN_ANCHOR* begin() const { return m_begin; }
+    CN_ANCHOR* end() const { return m_end; }
+
+    size_t size() const
+    {
+        return m_end - m_begin;
+    }
+
+    bool empty() const
+    {
+        return m_begin == m_end;
+    }
+
+    CN_ANCHOR& operator[]( size_t aIndex ) const
+    {
+        return m_begin[aIndex];
+    }
+
+private:
+    CN_ANCHOR* m_begin;
+    CN_ANCHOR* m_end;
+};
 
 
 // basic connectivity item
-class CN_ITEM : public INTRUSIVE_LIST<CN_ITEM>
+class CN_ITEM
 {
 public:
-    using CONNECTED_ITEMS = std::set<CN_ITEM*>;
+    ///> sorted by address once the connection search is done, see SortConnections()
+    using CONNECTED_ITEMS = std::vector<CN_ITEM*>;
 
 private:
     BOARD_CONNECTED_ITEM* m_parent;
@@ -165,10 +263,20 @@ private:
     ///> list of items physically connected (touching)
     CONNECTED_ITEMS m_connected;
 
-    CN_ANCHORS m_anchors;
+    ///> true if items were connected since the last SortConnections() call
+    bool m_connectedUnsorted;
+
+    ///> anchors of the net the anchors of the item are stored in, see SetAnchors()
+    CN_NET_ANCHORS_PTR m_netAnchors;
+
+    ///> index of the first anchor of the item in m_netAnchors
+    int m_firstAnchor;
+
+    ///> number of anchors of the item
+    int m_anchorCount;
 
-    ///> visited flag for the BFS scan
-    bool m_visited;
+    ///> index of the item in the running cluster search, -1 if the search skips it
+    int m_searchIndex;
 
     ///> can the net propagator modify the netcode?
     bool m_canChangeNet;
@@ -196,23 +304,60 @@ public:
     {
         m_parent = aParent;
         m_canChangeNet = aCanChangeNet;
-        m_visited = false;
+        m_searchIndex = -1;
+        m_firstAnchor = 0;
+        m_anchorCount = 0;
         m_valid = true;
         m_dirty = true;
-        m_anchors.reserve( 2 );
+        m_connectedUnsorted = false;
         m_layers = LAYER_RANGE( 0, PCB_LAYER_ID_COUNT );
     }
 
-    virtual ~CN_ITEM() {};
+    virtual ~CN_ITEM()
+    {
+        removeAnchors();
+    }
+
+    /**
+     * Function SetAnchors()
+     *
+     * Sets the anchors of the item, appending them to the anchors of a net.  The previous
+     * anchors of the item are removed.
+     */
+    void SetAnchors( const CN_NET_ANCHORS_PTR& aNetAnchors, const VECTOR2I* aPositions,
+                     int aCount );
 
-    void AddAnchor( const VECTOR2I& aPos )
+    /**
+     * Function MoveAnchors()
+     *
+     * Moves the anchors of the item to the anchors of another net, or to the new array of
+     * anchors of its net.
+     */
+    void MoveAnchors( const CN_NET_ANCHORS_PTR& aNetAnchors );
+
+    const CN_NET_ANCHORS_PTR& NetAnchors() const
+    {
+        return m_netAnchors;
+    }
+
+    /**
+     * Function FirstAnchor()
+     *
+     * Returns the index of the first anchor of the item in NetAnchors().
+     */
+    int FirstAnchor() const
     {
-        m_anchors.emplace_back( std::make_unique<CN_ANCHOR>( aPos, this ) );
+        return m_firstAnchor;
     }
 
-    CN_ANCHORS& Anchors()
+    CN_ITEM_ANCHORS Anchors() const
     {
-        return m_anchors;
+        if( !m_anchorCount )
+            return CN_ITEM_ANCHORS();
+
+        CN_ANCHOR* first = &( *m_netAnchors )[m_firstAnchor];
+
+        return CN_ITEM_ANCHORS( first, first + m_anchorCount );
     }
 
     void SetValid( bool aValid )
@@ -298,16 +443,17 @@ public:
     void ClearConnections()
     {
         m_connected.clear();
+        m_connectedUnsorted = false;
     }
 
-    void SetVisited( bool aVisited )
+    void SetSearchIndex( int aIndex )
     {
-        m_visited = aVisited;
+        m_searchIndex = aIndex;
     }
 
-    bool Visited() const
+    int SearchIndex() const
     {
-        return m_visited;
+        return m_searchIndex;
     }
 
     bool CanChangeNet() const
@@ -318,15 +464,27 @@ public:
     void Connect( CN_ITEM* b )
     {
         std::lock_guard<std::mutex> lock( m_listLock );
-        m_connected.insert( b );
+        m_connected.push_back( b );
+        m_connectedUnsorted = true;
     }
 
+    /**
+     * Function SortConnections()
+     *
+     * Sorts the connected items and drops the duplicates, as an item may be found several
+     * times by the connection search.  Has to be called once the search is done.
+     */
+    void SortConnections();
+
     void RemoveInvalidRefs();
 
     virtual int             AnchorCount() const;
     virtual VECTOR2I  GetAnchor( int n ) const;
 
     int Net() const;
+
+private:
+    void removeAnchors();
 };
 
 typedef std::shared_ptr<CN_ITEM> CN_ITEM_PTR;
@@ -351,9 +509,9 @@ public:
         return m_subpolyIndex;
     }
 
-    bool ContainsAnchor( const CN_ANCHOR_PTR anchor ) const
+    bool ContainsAnchor( const CN_ANCHOR& aAnchor ) const
     {
-        return ContainsPoint( anchor->Pos() );
+        return ContainsPoint( aAnchor.Pos() );
     }
 
     bool ContainsPoint( const VECTOR2I p ) const
@@ -385,15 +543,23 @@ class CN_LIST
 private:
     bool m_dirty;
     bool m_hasInvalid;
+    bool m_bulkLoading;
 
     CN_RTREE<CN_ITEM*> m_index;
 
+    ///> anchors of the items, by net code, see netAnchors()
+    std::vector<CN_NET_ANCHORS_PTR> m_netAnchors;
+
 protected:
     std::vector<CN_ITEM*> m_items;
 
+    ///> returns the anchors of a net, the items without a net going with the net 0
+    const CN_NET_ANCHORS_PTR& netAnchors( int aNet );
+
     void addItemtoTree( CN_ITEM* item )
     {
-        m_index.Insert( item );
+        if( !m_bulkLoading )
+            m_index.Insert( item );
     }
 
 public:
@@ -401,6 +567,24 @@ public:
     {
         m_dirty = false;
         m_hasInvalid = false;
+        m_bulkLoading = false;
+    }
+
+    /**
+     * Items added between BeginBulkLoad() and EndBulkLoad() are indexed all at once by the
+     * latter, which builds a better tree, faster.  They cannot be searched for until then.
+     */
+    void BeginBulkLoad()
+    {
+        m_bulkLoading = true;
+    }
+
+    void EndBulkLoad()
+    {
+        // The items indexed before the bulk load are in m_items too, so the index is rebuilt
+        m_index.RemoveAll();
+        m_index.BulkLoad( m_items );
+        m_bulkLoading = false;
     }
 
     void Clear()
@@ -410,6 +594,7 @@ public:
 
         m_items.clear();
         m_index.RemoveAll();
+        m_netAnchors.clear();
     }
 
     using ITER = decltype(m_items)::iterator;
@@ -442,6 +627,19 @@ public:
 
     void RemoveInvalidItems( std::vector<CN_ITEM*>& aGarbage );
 
+    /**
+     * Function UpdateNetAnchors()
+     *
+     * Moves the anchors of the items whose net changed to the anchors of their new net, and
+     * the anchors of the nets having more removed anchors than valid ones to new arrays.
+     */
+    void UpdateNetAnchors();
+
+    const std::vector<CN_NET_ANCHORS_PTR>& NetAnchors() const
+    {
+        return m_netAnchors;
+    }
+
     void ClearDirtyFlags()
     {
         for( auto item : m_items )
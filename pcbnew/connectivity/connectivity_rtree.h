@@ -65,6 +65,28 @@ public:
         m_tree->Insert( mmin, mmax, aItem );
     }
 
+    /**
+     * Function BulkLoad()
+     * Inserts many items at once, building a packed tree which is faster to query than
+     * inserting them one by one.
+     */
+    void BulkLoad( const std::vector<T>& aItems )
+    {
+        std::vector<typename RTree<T, int, 3, double>::BulkItem> entries( aItems.size() );
+
+        for( size_t i = 0; i < aItems.size(); i++ )
+        {
+            const BOX2I&        bbox    = aItems[i]->BBox();
+            const LAYER_RANGE   layers  = aItems[i]->Layers();
+
+            entries[i] = { { layers.Start(), bbox.GetX(), bbox.GetY() },
+                           { layers.End(), bbox.GetRight(), bbox.GetBottom() },
+                           aItems[i] };
+        }
+
+        m_tree->BulkLoad( entries );
+    }
+
     /**
      * Function Remove()
      * Removes an item from the tree. Removal is done by comparing pointers, attempting
@@ -59,6 +59,14 @@ public:
      */
     void SetUnits( EDA_UNITS_T aUnits );
 
+    /**
+     * @return the units the markers are currently constructed with
+     */
+    EDA_UNITS_T GetUnits() const
+    {
+        return getCurrentUnits();
+    }
+
     /**
      * Creates a marker on a track, via or pad.
      *
@@ -0,0 +1,163 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef DRC_RTREE_H_
+#define DRC_RTREE_H_
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <eda_rect.h>
+#include <layers_id_colors_and_visibility.h>
+#include <geometry/rtree.h>
+
+
+/**
+ * Class DRC_RTREE -
+ * Implements a layer-aware R-tree used to restrict DRC tests to the items lying near a
+ * reference item.  Each copper layer has its own tree; an item spanning several layers
+ * is indexed in each of them.  Non-owning.
+ *
+ * The stored type must be ordered: query results are returned sorted and without
+ * duplicates, so indexing positions in a list gives results in list order.
+ */
+template< class T >
+class DRC_RTREE
+{
+public:
+    typedef RTree<T, int, 2, double> TREE;
+
+    DRC_RTREE() :
+        m_count( 0 )
+    {
+    }
+
+    /**
+     * Function Insert()
+     * Inserts an item with the given bounding box on each copper layer of aLayers.
+     */
+    void Insert( T aItem, const EDA_RECT& aBBox, const LSET& aLayers )
+    {
+        EDA_RECT  bbox = aBBox;
+        bbox.Normalize();
+
+        const int mmin[2] = { bbox.GetX(), bbox.GetY() };
+        const int mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
+
+        for( PCB_LAYER_ID layer : ( aLayers & LSET::AllCuMask() ).Seq() )
+        {
+            std::unique_ptr<TREE>& tree = m_trees[ layer ];
+
+            if( !tree )
+                tree.reset( new TREE() );
+
+            tree->Insert( mmin, mmax, aItem );
+        }
+
+        m_count++;
+    }
+
+    /**
+     * Function Remove()
+     * Removes an item inserted with the same bounding box and layers.
+     */
+    void Remove( T aItem, const EDA_RECT& aBBox, const LSET& aLayers )
+    {
+        EDA_RECT  bbox = aBBox;
+        bbox.Normalize();
+
+        const int mmin[2] = { bbox.GetX(), bbox.GetY() };
+        const int mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
+        bool      found = false;
+
+        for( PCB_LAYER_ID layer : ( aLayers & LSET::AllCuMask() ).Seq() )
+        {
+            // RTree::Remove() returns true when the item is not found
+            if( m_trees[ layer ] && !m_trees[ layer ]->Remove( mmin, mmax, aItem ) )
+                found = true;
+        }
+
+        if( found )
+            m_count--;
+    }
+
+    /**
+     * Function Query()
+     * Collects the items whose bounding box intersects aBounds on any copper layer of
+     * aLayers.  aResult is cleared first, and is returned sorted and free of duplicates.
+     */
+    void Query( const EDA_RECT& aBounds, const LSET& aLayers, std::vector<T>& aResult )
+    {
+        EDA_RECT  bbox = aBounds;
+        bbox.Normalize();
+
+        const int mmin[2] = { bbox.GetX(), bbox.GetY() };
+        const int mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
+
+        auto visitor = [&]( const T& aItem ) -> bool
+        {
+            aResult.push_back( aItem );
+            return true;
+        };
+
+        aResult.clear();
+
+        for( PCB_LAYER_ID layer : ( aLayers & LSET::AllCuMask() ).Seq() )
+        {
+            if( m_trees[ layer ] )
+                m_trees[ layer ]->Search( mmin, mmax, visitor );
+        }
+
+        std::sort( aResult.begin(), aResult.end() );
+        aResult.erase( std::unique( aResult.begin(), aResult.end() ), aResult.end() );
+    }
+
+    /**
+     * Function RemoveAll()
+     * Removes all items from the index.
+     */
+    void RemoveAll()
+    {
+        for( std::unique_ptr<TREE>& tree : m_trees )
+            tree.reset();
+
+        m_count = 0;
+    }
+
+    /**
+     * Function Size()
+     * @return the number of items inserted (counted once regardless of their layers).
+     */
+    int Size() const
+    {
+        return m_count;
+    }
+
+private:
+    std::unique_ptr<TREE> m_trees[MAX_CU_LAYERS];
+    int                   m_count;
+};
+
+
+#endif /* DRC_RTREE_H_ */
@@ -389,6 +389,8 @@ bool GENDRILL_WRITER_BASE::GenDrillReportFile( const wxString& aFullFileName )
     totalHoleCount = printToolSummary( out, true );
     out.Print( 0, "    Total unplated holes count %u\n", totalHoleCount );
 
+    out.Finish();
+
     return true;
 }
 
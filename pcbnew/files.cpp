@@ -344,6 +344,10 @@ IO_MGR::PCB_FILE_T plugin_type( const wxString& aFileName, int aCtl )
     {
         pluginType = IO_MGR::PCAD;
     }
+    else if( fn.GetExt().CmpNoCase(  IO_MGR::GetFileExtension( IO_MGR::KICAD_SNAPSHOT ) ) == 0 )
+    {
+        pluginType = IO_MGR::KICAD_SNAPSHOT;
+    }
     else
     {
         pluginType = IO_MGR::KICAD_SEXP;
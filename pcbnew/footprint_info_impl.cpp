@@ -26,6 +26,7 @@
 #include <common.h>
 #include <fctsys.h>
 #include <footprint_info.h>
+#include <fp_lib_index.h>
 #include <fp_lib_table.h>
 #include <html_messagebox.h>
 #include <io_mgr.h>
@@ -41,6 +42,8 @@
 #include <thread>
 #include <mutex>
 
+#include <wx/dir.h>
+
 
 void FOOTPRINT_INFO_IMPL::load()
 {
@@ -48,7 +51,19 @@ void FOOTPRINT_INFO_IMPL::load()
 
     wxASSERT( fptable );
 
-    const MODULE* footprint = fptable->GetEnumeratedFootprint( m_nickname, m_fpname );
+    const MODULE* footprint = NULL;
+
+    // The footprints of a library are parsed on demand, so a footprint file which cannot be
+    // parsed throws here rather than when enumerating the library.  It is listed like the
+    // footprints of a broken library: this runs on the FOOTPRINT_LIST workers, which must
+    // not throw.
+    try
+    {
+        footprint = fptable->GetEnumeratedFootprint( m_nickname, m_fpname );
+    }
+    catch( const IO_ERROR& )
+    {
+    }
 
     if( footprint == NULL ) // Should happen only with malformed/broken libraries
     {
@@ -239,14 +254,8 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
 
     size_t total_count = m_queue_out.size();
 
-    LOCALE_IO toggle_locale;
-
-    // Parse the footprints in parallel. WARNING! This requires changing the locale, which is
-    // GLOBAL. It is only threadsafe to construct the LOCALE_IO before the threads are created,
-    // destroy it after they finish, and block the main (GUI) thread while they work. Any deviation
-    // from this will cause nasal demons.
-    //
-    // TODO: blast LOCALE_IO into the sun
+    // Parse the footprints in parallel.  The parser reads numbers independently of the locale,
+    // so no LOCALE_IO is needed.
 
     SYNC_QUEUE<std::unique_ptr<FOOTPRINT_INFO>> queue_parsed;
     std::vector<std::thread>                    threads;
@@ -260,28 +269,19 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
             {
                 wxArrayString fpnames;
 
-                try
+                if( readLibraryIndex( nickname, queue_parsed ) )
                 {
-                    m_lib_table->FootprintEnumerate( fpnames, nickname );
-                }
-                catch( const IO_ERROR& ioe )
-                {
-                    m_errors.move_push( std::make_unique<IO_ERROR>( ioe ) );
-                }
-                catch( const std::exception& se )
-                {
-                    // This is a round about way to do this, but who knows what THROW_IO_ERROR()
-                    // may be tricked out to do someday, keep it in the game.
-                    try
-                    {
-                        THROW_IO_ERROR( se.what() );
-                    }
-                    catch( const IO_ERROR& ioe )
-                    {
-                        m_errors.move_push( std::make_unique<IO_ERROR>( ioe ) );
-                    }
+                    if( m_progress_reporter )
+                        m_progress_reporter->AdvanceProgress();
+
+                    m_count_finished.fetch_add( 1 );
+                    continue;
                 }
 
+                CatchErrors( [this, &nickname, &fpnames]() {
+                    m_lib_table->FootprintEnumerate( fpnames, nickname );
+                } );
+
                 for( unsigned jj = 0; jj < fpnames.size() && !m_cancelled; ++jj )
                 {
                     wxString fpname = fpnames[jj];
@@ -323,6 +323,43 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
 }
 
 
+bool FOOTPRINT_LIST_IMPL::readLibraryIndex( const wxString& aNickname,
+        SYNC_QUEUE<std::unique_ptr<FOOTPRINT_INFO>>& aQueue )
+{
+    const FP_LIB_TABLE_ROW* row = nullptr;
+
+    CatchErrors( [this, &aNickname, &row]() {
+        row = m_lib_table->FindRow( aNickname );
+    } );
+
+    // Only the KiCad plugin libraries are folders of one file per footprint
+    if( !row || IO_MGR::EnumFromStr( row->GetType() ) != IO_MGR::KICAD_SEXP )
+        return false;
+
+    wxString libraryPath = row->GetFullURI( true );
+
+    if( !wxDir::Exists( libraryPath ) )
+        return false;
+
+    FP_LIB_INDEX index( libraryPath, FP_LIB_INDEX::DefaultIndexFile( libraryPath ) );
+
+    // The footprints which could be parsed are indexed even if some could not
+    CatchErrors( [&index]() {
+        index.Update();
+    } );
+
+    for( const FP_LIB_INDEX::ENTRY& entry : index.GetEntries() )
+    {
+        auto* fpinfo = new FOOTPRINT_INFO_IMPL( aNickname, entry.m_name, entry.m_description,
+                                                entry.m_keywords, 0, entry.m_padCount,
+                                                entry.m_uniquePadCount );
+        aQueue.move_push( std::unique_ptr<FOOTPRINT_INFO>( fpinfo ) );
+    }
+
+    return true;
+}
+
+
 FOOTPRINT_LIST_IMPL::FOOTPRINT_LIST_IMPL() :
     m_loader( nullptr ),
     m_count_finished( 0 ),
@@ -113,6 +113,16 @@ protected:
      */
     void loader_job();
 
+    /**
+     * Queue the FOOTPRINT_INFOs of library \a aNickname from its FP_LIB_INDEX, which only
+     * parses the footprint files changed since the last time.
+     *
+     * @return false if the library is not a KiCad footprint folder, and must be enumerated
+     *         through its plugin.
+     */
+    bool readLibraryIndex( const wxString& aNickname,
+                           SYNC_QUEUE<std::unique_ptr<FOOTPRINT_INFO>>& aQueue );
+
 public:
     FOOTPRINT_LIST_IMPL();
     virtual ~FOOTPRINT_LIST_IMPL();
@@ -0,0 +1,318 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+
+#include <wx/datstrm.h>
+#include <wx/dir.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/wfstream.h>
+
+#include <fctsys.h>
+#include <common.h>
+#include <macros.h>
+#include <richio.h>
+#include <wildcards_and_files_ext.h>
+#include <class_module.h>
+#include <pcb_parser.h>
+#include <fp_lib_index.h>
+
+
+/// Bump this whenever the layout of the index file changes, older indexes are then rebuilt.
+#define FP_LIB_INDEX_VERSION    2
+
+/// First bytes of every index file.
+static const char indexMagic[] = { 'K', 'i', 'C', 'a', 'd', 'F', 'P', 'I' };
+
+
+FP_LIB_INDEX::FP_LIB_INDEX( const wxString& aLibraryPath, const wxString& aIndexFile ) :
+    m_libraryPath( aLibraryPath ),
+    m_indexFile( aIndexFile ),
+    m_parsedCount( 0 )
+{
+}
+
+
+wxString FP_LIB_INDEX::DefaultIndexFile( const wxString& aLibraryPath )
+{
+    // The library name keeps the folder readable, the hash of the full path makes it unique
+    wxArrayString dirs = wxFileName::DirName( aLibraryPath ).GetDirs();
+    size_t        hash = std::hash<std::string>{}( std::string( TO_UTF8( aLibraryPath ) ) );
+    wxFileName    fn( GetKicadConfigPath(), wxEmptyString );
+
+    fn.AppendDir( wxT( "fp-index" ) );
+    fn.SetName( wxString::Format( wxT( "%s-%016llx" ), dirs.IsEmpty() ? wxString() : dirs.Last(),
+                                  (unsigned long long) hash ) );
+    fn.SetExt( wxT( "idx" ) );
+
+    return fn.GetFullPath();
+}
+
+
+void FP_LIB_INDEX::Update()
+{
+    wxDir dir( m_libraryPath );
+
+    if( !dir.IsOpened() )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "Footprint library path \"%s\" does not exist" ),
+                                          m_libraryPath ) );
+    }
+
+    read();
+
+    std::map<wxString, ENTRY> indexed;
+
+    for( ENTRY& entry : m_entries )
+        indexed[entry.m_fileName] = std::move( entry );
+
+    for( ENTRY& entry : m_brokenEntries )
+        indexed[entry.m_fileName] = std::move( entry );
+
+    m_entries.clear();
+    m_brokenEntries.clear();
+    m_parsedCount = 0;
+
+    bool        modified = false;
+    wxString    cacheError;
+    wxString    fullName;
+    wxString    fileSpec = wxT( "*." ) + KiCadFootprintFileExtension;
+    PCB_PARSER  parser;
+
+    auto addError = [&cacheError]( const wxString& aError )
+    {
+        if( !cacheError.IsEmpty() )
+            cacheError += "\n\n";
+
+        cacheError += aError;
+    };
+
+    // wxFileName construction is egregiously slow.  Construct it once and just swap out
+    // the filename thereafter.
+    WX_FILENAME fn( m_libraryPath, wxT( "dummyName" ) );
+
+    if( dir.GetFirst( &fullName, fileSpec ) )
+    {
+        do
+        {
+            fn.SetFullName( fullName );
+
+            wxStructStat stat;
+
+            if( wxStat( fn.GetFullPath(), &stat ) != 0 )
+                continue;
+
+            auto it = indexed.find( fullName );
+
+            if( it != indexed.end() && it->second.m_mtime == (long long) stat.st_mtime
+                    && it->second.m_size == (long long) stat.st_size )
+            {
+                // A broken file is still reported, but not parsed again until it changes
+                if( it->second.m_error.IsEmpty() )
+                {
+                    m_entries.push_back( std::move( it->second ) );
+                }
+                else
+                {
+                    addError( it->second.m_error );
+                    m_brokenEntries.push_back( std::move( it->second ) );
+                }
+
+                indexed.erase( it );
+                continue;
+            }
+
+            modified = true;
+            ++m_parsedCount;
+
+            ENTRY entry;
+
+            entry.m_fileName = fullName;
+            entry.m_mtime = stat.st_mtime;
+            entry.m_size = stat.st_size;
+            entry.m_name = fn.GetName();
+            entry.m_padCount = 0;
+            entry.m_uniquePadCount = 0;
+
+            // Queue I/O errors, and index the files that fail to parse with their error
+            try
+            {
+                MMAP_LINE_READER reader( fn.GetFullPath() );
+
+                parser.SetLineReader( &reader );
+
+                std::unique_ptr<BOARD_ITEM> item( parser.Parse() );
+                MODULE*                     footprint = dynamic_cast<MODULE*>( item.get() );
+
+                if( !footprint )
+                {
+                    THROW_IO_ERROR( wxString::Format( _( "\"%s\" does not contain a footprint" ),
+                                                      fn.GetFullPath() ) );
+                }
+
+                entry.m_description = footprint->GetDescription();
+                entry.m_keywords = footprint->GetKeywords();
+                entry.m_padCount = footprint->GetPadCount( DO_NOT_INCLUDE_NPTH );
+                entry.m_uniquePadCount = footprint->GetUniquePadCount( DO_NOT_INCLUDE_NPTH );
+                entry.m_bbox = footprint->GetFootprintRect();
+
+                m_entries.push_back( std::move( entry ) );
+            }
+            catch( const IO_ERROR& ioe )
+            {
+                entry.m_error = ioe.What();
+                addError( entry.m_error );
+                m_brokenEntries.push_back( std::move( entry ) );
+            }
+        } while( dir.GetNext( &fullName ) );
+    }
+
+    // Whatever is left was removed from the library
+    if( modified || !indexed.empty() )
+        write();
+
+    if( !cacheError.IsEmpty() )
+        THROW_IO_ERROR( cacheError );
+}
+
+
+void FP_LIB_INDEX::read()
+{
+    m_entries.clear();
+    m_brokenEntries.clear();
+
+    if( !wxFileName::FileExists( m_indexFile ) )
+        return;
+
+    wxFileInputStream file( m_indexFile );
+    char              magic[sizeof( indexMagic )];
+
+    if( !file.IsOk() || file.Read( magic, sizeof( magic ) ).LastRead() != sizeof( magic )
+            || memcmp( magic, indexMagic, sizeof( magic ) ) != 0 )
+    {
+        return;
+    }
+
+    wxDataInputStream data( file );
+
+    if( data.Read32() != FP_LIB_INDEX_VERSION || data.ReadString() != m_libraryPath )
+        return;
+
+    wxUint32 count = data.Read32();
+
+    for( wxUint32 ii = 0; ii < count && file.GetLastError() == wxSTREAM_NO_ERROR; ++ii )
+    {
+        ENTRY entry;
+
+        entry.m_fileName = data.ReadString();
+        entry.m_mtime = data.Read64();
+        entry.m_size = data.Read64();
+        entry.m_name = data.ReadString();
+        entry.m_description = data.ReadString();
+        entry.m_keywords = data.ReadString();
+        entry.m_padCount = data.Read32();
+        entry.m_uniquePadCount = data.Read32();
+        entry.m_bbox.SetX( (wxInt32) data.Read32() );
+        entry.m_bbox.SetY( (wxInt32) data.Read32() );
+        entry.m_bbox.SetWidth( (wxInt32) data.Read32() );
+        entry.m_bbox.SetHeight( (wxInt32) data.Read32() );
+        entry.m_error = data.ReadString();
+
+        if( entry.m_error.IsEmpty() )
+            m_entries.push_back( std::move( entry ) );
+        else
+            m_brokenEntries.push_back( std::move( entry ) );
+    }
+
+    // A truncated index is as good as no index
+    if( file.GetLastError() != wxSTREAM_NO_ERROR )
+    {
+        m_entries.clear();
+        m_brokenEntries.clear();
+    }
+}
+
+
+void FP_LIB_INDEX::write() const
+{
+    wxFileName fn( m_indexFile );
+
+    if( !fn.DirExists() && !wxFileName::Mkdir( fn.GetPath(), wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL ) )
+        return;
+
+    // Write a temporary file first, so a concurrent reader never sees a partial index.  Its
+    // name is unique, as other instances may be writing the index of the same library.
+    wxString tempFile = wxFileName::CreateTempFileName( m_indexFile );
+
+    if( tempFile.IsEmpty() )
+        return;
+
+    {
+        wxFileOutputStream file( tempFile );
+
+        if( !file.IsOk() )
+            return;
+
+        wxDataOutputStream data( file );
+
+        file.Write( indexMagic, sizeof( indexMagic ) );
+        data.Write32( FP_LIB_INDEX_VERSION );
+        data.WriteString( m_libraryPath );
+        data.Write32( m_entries.size() + m_brokenEntries.size() );
+
+        auto writeEntry = [&data]( const ENTRY& aEntry )
+        {
+            data.WriteString( aEntry.m_fileName );
+            data.Write64( (wxUint64) aEntry.m_mtime );
+            data.Write64( (wxUint64) aEntry.m_size );
+            data.WriteString( aEntry.m_name );
+            data.WriteString( aEntry.m_description );
+            data.WriteString( aEntry.m_keywords );
+            data.Write32( aEntry.m_padCount );
+            data.Write32( aEntry.m_uniquePadCount );
+            data.Write32( (wxUint32) aEntry.m_bbox.GetX() );
+            data.Write32( (wxUint32) aEntry.m_bbox.GetY() );
+            data.Write32( (wxUint32) aEntry.m_bbox.GetWidth() );
+            data.Write32( (wxUint32) aEntry.m_bbox.GetHeight() );
+            data.WriteString( aEntry.m_error );
+        };
+
+        for( const ENTRY& entry : m_entries )
+            writeEntry( entry );
+
+        for( const ENTRY& entry : m_brokenEntries )
+            writeEntry( entry );
+
+        if( !file.Close() )
+        {
+            wxRemoveFile( tempFile );
+            return;
+        }
+    }
+
+    wxRenameFile( tempFile, m_indexFile, true );
+}
@@ -0,0 +1,106 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef FP_LIB_INDEX_H
+#define FP_LIB_INDEX_H
+
+#include <vector>
+
+#include <wx/string.h>
+
+#include <eda_rect.h>
+
+
+/**
+ * A persistent index of the footprints of a KiCad (.pretty) footprint library.
+ *
+ * The index holds what the footprint chooser needs to know about each footprint, along with
+ * the modification time and size of its file.  Update() only parses the files which were
+ * added or changed since the index was last written, so a library set where one file changed
+ * does not need to be reparsed as a whole.  The files which could not be parsed are kept in
+ * the index too, with their error, so they are not parsed again until they change.
+ *
+ * The index is only a cache: if it cannot be read or written, the library is parsed again.
+ */
+class FP_LIB_INDEX
+{
+public:
+    struct ENTRY
+    {
+        wxString  m_fileName;           ///< File name in the library, with its extension
+        long long m_mtime;              ///< Modification time of the file
+        long long m_size;               ///< Size of the file in bytes
+        wxString  m_name;               ///< Footprint name, which is the file name
+        wxString  m_description;
+        wxString  m_keywords;
+        unsigned  m_padCount;           ///< Number of pads, not counting NPTH
+        unsigned  m_uniquePadCount;     ///< Number of unique pad names, not counting NPTH
+        EDA_RECT  m_bbox;               ///< Footprint bounding box, as MODULE::GetFootprintRect()
+        wxString  m_error;              ///< Parse error of the file, empty if it was parsed
+    };
+
+    /**
+     * @param aLibraryPath is the path of the .pretty directory.
+     * @param aIndexFile is the file holding the index, see DefaultIndexFile().
+     */
+    FP_LIB_INDEX( const wxString& aLibraryPath, const wxString& aIndexFile );
+
+    /**
+     * @return the file where the index of \a aLibraryPath is kept, in the "fp-index" folder
+     *         of the KiCad configuration path.
+     */
+    static wxString DefaultIndexFile( const wxString& aLibraryPath );
+
+    /**
+     * Bring the index up to date with the library, parsing the new and modified footprint
+     * files, and write it back if anything changed.
+     *
+     * @throw IO_ERROR if the library cannot be read or some footprint files could not be
+     *        parsed, now or by a previous update.  The footprints which could be parsed are
+     *        still indexed.
+     */
+    void Update();
+
+    /// @return the entries of the footprints, without the files which could not be parsed.
+    const std::vector<ENTRY>& GetEntries() const { return m_entries; }
+
+    /// @return the number of footprint files parsed by the last Update().
+    int GetParsedCount() const { return m_parsedCount; }
+
+private:
+    /// Read the index file into m_entries and m_brokenEntries, leaving them empty if the file
+    /// is missing or invalid.
+    void read();
+
+    /// Write m_entries and m_brokenEntries to the index file.  Errors are ignored, it's only
+    /// a cache.
+    void write() const;
+
+    wxString           m_libraryPath;
+    wxString           m_indexFile;
+    std::vector<ENTRY> m_entries;
+    std::vector<ENTRY> m_brokenEntries;     ///< Files which could not be parsed
+    int                m_parsedCount;
+};
+
+#endif // FP_LIB_INDEX_H
@@ -58,6 +58,7 @@ public:
         EAGLE,
         PCAD,
         GEDA_PCB,       ///< Geda PCB file formats.
+        KICAD_SNAPSHOT, ///< Binary board snapshot, for autosaves and fast reloads.
 
         //N.B. This needs to be commented out to ensure compile-type errors
 #if defined(BUILD_GITHUB_PLUGIN)
@@ -415,6 +416,8 @@ public:
      * Function GetEnumeratedFootprint
      * a version of FootprintLoad() for use after FootprintEnumerate() for more efficient
      * cache management.
+     *
+     * The footprint is owned by the plugin, and may be released by any later call to it.
      */
     virtual const MODULE* GetEnumeratedFootprint( const wxString& aLibraryPath,
                                                   const wxString& aFootprintName,
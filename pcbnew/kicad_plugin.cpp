@@ -83,8 +83,11 @@ void filterNetClass( const BOARD& aBoard, NETCLASS& aNetClass )
  */
 class FP_CACHE_ITEM
 {
+    friend class FP_CACHE;
+
     WX_FILENAME             m_filename;
-    std::unique_ptr<MODULE> m_module;
+    std::unique_ptr<MODULE> m_module;       // NULL until parsed by FP_CACHE::GetModule()
+    unsigned long long      m_lastUse;      // FP_CACHE use count when last requested
 
 public:
     FP_CACHE_ITEM( MODULE* aModule, const WX_FILENAME& aFileName );
@@ -96,7 +99,8 @@ public:
 
 FP_CACHE_ITEM::FP_CACHE_ITEM( MODULE* aModule, const WX_FILENAME& aFileName ) :
     m_filename( aFileName ),
-    m_module( aModule )
+    m_module( aModule ),
+    m_lastUse( 0 )
 { }
 
 
@@ -116,6 +120,7 @@ class FP_CACHE
                                         // m_cache_timestamp against all the files.
     long long       m_cache_timestamp;  // A hash of the timestamps for all the footprint
                                         // files.
+    unsigned long long m_use_count;     // Number of GetModule() calls, for the LRU eviction.
 
 public:
     FP_CACHE( PCB_IO* aOwner, const wxString& aLibraryPath );
@@ -137,8 +142,25 @@ public:
      */
     void Save( MODULE* aModule = NULL );
 
+    /**
+     * Function Load
+     * enumerates the footprint files of the library.  The footprints themselves are only
+     * parsed when requested by GetModule().
+     */
     void Load();
 
+    /**
+     * Function GetModule
+     * returns the footprint \a aFootprintName, parsing its file if it is not loaded yet.
+     *
+     * At most #FP_CACHE_MAX_LOADED footprints are kept parsed: the least recently requested
+     * ones are released, so the returned footprint is only valid until the next call.
+     *
+     * @return the footprint, or NULL if the library has no such footprint.
+     * @throw IO_ERROR if the footprint file cannot be parsed.
+     */
+    const MODULE* GetModule( const wxString& aFootprintName );
+
     void Remove( const wxString& aFootprintName );
 
     /**
@@ -178,6 +200,7 @@ FP_CACHE::FP_CACHE( PCB_IO* aOwner, const wxString& aLibraryPath )
     m_lib_path.SetPath( aLibraryPath );
     m_cache_timestamp = 0;
     m_cache_dirty = true;
+    m_use_count = 0;
 }
 
 
@@ -202,6 +225,10 @@ void FP_CACHE::Save( MODULE* aModule )
         if( aModule && aModule != it->second->GetModule() )
             continue;
 
+        // A footprint which was never parsed is unchanged on disk
+        if( !it->second->GetModule() )
+            continue;
+
         WX_FILENAME fn = it->second->GetFileName();
 
         wxString tempFileName =
@@ -220,6 +247,7 @@ void FP_CACHE::Save( MODULE* aModule )
 
             m_owner->SetOutputFormatter( &formatter );
             m_owner->Format( (BOARD_ITEM*) it->second->GetModule() );
+            formatter.Finish();
         }
 
 #ifdef USE_TMP_FILE
@@ -273,39 +301,70 @@ void FP_CACHE::Load()
 
     if( dir.GetFirst( &fullName, fileSpec ) )
     {
-        wxString cacheError;
-
         do
         {
             fn.SetFullName( fullName );
 
-            // Queue I/O errors so only files that fail to parse don't get loaded.
-            try
-            {
-                FILE_LINE_READER    reader( fn.GetFullPath() );
+            m_modules.insert( fn.GetName(), new FP_CACHE_ITEM( nullptr, fn ) );
+            m_cache_timestamp += fn.GetTimestamp();
+        } while( dir.GetNext( &fullName ) );
+    }
+}
 
-                m_owner->m_parser->SetLineReader( &reader );
 
-                MODULE*     footprint = (MODULE*) m_owner->m_parser->Parse();
-                wxString    fpName = fn.GetName();
+const MODULE* FP_CACHE::GetModule( const wxString& aFootprintName )
+{
+    MODULE_ITER it = m_modules.find( aFootprintName );
 
-                footprint->SetFPID( LIB_ID( wxEmptyString, fpName ) );
-                m_modules.insert( fpName, new FP_CACHE_ITEM( footprint, fn ) );
+    if( it == m_modules.end() )
+        return NULL;
 
-                m_cache_timestamp += fn.GetTimestamp();
-            }
-            catch( const IO_ERROR& ioe )
-            {
-                if( !cacheError.IsEmpty() )
-                    cacheError += "\n\n";
+    FP_CACHE_ITEM* item = it->second;
 
-                cacheError += ioe.What();
-            }
-        } while( dir.GetNext( &fullName ) );
+    item->m_lastUse = ++m_use_count;
+
+    if( item->m_module )
+        return item->m_module.get();
+
+    // Make room for the new footprint by releasing the least recently used one.  Every parsed
+    // footprint is also on disk, as FootprintSave() writes its footprint immediately.
+    int            loaded = 0;
+    FP_CACHE_ITEM* oldest = NULL;
 
-        if( !cacheError.IsEmpty() )
-            THROW_IO_ERROR( cacheError );
+    for( MODULE_ITER ii = m_modules.begin();  ii != m_modules.end();  ++ii )
+    {
+        FP_CACHE_ITEM* candidate = ii->second;
+
+        if( !candidate->m_module )
+            continue;
+
+        ++loaded;
+
+        if( !oldest || candidate->m_lastUse < oldest->m_lastUse )
+            oldest = candidate;
     }
+
+    if( oldest && loaded >= FP_CACHE_MAX_LOADED )
+        oldest->m_module.reset();
+
+    MMAP_LINE_READER reader( item->m_filename.GetFullPath() );
+
+    m_owner->m_parser->SetLineReader( &reader );
+
+    std::unique_ptr<BOARD_ITEM> parsed( m_owner->m_parser->Parse() );
+    MODULE*                     footprint = dynamic_cast<MODULE*>( parsed.get() );
+
+    if( !footprint )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "\"%s\" does not contain a footprint" ),
+                                          item->m_filename.GetFullPath() ) );
+    }
+
+    parsed.release();
+    footprint->SetFPID( LIB_ID( wxEmptyString, aFootprintName ) );
+    item->m_module.reset( footprint );
+
+    return footprint;
 }
 
 
@@ -352,8 +411,6 @@ long long FP_CACHE::GetTimestamp( const wxString& aLibPath )
 
 void PCB_IO::Save( const wxString& aFileName, BOARD* aBoard, const PROPERTIES* aProperties )
 {
-    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
-
     init( aProperties );
 
     m_board = aBoard;       // after init()
@@ -371,6 +428,8 @@ void PCB_IO::Save( const wxString& aFileName, BOARD* aBoard, const PROPERTIES* a
     Format( aBoard, 1 );
 
     m_out->Print( 0, ")\n" );
+
+    formatter.Finish();
 }
 
 
@@ -398,8 +457,6 @@ BOARD_ITEM* PCB_IO::Parse( const wxString& aClipboardSourceInput )
 
 void PCB_IO::Format( BOARD_ITEM* aItem, int aNestLevel ) const
 {
-    LOCALE_IO   toggle;     // public API function, perform anything convenient for caller
-
     switch( aItem->Type() )
     {
     case PCB_T:
@@ -1844,7 +1901,7 @@ void PCB_IO::format( ZONE_CONTAINER* aZone, int aNestLevel ) const
     const SHAPE_POLY_SET& fv = aZone->GetFilledPolysList();
     newLine = 0;
 
-    if( !fv.IsEmpty() )
+    if( !fv.IsEmpty() && !( m_ctl & CTL_OMIT_ZONE_FILLS ) )
     {
         bool new_polygon = true;
         bool is_closed = false;
@@ -1936,7 +1993,7 @@ PCB_IO::~PCB_IO()
 
 BOARD* PCB_IO::Load( const wxString& aFileName, BOARD* aAppendToMe, const PROPERTIES* aProperties )
 {
-    FILE_LINE_READER    reader( aFileName );
+    MMAP_LINE_READER    reader( aFileName );
 
     init( aProperties );
 
@@ -2003,7 +2060,6 @@ void PCB_IO::FootprintEnumerate( wxArrayString&    aFootprintNames,
                                  const wxString&   aLibraryPath,
                                  const PROPERTIES* aProperties )
 {
-    LOCALE_IO     toggle;     // toggles on, then off, the C locale.
     wxDir         dir( aLibraryPath );
 
     init( aProperties );
@@ -2039,8 +2095,6 @@ const MODULE* PCB_IO::getFootprint( const wxString& aLibraryPath,
                                     const PROPERTIES* aProperties,
                                     bool checkModified )
 {
-    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
-
     init( aProperties );
 
     try
@@ -2052,16 +2106,7 @@ const MODULE* PCB_IO::getFootprint( const wxString& aLibraryPath,
         // do nothing with the error
     }
 
-    const MODULE_MAP& mods = m_cache->GetModules();
-
-    MODULE_CITER it = mods.find( aFootprintName );
-
-    if( it == mods.end() )
-    {
-        return NULL;
-    }
-
-    return it->second->GetModule();
+    return m_cache->GetModule( aFootprintName );
 }
 
 
@@ -2084,8 +2129,6 @@ MODULE* PCB_IO::FootprintLoad( const wxString& aLibraryPath, const wxString& aFo
 void PCB_IO::FootprintSave( const wxString& aLibraryPath, const MODULE* aFootprint,
                             const PROPERTIES* aProperties )
 {
-    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
-
     init( aProperties );
 
     // In this public PLUGIN API function, we can safely assume it was
@@ -2183,8 +2226,6 @@ void PCB_IO::FootprintSave( const wxString& aLibraryPath, const MODULE* aFootpri
 void PCB_IO::FootprintDelete( const wxString& aLibraryPath, const wxString& aFootprintName,
                               const PROPERTIES* aProperties )
 {
-    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
-
     init( aProperties );
 
     validateCache( aLibraryPath );
@@ -2214,8 +2255,6 @@ void PCB_IO::FootprintLibCreate( const wxString& aLibraryPath, const PROPERTIES*
                                           aLibraryPath.GetData() ) );
     }
 
-    LOCALE_IO   toggle;
-
     init( aProperties );
 
     delete m_cache;
@@ -2303,8 +2342,6 @@ bool PCB_IO::FootprintLibDelete( const wxString& aLibraryPath, const PROPERTIES*
 
 bool PCB_IO::IsFootprintLibWritable( const wxString& aLibraryPath )
 {
-    LOCALE_IO   toggle;
-
     init( NULL );
 
     validateCache( aLibraryPath );
@@ -60,6 +60,7 @@ class NETINFO_MAPPING;
 #define CTL_OMIT_AT                 (1 << 5)    ///< Omit position and rotation
                                                 // (always saved with potion 0,0 and rotation = 0 in library)
 //#define CTL_OMIT_HIDE             (1 << 6)    // found and defined in eda_text.h
+#define CTL_OMIT_ZONE_FILLS         (1 << 7)    ///< Omit filled polygons of zones (stored elsewhere)
 
 
 // common combinations of the above:
@@ -74,6 +75,9 @@ class NETINFO_MAPPING;
 /// a BOARD file underneath IO_MGR.
 #define CTL_FOR_BOARD               (CTL_OMIT_INITIAL_COMMENTS)
 
+/// Maximum number of parsed footprints kept by the footprint library cache of a PCB_IO.
+#define FP_CACHE_MAX_LOADED         100
+
 
 class DIMENSION;
 class EDGE_MODULE;
@@ -389,12 +389,31 @@ static inline long hexParse( const char* next, const char** out = NULL )
     return strtol( next, (char**) out, 16 );
 }
 
+/**
+ * Function vectorParse
+ * parses the three coordinates of a 3D shape vector, leaving the missing ones unchanged.
+ */
+static void vectorParse( const char* next, double* aX, double* aY, double* aZ )
+{
+    double* coords[] = { aX, aY, aZ };
+    char*   end;
+
+    for( double* coord : coords )
+    {
+        double value = StrToDouble( next, &end );
+
+        if( end == next )
+            break;
+
+        *coord = value;
+        next = end;
+    }
+}
+
 
 BOARD* LEGACY_PLUGIN::Load( const wxString& aFileName, BOARD* aAppendToMe,
         const PROPERTIES* aProperties )
 {
-    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
-
     init( aProperties );
 
     m_board = aAppendToMe ? aAppendToMe : new BOARD();
@@ -1095,7 +1114,7 @@ void LEGACY_PLUGIN::loadSETUP()
 
         else if( TESTLINE( "Pad2PasteClearanceRatio" ) )
         {
-            double ratio = atof( line + SZ( "Pad2PasteClearanceRatio" ) );
+            double ratio = StrToDouble( line + SZ( "Pad2PasteClearanceRatio" ) );
             bds.m_SolderPasteMarginRatio = ratio;
         }
 
@@ -1323,7 +1342,7 @@ void LEGACY_PLUGIN::loadMODULE( MODULE* aModule )
 
         else if( TESTLINE( ".SolderPasteRatio" ) )
         {
-            double tmp = atof( line + SZ( ".SolderPasteRatio" ) );
+            double tmp = StrToDouble( line + SZ( ".SolderPasteRatio" ) );
             // Due to a bug in dialog editor in Modedit, fixed in BZR version 3565
             // this parameter can be broken.
             // It should be >= -50% (no solder paste) and <= 0% (full area of the pad)
@@ -1572,7 +1591,7 @@ void LEGACY_PLUGIN::loadPAD( MODULE* aModule )
 
         else if( TESTLINE( ".SolderPasteRatio" ) )
         {
-            double tmp = atof( line + SZ( ".SolderPasteRatio" ) );
+            double tmp = StrToDouble( line + SZ( ".SolderPasteRatio" ) );
             pad->SetLocalSolderPasteMarginRatio( tmp );
         }
 
@@ -1892,26 +1911,26 @@ void LEGACY_PLUGIN::load3D( MODULE* aModule )
 
         else if( TESTLINE( "Sc" ) )     // Scale
         {
-            sscanf( line + SZ( "Sc" ), "%lf %lf %lf\n",
-                    &t3D.m_Scale.x,
-                    &t3D.m_Scale.y,
-                    &t3D.m_Scale.z );
+            vectorParse( line + SZ( "Sc" ),
+                         &t3D.m_Scale.x,
+                         &t3D.m_Scale.y,
+                         &t3D.m_Scale.z );
         }
 
         else if( TESTLINE( "Of" ) )     // Offset
         {
-            sscanf( line + SZ( "Of" ), "%lf %lf %lf\n",
-                    &t3D.m_Offset.x,
-                    &t3D.m_Offset.y,
-                    &t3D.m_Offset.z );
+            vectorParse( line + SZ( "Of" ),
+                         &t3D.m_Offset.x,
+                         &t3D.m_Offset.y,
+                         &t3D.m_Offset.z );
         }
 
         else if( TESTLINE( "Ro" ) )     // Rotation
         {
-            sscanf( line + SZ( "Ro" ), "%lf %lf %lf\n",
-                    &t3D.m_Rotation.x,
-                    &t3D.m_Rotation.y,
-                    &t3D.m_Rotation.z );
+            vectorParse( line + SZ( "Ro" ),
+                         &t3D.m_Rotation.x,
+                         &t3D.m_Rotation.y,
+                         &t3D.m_Rotation.z );
         }
 
         else if( TESTLINE( "$EndSHAPE3D" ) )
@@ -3019,7 +3038,7 @@ BIU LEGACY_PLUGIN::biuParse( const char* aValue, const char** nptrptr )
 
     errno = 0;
 
-    double fval = strtod( aValue, &nptr );
+    double fval = StrToDouble( aValue, &nptr );
 
     if( errno )
     {
@@ -3056,7 +3075,7 @@ double LEGACY_PLUGIN::degParse( const char* aValue, const char** nptrptr )
 
     errno = 0;
 
-    double fval = strtod( aValue, &nptr );
+    double fval = StrToDouble( aValue, &nptr );
 
     if( errno )
     {
@@ -3120,37 +3139,28 @@ void LEGACY_PLUGIN::SaveModule3D( const MODULE* me ) const
 
         fprintf( m_fp, "Na %s\n", EscapedUTF8( sM->m_Filename ).c_str() );
 
-        fprintf(m_fp,
 #if defined(DEBUG)
-            // use old formats for testing, just to verify compatibility
-            // using "diff", then switch to more concise form for release builds.
-                "Sc %lf %lf %lf\n",
+        // use old formats for testing, just to verify compatibility
+        // using "diff", then switch to more concise form for release builds.
+        const char* fmt = "%lf";
 #else
-            "Sc %.10g %.10g %.10g\n",
+        const char* fmt = "%.10g";
 #endif
-                sM->m_Scale.x,
-                sM->m_Scale.y,
-                sM->m_Scale.z );
 
-        fprintf(m_fp,
-#if defined(DEBUG)
-                "Of %lf %lf %lf\n",
-#else
-            "Of %.10g %.10g %.10g\n",
-#endif
-                sM->m_Offset.x,
-                sM->m_Offset.y,
-                sM->m_Offset.z );
+        fprintf( m_fp, "Sc %s %s %s\n",
+                 FormatDouble( fmt, sM->m_Scale.x ).c_str(),
+                 FormatDouble( fmt, sM->m_Scale.y ).c_str(),
+                 FormatDouble( fmt, sM->m_Scale.z ).c_str() );
 
-        fprintf(m_fp,
-#if defined(DEBUG)
-                "Ro %lf %lf %lf\n",
-#else
-            "Ro %.10g %.10g %.10g\n",
-#endif
-                sM->m_Rotation.x,
-                sM->m_Rotation.y,
-                sM->m_Rotation.z );
+        fprintf( m_fp, "Of %s %s %s\n",
+                 FormatDouble( fmt, sM->m_Offset.x ).c_str(),
+                 FormatDouble( fmt, sM->m_Offset.y ).c_str(),
+                 FormatDouble( fmt, sM->m_Offset.z ).c_str() );
+
+        fprintf( m_fp, "Ro %s %s %s\n",
+                 FormatDouble( fmt, sM->m_Rotation.x ).c_str(),
+                 FormatDouble( fmt, sM->m_Rotation.y ).c_str(),
+                 FormatDouble( fmt, sM->m_Rotation.z ).c_str() );
 
         fprintf( m_fp, "$EndSHAPE3D\n" );
 
@@ -3437,8 +3447,6 @@ void LEGACY_PLUGIN::FootprintEnumerate( wxArrayString&    aFootprintNames,
                                         const wxString&   aLibraryPath,
                                         const PROPERTIES* aProperties )
 {
-    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
-
     init( aProperties );
 
     cacheLib( aLibraryPath );
@@ -3455,8 +3463,6 @@ void LEGACY_PLUGIN::FootprintEnumerate( wxArrayString&    aFootprintNames,
 MODULE* LEGACY_PLUGIN::FootprintLoad( const wxString& aLibraryPath,
         const wxString& aFootprintName, const PROPERTIES* aProperties )
 {
-    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
-
     init( aProperties );
 
     cacheLib( aLibraryPath );
@@ -3511,8 +3517,6 @@ bool LEGACY_PLUGIN::IsFootprintLibWritable( const wxString& aLibraryPath )
 #if 0   // no support for 32 Cu layers in legacy format
     return false;
 #else
-    LOCALE_IO   toggle;
-
     init( NULL );
 
     cacheLib( aLibraryPath );
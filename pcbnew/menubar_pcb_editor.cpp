@@ -36,6 +36,7 @@
 #include <tool/selection_conditions.h>
 #include <tools/selection_tool.h>
 #include <tools/pcb_actions.h>
+#include <tools/drc.h>
 #include "help_common_strings.h"
 #include "pcbnew.h"
 #include "pcbnew_id.h"
@@ -440,6 +441,13 @@ void PCB_EDIT_FRAME::ReCreateMenuBar()
     inspectMenu->AddSeparator();
     inspectMenu->AddItem( PCB_ACTIONS::runDRC,               SELECTION_CONDITIONS::ShowAlways );
 
+    auto onlineDRCCondition = [ this ] ( const SELECTION& aSel ) {
+        DRC* drcTool = m_toolManager->GetTool<DRC>();
+        return drcTool && drcTool->IsOnlineDRC();
+    };
+
+    inspectMenu->AddCheckItem( PCB_ACTIONS::toggleOnlineDRC, onlineDRCCondition );
+
     inspectMenu->Resolve();
 
     //-- Tools menu ----------------------------------------------------------
@@ -215,6 +215,8 @@ void BOARD::SynchronizeNetsAndNetClasses()
     m_designSettings.SetCustomDiffPairWidth( defaultNetClass->GetDiffPairWidth() );
     m_designSettings.SetCustomDiffPairGap( defaultNetClass->GetDiffPairGap() );
     m_designSettings.SetCustomDiffPairViaGap( defaultNetClass->GetDiffPairViaGap() );
+
+    InvalidateClearanceResolver();
 }
 
 
@@ -133,6 +133,10 @@ void NETINFO_LIST::AppendNet( NETINFO_ITEM* aNewElement )
     // add an entry for fast look up by a net name using a map
     m_netNames.insert( std::make_pair( aNewElement->GetNetname(), aNewElement ) );
     m_netCodes.insert( std::make_pair( aNewElement->GetNet(), aNewElement ) );
+
+    // The clearances of the new net are resolved with the other ones
+    if( m_Parent )
+        m_Parent->InvalidateClearanceResolver();
 }
 
 
@@ -165,6 +165,9 @@ void PCB_DRAW_PANEL_GAL::DisplayBoard( BOARD* aBoard )
     if( m_worksheet )
         m_worksheet->SetFileName( TO_UTF8( aBoard->GetFileName() ) );
 
+    // Index the board items all at once
+    m_view->BeginBulkLoad();
+
     // Load drawings
     for( auto drawing : const_cast<BOARD*>(aBoard)->Drawings() )
         m_view->Add( drawing );
@@ -194,6 +197,8 @@ void PCB_DRAW_PANEL_GAL::DisplayBoard( BOARD* aBoard )
     // Ratsnest
     m_ratsnest = std::make_unique<KIGFX::RATSNEST_VIEWITEM>( aBoard->GetConnectivity() );
     m_view->Add( m_ratsnest.get() );
+
+    m_view->EndBulkLoad();
 }
 
 
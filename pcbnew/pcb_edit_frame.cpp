@@ -549,6 +549,9 @@ void PCB_EDIT_FRAME::DoShowBoardSetupDialog( const wxString& aInitialPage,
 
     if( dlg.ShowModal() == wxID_OK )
     {
+        // The panels edit the design settings of the board in place
+        GetBoard()->InvalidateClearanceResolver();
+
         SaveProjectSettings( false );
 
         UpdateUserInterface();
@@ -27,12 +27,19 @@
  * @brief Pcbnew s-expression file format parser implementation.
  */
 
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
+#include <exception>
+#include <mutex>
+
 #include <common.h>
 #include <confirm.h>
 #include <macros.h>
+#include <kicad_string.h>
 #include <trigo.h>
 #include <title_block.h>
+#include <thread_pool.h>
 
 #include <class_board.h>
 #include <class_dimension.h>
@@ -54,6 +61,13 @@
 using namespace PCB_KEYS_T;
 
 
+/// Thrown when a board item cannot be parsed in a worker thread, because the user must be
+/// asked or the board changed.  The board parser then parses it itself.
+struct MAIN_THREAD_NEEDED
+{
+};
+
+
 void PCB_PARSER::init()
 {
     m_showLegacyZoneWarning = true;
@@ -129,7 +143,7 @@ double PCB_PARSER::parseDouble()
 
     errno = 0;
 
-    double fval = strtod( CurText(), &tmp );
+    double fval = StrToDouble( CurText(), &tmp );
 
     if( errno )
     {
@@ -445,7 +459,6 @@ BOARD_ITEM* PCB_PARSER::Parse()
 {
     T               token;
     BOARD_ITEM*     item;
-    LOCALE_IO       toggle;
 
     // MODULEs can be prefixed with an initial block of single line comments and these
     // are kept for Format() so they round trip in s-expression form.  BOARDs might
@@ -498,7 +511,8 @@ BOARD* PCB_PARSER::parseBOARD()
 
 BOARD* PCB_PARSER::parseBOARD_unchecked()
 {
-    T token;
+    T                          token;
+    std::vector<DEFERRED_ITEM> deferredItems;
 
     parseHeader();
 
@@ -556,20 +570,17 @@ BOARD* PCB_PARSER::parseBOARD_unchecked()
             break;
 
         case T_module:
-            m_board->Add( parseMODULE(), ADD_APPEND );
-            break;
-
         case T_segment:
-            m_board->Add( parseTRACK(), ADD_INSERT );
-            break;
-
         case T_via:
-            m_board->Add( parseVIA(), ADD_INSERT );
-            break;
-
         case T_zone:
-            m_board->Add( parseZONE_CONTAINER(), ADD_APPEND );
+        {
+            // These items are independent of each other, and most of the board: they are
+            // parsed in parallel once the whole board is read
+            int lineNumber = CurLineNumber();
+
+            deferredItems.push_back( { ReadUnparsedList(), lineNumber, nullptr } );
             break;
+        }
 
         case T_target:
             m_board->Add( parsePCB_TARGET(), ADD_APPEND );
@@ -582,6 +593,8 @@ BOARD* PCB_PARSER::parseBOARD_unchecked()
         }
     }
 
+    parseDeferredItems( deferredItems );
+
     if( m_undefinedLayers.size() > 0 )
     {
         bool deleteItems;
@@ -665,6 +678,141 @@ BOARD* PCB_PARSER::parseBOARD_unchecked()
 }
 
 
+void PCB_PARSER::parseDeferredItems( std::vector<DEFERRED_ITEM>& aItems )
+{
+    THREAD_POOL& pool = THREAD_POOL::GetInstance();
+
+    // Chunks of items, for each parser to be set up once for several items
+    size_t chunkSize = std::max<size_t>( 1, aItems.size() / ( pool.GetParallelism() * 4 ) );
+    size_t chunkCount = ( aItems.size() + chunkSize - 1 ) / chunkSize;
+
+    const wxString&    source = CurSource();
+    std::mutex         mutex;
+    std::exception_ptr error;
+    size_t             errorIndex = aItems.size();
+    std::atomic<bool>  failed( false );
+
+    auto parse_lambda = [&]( size_t aChunk )
+    {
+        PCB_PARSER parser;
+        shareBoardSettings( parser, true );
+
+        size_t end = std::min( aItems.size(), ( aChunk + 1 ) * chunkSize );
+
+        for( size_t ii = aChunk * chunkSize; ii < end && !failed; ++ii )
+        {
+            try
+            {
+                aItems[ii].m_item = parser.parseDeferredItem( aItems[ii], source );
+            }
+            catch( const MAIN_THREAD_NEEDED& )
+            {
+                // Left to the board parser
+            }
+            catch( ... )
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+
+                // Report the first error of the file, as a sequential parse would
+                if( ii < errorIndex )
+                {
+                    error = std::current_exception();
+                    errorIndex = ii;
+                }
+
+                failed = true;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock( mutex );
+        m_undefinedLayers.insert( parser.m_undefinedLayers.begin(),
+                                  parser.m_undefinedLayers.end() );
+    };
+
+    pool.ParallelFor( chunkCount, parse_lambda );
+
+    // The remaining items are parsed, and all of them added to the board, in file order.
+    // A failure stops the chunks still running, so items before the failing one may be left
+    // unparsed: they are parsed here and the stored error is only thrown if none of them
+    // fails, which reports the first broken item of the file whatever the thread timing.
+    PCB_PARSER parser;
+    shareBoardSettings( parser, false );
+
+    for( size_t ii = 0; ii < aItems.size(); ++ii )
+    {
+        DEFERRED_ITEM& deferred = aItems[ii];
+
+        try
+        {
+            if( ii == errorIndex )
+                std::rethrow_exception( error );
+
+            if( !deferred.m_item )
+                deferred.m_item = parser.parseDeferredItem( deferred, source );
+        }
+        catch( ... )
+        {
+            for( size_t jj = ii; jj < aItems.size(); ++jj )
+                delete aItems[jj].m_item;
+
+            throw;
+        }
+
+        KICAD_T type = deferred.m_item->Type();
+
+        m_board->Add( deferred.m_item,
+                      type == PCB_TRACE_T || type == PCB_VIA_T ? ADD_INSERT : ADD_APPEND );
+    }
+
+    m_undefinedLayers.insert( parser.m_undefinedLayers.begin(), parser.m_undefinedLayers.end() );
+    m_netCodes = parser.m_netCodes;
+    m_showLegacyZoneWarning = parser.m_showLegacyZoneWarning;
+}
+
+
+BOARD_ITEM* PCB_PARSER::parseDeferredItem( const DEFERRED_ITEM& aItem, const wxString& aSource )
+{
+    // Line numbers start after the one given to the reader
+    STRING_LINE_READER reader( aItem.m_text, aSource, aItem.m_lineNumber - 1 );
+
+    SetLineReader( &reader );
+    NeedLEFT();
+
+    switch( NextTok() )
+    {
+    case T_module:
+        return parseMODULE();
+
+    case T_segment:
+        return parseTRACK();
+
+    case T_via:
+        return parseVIA();
+
+    case T_zone:
+        return parseZONE_CONTAINER();
+
+    default:
+        wxString err;
+        err.Printf( _( "Unknown token \"%s\"" ), GetChars( FromUTF8() ) );
+        THROW_PARSE_ERROR( err, CurSource(), CurLine(), CurLineNumber(), CurOffset() );
+    }
+}
+
+
+void PCB_PARSER::shareBoardSettings( PCB_PARSER& aParser, bool aInWorkerThread ) const
+{
+    aParser.m_board = m_board;
+    aParser.m_layerIndices = m_layerIndices;
+    aParser.m_layerMasks = m_layerMasks;
+    aParser.m_netCodes = m_netCodes;
+    aParser.m_tooRecent = m_tooRecent;
+    aParser.m_requiredVersion = m_requiredVersion;
+    aParser.m_showLegacyZoneWarning = m_showLegacyZoneWarning;
+    aParser.m_inWorkerThread = aInWorkerThread;
+}
+
+
 void PCB_PARSER::parseHeader()
 {
     wxCHECK_RET( CurTok() == T_kicad_pcb,
@@ -3204,6 +3352,10 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER()
 
                     if( token == T_segment )    // deprecated
                     {
+                        // The user is asked, and the board changed
+                        if( m_inWorkerThread )
+                            throw MAIN_THREAD_NEEDED();
+
                         // SEGMENT fill mode no longer supported.  Make sure user is OK with converting them.
                         if( m_showLegacyZoneWarning )
                         {
@@ -3450,6 +3602,10 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER()
     // Ensure the zone net name is valid, and matches the net code, for copper zones
     if( zone_has_net && ( zone->GetNet()->GetNetname() != netnameFromfile ) )
     {
+        // Fixing it changes the board
+        if( m_inWorkerThread )
+            throw MAIN_THREAD_NEEDED();
+
         // Can happens which old boards, with nonexistent nets ...
         // or after being edited by hand
         // We try to fix the mismatch.
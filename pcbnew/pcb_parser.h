@@ -77,6 +77,18 @@ class PCB_PARSER : public PCB_LEXER
 
     bool                m_showLegacyZoneWarning;
 
+    bool                m_inWorkerThread;   ///< parsing board items in a worker thread, which
+                                            ///< cannot ask the user nor change the board
+
+    /// A top level board item read as text by the first pass over a board, and parsed
+    /// in parallel with the others by the second one
+    struct DEFERRED_ITEM
+    {
+        std::string     m_text;             ///< the s-expression of the item
+        int             m_lineNumber;       ///< the line of the item keyword in the source
+        BOARD_ITEM*     m_item;             ///< the parsed item, NULL until then
+    };
+
     ///> Converts net code using the mapping table if available,
     ///> otherwise returns unchanged net code if < 0 or if is is out of range
     inline int getNetCode( int aNetCode )
@@ -154,6 +166,26 @@ class PCB_PARSER : public PCB_LEXER
      */
     BOARD*          parseBOARD_unchecked();
 
+    /**
+     * Function parseDeferredItems
+     * parses the board items read as text, in parallel, and adds them to the board in file
+     * order.  The items which need the user or a board change to be parsed are parsed
+     * again here, one at a time.
+     */
+    void            parseDeferredItems( std::vector<DEFERRED_ITEM>& aItems );
+
+    /**
+     * Function parseDeferredItem
+     * parses a board item read as text, with the settings set by shareBoardSettings().
+     */
+    BOARD_ITEM*     parseDeferredItem( const DEFERRED_ITEM& aItem, const wxString& aSource );
+
+    /**
+     * Function shareBoardSettings
+     * sets up \a aParser to parse items of the board being parsed by this parser.
+     */
+    void            shareBoardSettings( PCB_PARSER& aParser, bool aInWorkerThread ) const;
+
 
     /**
      * Function lookUpLayer
@@ -302,7 +334,8 @@ public:
 
     PCB_PARSER( LINE_READER* aReader = NULL ) :
         PCB_LEXER( aReader ),
-        m_board( 0 )
+        m_board( 0 ),
+        m_inWorkerThread( false )
     {
         init();
     }
@@ -90,6 +90,9 @@ bool PCB_EDIT_FRAME::LoadProjectSettings()
 
     bool rc = Prj().ConfigLoad( Kiface().KifaceSearch(), GROUP_PCB, GetProjectFileParameters() );
 
+    // The netclasses may have been read from the project file
+    GetBoard()->InvalidateClearanceResolver();
+
     // Load the page layout decr file, from the filename stored in
     // BASE_SCREEN::m_PageLayoutDescrFileName, read in config project file
     // If empty, or not existing, the default descr is loaded
@@ -40,10 +40,10 @@ using namespace std::placeholders;
 #include <algorithm>
 #include <limits>
 
-static uint64_t getDistance( const CN_ANCHOR_PTR& aNode1, const CN_ANCHOR_PTR& aNode2 )
+static uint64_t getDistance( const CN_ANCHOR& aNode1, const CN_ANCHOR& aNode2 )
 {
-    double  dx = ( aNode1->Pos().x - aNode2->Pos().x );
-    double  dy = ( aNode1->Pos().y - aNode2->Pos().y );
+    double  dx = ( aNode1.Pos().x - aNode2.Pos().x );
+    double  dy = ( aNode1.Pos().y - aNode2.Pos().y );
 
     return sqrt( dx * dx + dy * dy );
 }
@@ -56,7 +56,7 @@ static bool sortWeight( const CN_EDGE& aEdge1, const CN_EDGE& aEdge2 )
 
 
 static std::vector<CN_EDGE> kruskalMST( std::list<CN_EDGE>& aEdges,
-        std::vector<CN_ANCHOR_PTR>& aNodes )
+        CN_NET_ANCHORS& aAnchors, std::vector<int>& aNodes )
 {
     unsigned int    nodeNumber = aNodes.size();
     unsigned int    mstExpectedSize = nodeNumber - 1;
@@ -66,13 +66,13 @@ static std::vector<CN_EDGE> kruskalMST( std::list<CN_EDGE>& aEdges,
     // The output
     std::vector<CN_EDGE> mst;
 
-    // Set tags for marking cycles
-    std::unordered_map<CN_ANCHOR_PTR, int> tags;
+    // Set tags for marking cycles, by anchor index
+    std::vector<int> tags( aAnchors.Size(), -1 );
     unsigned int tag = 0;
 
-    for( auto& node : aNodes )
+    for( int node : aNodes )
     {
-        node->SetTag( tag );
+        aAnchors[node].SetTag( tag );
         tags[node] = tag++;
     }
 
@@ -90,8 +90,8 @@ static std::vector<CN_EDGE> kruskalMST( std::list<CN_EDGE>& aEdges,
         //printf("mstSize %d %d\n", mstSize, mstExpectedSize);
         auto& dt = aEdges.front();
 
-        int srcTag  = tags[dt.GetSourceNode()];
-        int trgTag  = tags[dt.GetTargetNode()];
+        int srcTag  = tags[dt.GetSourceIndex()];
+        int trgTag  = tags[dt.GetTargetIndex()];
 
         // Check if by adding this edge we are going to join two different forests
         if( srcTag != trgTag )
@@ -113,9 +113,10 @@ static std::vector<CN_EDGE> kruskalMST( std::list<CN_EDGE>& aEdges,
                 // Do a copy of edge, but make it RN_EDGE_MST. In contrary to RN_EDGE,
                 // RN_EDGE_MST saves both source and target node and does not require any other
                 // edges to exist for getting source/target nodes
-                CN_EDGE newEdge ( dt.GetSourceNode(), dt.GetTargetNode(), dt.GetWeight() );
+                CN_EDGE newEdge ( &aAnchors, dt.GetSourceIndex(), dt.GetTargetIndex(),
+                                  dt.GetWeight() );
 
-                assert( newEdge.GetSourceNode()->GetTag() != newEdge.GetTargetNode()->GetTag() );
+                assert( newEdge.GetSourceNode().GetTag() != newEdge.GetTargetNode().GetTag() );
                 assert( newEdge.GetWeight() > 0 );
 
                 mst.push_back( newEdge );
@@ -128,7 +129,7 @@ static std::vector<CN_EDGE> kruskalMST( std::list<CN_EDGE>& aEdges,
                 for( auto it = cycles[trgTag].begin(); it != cycles[trgTag].end(); ++it )
                 {
                     tags[aNodes[*it]] = srcTag;
-                    aNodes[*it]->SetTag( srcTag );
+                    aAnchors[aNodes[*it]].SetTag( srcTag );
                 }
 
                 // Processing a connection, decrease the expected size of the ratsnest MST
@@ -153,7 +154,18 @@ static std::vector<CN_EDGE> kruskalMST( std::list<CN_EDGE>& aEdges,
 class RN_NET::TRIANGULATOR_STATE
 {
 private:
-    std::vector<CN_ANCHOR_PTR>  m_allNodes;
+    ///> Nodes, indices in the anchors of the net
+    std::vector<int>            m_allNodes;
+
+    ///> Triangulation of the last Triangulate() call, kept so the next call only has to insert
+    ///> and remove the nodes which moved.  Its enclosing rectangle is never removed.
+    std::unique_ptr<hed::TRIANGULATION> m_triangulation;
+
+    ///> Nodes of m_triangulation, in the order of Triangulate()
+    std::vector<hed::NODE_PTR>  m_triangulatedNodes;
+
+    ///> Enclosing rectangle of m_triangulation
+    int m_xmin, m_ymin, m_xmax, m_ymax;
 
     std::list<hed::EDGE_PTR> hedTriangulation( std::vector<hed::NODE_PTR>& aNodes )
     {
@@ -189,64 +201,208 @@ private:
         return true;
     }
 
+
+    static bool positionLess( const hed::NODE_PTR& aNode1, const hed::NODE_PTR& aNode2 )
+    {
+        if( aNode1->GetY() != aNode2->GetY() )
+            return aNode1->GetY() < aNode2->GetY();
+
+        return aNode1->GetX() < aNode2->GetX();
+    }
+
+
+    bool isEnclosingCorner( const hed::NODE_PTR& aNode ) const
+    {
+        // The nodes of the net lie strictly inside the enclosing rectangle
+        return aNode->GetX() == m_xmin || aNode->GetX() == m_xmax;
+    }
+
+
+    /**
+     * The edges of the triangulation with the rectangle corners contain the Euclidean minimum
+     * spanning tree of the nodes as long as no corner lies in the circle having two nodes as
+     * diameter.  This holds when the rectangle encloses the bounding box of the nodes grown by
+     * its larger side.
+     */
+    bool enclosesWithMargin( int64_t aXmin, int64_t aYmin, int64_t aXmax, int64_t aYmax ) const
+    {
+        int64_t margin = std::max( aXmax - aXmin, aYmax - aYmin ) + 1;
+
+        return m_xmin < aXmin - margin && m_ymin < aYmin - margin
+                && m_xmax > aXmax + margin && m_ymax > aYmax + margin;
+    }
+
+
+    /**
+     * Brings m_triangulation up to date with \a aNodes, which are sorted by positionLess().
+     * Unless too many nodes changed, the nodes which were already triangulated are kept and
+     * replace their copy in \a aNodes, the new ones are inserted and the missing ones removed.
+     * @return false if the nodes are too far apart for a triangulation with a rectangle.
+     */
+    bool updateTriangulation( std::vector<hed::NODE_PTR>& aNodes )
+    {
+        int64_t xmin = std::numeric_limits<int>::max();
+        int64_t ymin = std::numeric_limits<int>::max();
+        int64_t xmax = std::numeric_limits<int>::min();
+        int64_t ymax = std::numeric_limits<int>::min();
+
+        for( const auto& node : aNodes )
+        {
+            xmin = std::min<int64_t>( xmin, node->GetX() );
+            ymin = std::min<int64_t>( ymin, node->GetY() );
+            xmax = std::max<int64_t>( xmax, node->GetX() );
+            ymax = std::max<int64_t>( ymax, node->GetY() );
+        }
+
+        if( m_triangulation && enclosesWithMargin( xmin, ymin, xmax, ymax ) )
+        {
+            std::vector<hed::NODE_PTR> added;
+            std::vector<hed::NODE_PTR> removed;
+            auto                       prev = m_triangulatedNodes.begin();
+
+            for( auto& node : aNodes )
+            {
+                while( prev != m_triangulatedNodes.end() && positionLess( *prev, node ) )
+                    removed.push_back( *prev++ );
+
+                if( prev != m_triangulatedNodes.end() && !positionLess( node, *prev ) )
+                {
+                    ( *prev )->SetId( node->Id() );
+                    node = *prev++;
+                }
+                else
+                {
+                    added.push_back( node );
+                }
+            }
+
+            removed.insert( removed.end(), prev, m_triangulatedNodes.end() );
+
+            // Each change walks through the triangulation, past this a rebuild is faster
+            size_t maxChanges = std::max<size_t>( 16, sqrt( (double) aNodes.size() ) );
+
+            if( added.size() + removed.size() <= maxChanges )
+            {
+                bool ok = true;
+
+                // Moved items leave nodes close to the new ones, inserting first keeps the walks
+                // of the removals short
+                for( const auto& node : added )
+                    ok = ok && m_triangulation->InsertNode( node );
+
+                for( const auto& node : removed )
+                    ok = ok && m_triangulation->RemoveNode( node );
+
+                if( ok )
+                {
+                    m_triangulatedNodes = aNodes;
+                    return true;
+                }
+            }
+        }
+
+        // Leave room for the nodes to move before the next rebuild
+        int64_t margin = 3 * ( std::max( xmax - xmin, ymax - ymin ) + 1 );
+
+        if( xmin - margin < std::numeric_limits<int>::min()
+                || ymin - margin < std::numeric_limits<int>::min()
+                || xmax + margin > std::numeric_limits<int>::max()
+                || ymax + margin > std::numeric_limits<int>::max() )
+        {
+            Reset();
+            return false;
+        }
+
+        m_xmin = xmin - margin;
+        m_ymin = ymin - margin;
+        m_xmax = xmax + margin;
+        m_ymax = ymax + margin;
+
+        if( !m_triangulation )
+            m_triangulation.reset( new hed::TRIANGULATION );
+
+        m_triangulation->CreateDelaunay( aNodes.begin(), aNodes.end(),
+                                         m_xmin, m_ymin, m_xmax, m_ymax );
+        m_triangulatedNodes = aNodes;
+
+        return true;
+    }
+
 public:
 
+    TRIANGULATOR_STATE() :
+        m_xmin( 0 ), m_ymin( 0 ), m_xmax( 0 ), m_ymax( 0 )
+    {
+    }
+
     void Clear()
     {
         m_allNodes.clear();
     }
 
-    void AddNode( CN_ANCHOR_PTR aNode )
+    ///> Forgets the triangulation kept for the next Triangulate() call.
+    void Reset()
+    {
+        m_triangulation.reset();
+        m_triangulatedNodes.clear();
+    }
+
+    void AddNode( int aNode )
     {
         m_allNodes.push_back( aNode );
     }
 
-    std::list<CN_EDGE> Triangulate()
+    std::list<CN_EDGE> Triangulate( CN_NET_ANCHORS& aAnchors )
     {
         std::list<CN_EDGE> mstEdges;
         std::list<hed::EDGE_PTR> triangEdges;
         std::vector<hed::NODE_PTR> triNodes;
 
-        using ANCHOR_LIST = std::vector<CN_ANCHOR_PTR>;
+        using ANCHOR_LIST = std::vector<int>;
         std::vector<ANCHOR_LIST> anchorChains;
 
         triNodes.reserve( m_allNodes.size() );
         anchorChains.reserve( m_allNodes.size() );
 
         std::sort( m_allNodes.begin(), m_allNodes.end(),
-                [] ( const CN_ANCHOR_PTR& aNode1, const CN_ANCHOR_PTR& aNode2 )
+                [&aAnchors] ( int aNode1, int aNode2 )
         {
-            if( aNode1->Pos().y < aNode2->Pos().y )
+            const VECTOR2I& pos1 = aAnchors[aNode1].Pos();
+            const VECTOR2I& pos2 = aAnchors[aNode2].Pos();
+
+            if( pos1.y < pos2.y )
                 return true;
-            else if( aNode1->Pos().y == aNode2->Pos().y )
+            else if( pos1.y == pos2.y )
             {
-                return aNode1->Pos().x < aNode2->Pos().x;
+                return pos1.x < pos2.x;
             }
 
             return false;
         }
                 );
 
-        CN_ANCHOR_PTR prev, last;
+        const CN_ANCHOR* prev = nullptr;
         int id = 0;
 
-        for( auto n : m_allNodes )
+        for( size_t i = 0; i < m_allNodes.size(); i++ )
         {
             anchorChains.push_back( ANCHOR_LIST() );
         }
 
-        for( auto n : m_allNodes )
+        for( int n : m_allNodes )
         {
-            if( !prev || prev->Pos() != n->Pos() )
+            const CN_ANCHOR& anchor = aAnchors[n];
+
+            if( !prev || prev->Pos() != anchor.Pos() )
             {
-                auto tn = std::make_shared<hed::NODE> ( n->Pos().x, n->Pos().y );
+                auto tn = std::make_shared<hed::NODE> ( anchor.Pos().x, anchor.Pos().y );
 
                 tn->SetId( id );
                 triNodes.push_back( tn );
             }
 
             id++;
-            prev = n;
+            prev = &anchor;
         }
 
         int prevId = 0;
@@ -264,18 +420,41 @@ public:
 
         if( triNodes.size() == 1 )
         {
+            Reset();
             return mstEdges;
         }
         else if( areNodesColinear( triNodes ) )
         {
+            Reset();
+
             // special case: all nodes are on the same line - there's no
             // triangulation for such set. In this case, we sort along any coordinate
             // and chain the nodes together.
             for(int i = 0; i < (int)triNodes.size() - 1; i++ )
             {
-                auto src = m_allNodes[ triNodes[i]->Id() ];
-                auto dst = m_allNodes[ triNodes[i + 1]->Id() ];
-                mstEdges.emplace_back( src, dst, getDistance( src, dst ) );
+                int src = m_allNodes[ triNodes[i]->Id() ];
+                int dst = m_allNodes[ triNodes[i + 1]->Id() ];
+                mstEdges.emplace_back( &aAnchors, src, dst,
+                                       getDistance( aAnchors[src], aAnchors[dst] ) );
+            }
+        }
+        else if( updateTriangulation( triNodes ) )
+        {
+            m_triangulation->GetEdges( triangEdges );
+
+            for( auto e : triangEdges )
+            {
+                if( isEnclosingCorner( e->GetSourceNode() )
+                        || isEnclosingCorner( e->GetTargetNode() ) )
+                {
+                    continue;
+                }
+
+                int     src = m_allNodes[ e->GetSourceNode()->Id() ];
+                int     dst = m_allNodes[ e->GetTargetNode()->Id() ];
+
+                mstEdges.emplace_back( &aAnchors, src, dst,
+                                       getDistance( aAnchors[src], aAnchors[dst] ) );
             }
         }
         else
@@ -286,10 +465,11 @@ public:
 
             for( auto e : triangEdges )
             {
-                auto    src = m_allNodes[ e->GetSourceNode()->Id() ];
-                auto    dst = m_allNodes[ e->GetTargetNode()->Id() ];
+                int     src = m_allNodes[ e->GetSourceNode()->Id() ];
+                int     dst = m_allNodes[ e->GetTargetNode()->Id() ];
 
-                mstEdges.emplace_back( src, dst, getDistance( src, dst ) );
+                mstEdges.emplace_back( &aAnchors, src, dst,
+                                       getDistance( aAnchors[src], aAnchors[dst] ) );
             }
         }
 
@@ -301,16 +481,17 @@ public:
                 continue;
 
             std::sort( chain.begin(), chain.end(),
-                    [] ( const CN_ANCHOR_PTR& a, const CN_ANCHOR_PTR& b ) {
-                return a->GetCluster().get() < b->GetCluster().get();
+                    [&aAnchors] ( int a, int b ) {
+                return aAnchors[a].GetCluster().get() < aAnchors[b].GetCluster().get();
             } );
 
             for( unsigned int j = 1; j < chain.size(); j++ )
             {
-                const auto& prevNode    = chain[j - 1];
-                const auto& curNode     = chain[j];
-                int weight = prevNode->GetCluster() != curNode->GetCluster() ? 1 : 0;
-                mstEdges.push_back( CN_EDGE ( prevNode, curNode, weight ) );
+                int prevNode    = chain[j - 1];
+                int curNode     = chain[j];
+                int weight = aAnchors[prevNode].GetCluster() != aAnchors[curNode].GetCluster()
+                                     ? 1 : 0;
+                mstEdges.push_back( CN_EDGE ( &aAnchors, prevNode, curNode, weight ) );
             }
         }
 
@@ -319,6 +500,81 @@ public:
 };
 
 
+RN_NODE_TREE::RN_NODE_TREE( std::vector<NODE> aNodes ) :
+    m_nodes( std::move( aNodes ) )
+{
+    build( 0, m_nodes.size(), true );
+}
+
+
+void RN_NODE_TREE::build( size_t aBegin, size_t aEnd, bool aSplitX )
+{
+    if( aEnd - aBegin < 2 )
+        return;
+
+    size_t median = aBegin + ( aEnd - aBegin ) / 2;
+
+    std::nth_element( m_nodes.begin() + aBegin, m_nodes.begin() + median,
+                      m_nodes.begin() + aEnd,
+                      [aSplitX]( const NODE& aNode1, const NODE& aNode2 )
+                      {
+                          return aSplitX ? aNode1.m_pos.x < aNode2.m_pos.x
+                                         : aNode1.m_pos.y < aNode2.m_pos.y;
+                      } );
+
+    build( aBegin, median, !aSplitX );
+    build( median + 1, aEnd, !aSplitX );
+}
+
+
+int RN_NODE_TREE::Nearest( const VECTOR2I& aPos, VECTOR2I::extended_type& aSquaredDist ) const
+{
+    size_t best = m_nodes.size();
+
+    aSquaredDist = VECTOR2I::ECOORD_MAX;
+    nearest( 0, m_nodes.size(), true, aPos, best, aSquaredDist );
+
+    return best < m_nodes.size() ? m_nodes[best].m_index : -1;
+}
+
+
+void RN_NODE_TREE::nearest( size_t aBegin, size_t aEnd, bool aSplitX, const VECTOR2I& aPos,
+                            size_t& aBest, VECTOR2I::extended_type& aBestDist ) const
+{
+    if( aBegin >= aEnd )
+        return;
+
+    size_t          median = aBegin + ( aEnd - aBegin ) / 2;
+    const VECTOR2I& pos = m_nodes[median].m_pos;
+    auto            squaredDist = ( pos - aPos ).SquaredEuclideanNorm();
+
+    if( squaredDist < aBestDist )
+    {
+        aBest = median;
+        aBestDist = squaredDist;
+    }
+
+    VECTOR2I::extended_type delta = aSplitX ? (VECTOR2I::extended_type) aPos.x - pos.x
+                                            : (VECTOR2I::extended_type) aPos.y - pos.y;
+
+    // Search the side of the point first, the other one only if it may hold a closer node
+    if( delta < 0 )
+    {
+        nearest( aBegin, median, !aSplitX, aPos, aBest, aBestDist );
+
+        if( delta * delta < aBestDist )
+            nearest( median + 1, aEnd, !aSplitX, aPos, aBest, aBestDist );
+    }
+    else
+    {
+        nearest( median + 1, aEnd, !aSplitX, aPos, aBest, aBestDist );
+
+        if( delta * delta < aBestDist )
+            nearest( aBegin, median, !aSplitX, aPos, aBest, aBestDist );
+    }
+}
+
+
 RN_NET::RN_NET() : m_dirty( true )
 {
     m_triangulator.reset( new TRIANGULATOR_STATE );
@@ -336,20 +592,18 @@ void RN_NET::compute()
         // Check if the only possible connection exists
         if( m_boardEdges.size() == 0 && m_nodes.size() == 2 )
         {
-            auto last = ++m_nodes.begin();
-
             // There can be only one possible connection, but it is missing
-            CN_EDGE edge (*m_nodes.begin(), *last );
-            edge.GetSourceNode()->SetTag( 0 );
-            edge.GetTargetNode()->SetTag( 1 );
+            CN_EDGE edge ( m_anchors.get(), m_nodes[0], m_nodes[1] );
+            edge.GetSourceNode().SetTag( 0 );
+            edge.GetTargetNode().SetTag( 1 );
 
             m_rnEdges.push_back( edge );
         }
         else
         {
             // Set tags to m_nodes as connected
-            for( auto node : m_nodes )
-                node->SetTag( 0 );
+            for( int node : m_nodes )
+                ( *m_anchors )[node].SetTag( 0 );
         }
 
         return;
@@ -358,7 +612,7 @@ void RN_NET::compute()
 
     m_triangulator->Clear();
 
-    for( auto n : m_nodes )
+    for( int n : m_nodes )
     {
         m_triangulator->AddNode( n );
     }
@@ -366,7 +620,7 @@ void RN_NET::compute()
     #ifdef PROFILE
     PROF_COUNTER cnt("triangulate");
     #endif
-    auto triangEdges = m_triangulator->Triangulate();
+    auto triangEdges = m_triangulator->Triangulate( *m_anchors );
     #ifdef PROFILE
     cnt.Show();
     #endif
@@ -378,7 +632,7 @@ void RN_NET::compute()
 #ifdef PROFILE
     PROF_COUNTER cnt2("mst");
 #endif
-    m_rnEdges = kruskalMST( triangEdges, m_nodes );
+    m_rnEdges = kruskalMST( triangEdges, *m_anchors, m_nodes );
 #ifdef PROFILE
     cnt2.Show();
 #endif
@@ -399,6 +653,8 @@ void RN_NET::Clear()
     m_rnEdges.clear();
     m_boardEdges.clear();
     m_nodes.clear();
+    m_anchors.reset();
+    m_nodeTree.reset();
 
     m_dirty = true;
 }
@@ -406,52 +662,88 @@ void RN_NET::Clear()
 
 void RN_NET::AddCluster( CN_CLUSTER_PTR aCluster )
 {
-    CN_ANCHOR_PTR firstAnchor;
+    int firstAnchor = -1;
+
+    m_nodeTree.reset();
 
     for( auto item : *aCluster )
     {
         bool isZone = dynamic_cast<CN_ZONE*>(item) != nullptr;
-        auto& anchors = item->Anchors();
+        auto anchors = item->Anchors();
         unsigned int nAnchors = isZone ? 1 : anchors.size();
 
         if( nAnchors > anchors.size() )
             nAnchors = anchors.size();
 
+        if( !nAnchors )
+            continue;
+
+        // The anchors of the items of a net are stored together, see CN_LIST::UpdateNetAnchors()
+        if( !m_anchors )
+            m_anchors = item->NetAnchors();
+
+        if( item->NetAnchors() != m_anchors )
+        {
+            assert( false );
+            continue;
+        }
+
         for( unsigned int i = 0; i < nAnchors; i++ )
         {
-            anchors[i]->SetCluster( aCluster );
-            m_nodes.push_back(anchors[i]);
+            int anchor = item->FirstAnchor() + i;
+
+            anchors[i].SetCluster( aCluster );
+            m_nodes.push_back( anchor );
 
-            if( firstAnchor )
+            if( firstAnchor >= 0 )
             {
-                if( firstAnchor != anchors[i] )
+                if( firstAnchor != anchor )
                 {
-                    m_boardEdges.emplace_back( firstAnchor, anchors[i], 0 );
+                    m_boardEdges.emplace_back( m_anchors.get(), firstAnchor, anchor, 0 );
                 }
             }
             else
             {
-                firstAnchor = anchors[i];
+                firstAnchor = anchor;
             }
         }
     }
 }
 
 
-bool RN_NET::NearestBicoloredPair( const RN_NET& aOtherNet, CN_ANCHOR_PTR& aNode1,
-        CN_ANCHOR_PTR& aNode2 ) const
+bool RN_NET::NearestBicoloredPair( const RN_NET& aOtherNet, int& aNode1, int& aNode2 ) const
 {
     bool rv = false;
 
     VECTOR2I::extended_type distMax = VECTOR2I::ECOORD_MAX;
 
-    for( auto nodeA : m_nodes )
+    if( m_nodeTree )
     {
-        for( auto nodeB : aOtherNet.m_nodes )
+        for( int nodeB : aOtherNet.m_nodes )
         {
-            if( !nodeA->GetNoLine() )
+            VECTOR2I::extended_type squaredDist;
+            int nodeA = m_nodeTree->Nearest( aOtherNet.GetNode( nodeB ).Pos(), squaredDist );
+
+            if( nodeA >= 0 && squaredDist < distMax )
             {
-                auto squaredDist = (nodeA->Pos() - nodeB->Pos() ).SquaredEuclideanNorm();
+                rv = true;
+                distMax = squaredDist;
+                aNode1  = nodeA;
+                aNode2  = nodeB;
+            }
+        }
+
+        return rv;
+    }
+
+    for( int nodeA : m_nodes )
+    {
+        for( int nodeB : aOtherNet.m_nodes )
+        {
+            if( !GetNode( nodeA ).GetNoLine() )
+            {
+                auto squaredDist = ( GetNode( nodeA ).Pos() - aOtherNet.GetNode( nodeB ).Pos() )
+                                           .SquaredEuclideanNorm();
 
                 if( squaredDist < distMax )
                 {
@@ -468,6 +760,22 @@ bool RN_NET::NearestBicoloredPair( const RN_NET& aOtherNet, CN_ANCHOR_PTR& aNode
 }
 
 
+void RN_NET::BuildNodeTree()
+{
+    std::vector<RN_NODE_TREE::NODE> nodes;
+
+    nodes.reserve( m_nodes.size() );
+
+    for( int node : m_nodes )
+    {
+        if( !GetNode( node ).GetNoLine() )
+            nodes.push_back( { GetNode( node ).Pos(), node } );
+    }
+
+    m_nodeTree.reset( new RN_NODE_TREE( std::move( nodes ) ) );
+}
+
+
 void RN_NET::SetVisible( bool aEnabled )
 {
     for( auto& edge : m_rnEdges )
@@ -52,6 +52,48 @@ struct RN_NODE_OR_FILTER;
 struct RN_NODE_AND_FILTER;
 
 
+/**
+ * Class RN_NODE_TREE
+ * A 2d-tree of ratsnest nodes, finding the node closest to a point in logarithmic time.
+ */
+class RN_NODE_TREE
+{
+public:
+    ///> A node, the position of an anchor and its index in the anchors of its net
+    struct NODE
+    {
+        VECTOR2I m_pos;
+        int      m_index;
+    };
+
+    RN_NODE_TREE( std::vector<NODE> aNodes );
+
+    bool Empty() const
+    {
+        return m_nodes.empty();
+    }
+
+    /**
+     * Function Nearest()
+     * Returns the node closest to a point.
+     * @param aPos is the point.
+     * @param aSquaredDist is set to the squared distance between the node and the point.
+     * @return The anchor index of the closest node, or -1 if the tree is empty.
+     */
+    int Nearest( const VECTOR2I& aPos, VECTOR2I::extended_type& aSquaredDist ) const;
+
+private:
+    ///> Splits the nodes in [aBegin, aEnd) around their median, alternately along x and y.
+    void build( size_t aBegin, size_t aEnd, bool aSplitX );
+
+    void nearest( size_t aBegin, size_t aEnd, bool aSplitX, const VECTOR2I& aPos,
+                  size_t& aBest, VECTOR2I::extended_type& aBestDist ) const;
+
+    ///> Nodes, each range of the tree having its median node in its middle
+    std::vector<NODE> m_nodes;
+};
+
+
 /**
  * Class RN_NET
  * Describes ratsnest for a single net.
@@ -114,14 +156,6 @@ public:
         return m_nodes.size();
     }
 
-    /**
-     * Function GetNodes()
-     * Returns list of nodes that are associated with a given item.
-     * @param aItem is an item for which the list is generated.
-     * @return List of associated nodes.
-     */
-    std::list<CN_ANCHOR_PTR> GetNodes( const BOARD_CONNECTED_ITEM* aItem ) const;
-
     const std::vector<CN_EDGE>& GetEdges() const
     {
         return m_rnEdges;
@@ -136,20 +170,52 @@ public:
     void GetAllItems( std::list<BOARD_CONNECTED_ITEM*>& aOutput, const KICAD_T aTypes[] ) const;
 
     /**
-     * Function GetClosestNode()
-     * Returns a single node that lies in the shortest distance from a specific node.
-     * @param aNode is the node for which the closest node is searched.
+     * Function GetNode()
+     * Returns a node of the net.
+     * @param aIndex is the index of the node in the anchors of the net.
+     */
+    const CN_ANCHOR& GetNode( int aIndex ) const
+    {
+        return ( *m_anchors )[aIndex];
+    }
+
+    /**
+     * Function NearestBicoloredPair()
+     * Finds the closest nodes of this net and another one.
+     * @param aNode1 is set to the index of the node of this net.
+     * @param aNode2 is set to the index of the node of aOtherNet.
+     * @return false if no pair was found.
+     */
+    bool NearestBicoloredPair( const RN_NET& aOtherNet, int& aNode1, int& aNode2 ) const;
+
+    /**
+     * Function BuildNodeTree()
+     * Indexes the nodes which can be ratsnest line targets, so NearestBicoloredPair() does
+     * not have to compare all of them with the nodes of the other net.  The index is dropped
+     * when the nodes change or with ClearNodeTree(), and has to be rebuilt when the
+     * CN_ANCHOR::SetNoLine() flag of a node changes.
      */
-    const CN_ANCHOR_PTR GetClosestNode( const CN_ANCHOR_PTR& aNode ) const;
+    void BuildNodeTree();
 
-    bool NearestBicoloredPair( const RN_NET& aOtherNet, CN_ANCHOR_PTR& aNode1, CN_ANCHOR_PTR& aNode2 ) const;
+    void ClearNodeTree()
+    {
+        m_nodeTree.reset();
+    }
+
+    bool HasNodeTree() const
+    {
+        return (bool) m_nodeTree;
+    }
 
 protected:
     ///> Recomputes ratsnest from scratch.
     void compute();
 
-    ///> Vector of nodes
-    std::vector<CN_ANCHOR_PTR> m_nodes;
+    ///> Anchors of the items of the net, which the nodes and the edges index
+    CN_NET_ANCHORS_PTR m_anchors;
+
+    ///> Vector of nodes, indices in m_anchors
+    std::vector<int> m_nodes;
 
     ///> Vector of edges that make pre-defined connections
     std::vector<CN_EDGE> m_boardEdges;
@@ -163,6 +229,9 @@ protected:
     class TRIANGULATOR_STATE;
 
     std::shared_ptr<TRIANGULATOR_STATE> m_triangulator;
+
+    ///> Index of the nodes for NearestBicoloredPair(), see BuildNodeTree()
+    std::unique_ptr<RN_NODE_TREE> m_nodeTree;
 };
 
 #endif /* RATSNEST_DATA_H */
@@ -128,13 +128,13 @@ void RATSNEST_VIEWITEM::ViewDraw( int aLayer, KIGFX::VIEW* aView ) const
 
             const auto& sourceNode = edge.GetSourceNode();
             const auto& targetNode = edge.GetTargetNode();
-            const VECTOR2I source( sourceNode->Pos() );
-            const VECTOR2I target( targetNode->Pos() );
+            const VECTOR2I source( sourceNode.Pos() );
+            const VECTOR2I target( targetNode.Pos() );
 
-            if( !sourceNode->Valid() || !targetNode->Valid() )
+            if( !sourceNode.Valid() || !targetNode.Valid() )
                 continue;
 
-            bool enable =  !sourceNode->GetNoLine() && !targetNode->GetNoLine();
+            bool enable =  !sourceNode.GetNoLine() && !targetNode.GetNoLine();
             bool show;
 
             // If the global ratsnest is currently enabled, the local ratsnest
@@ -142,11 +142,11 @@ void RATSNEST_VIEWITEM::ViewDraw( int aLayer, KIGFX::VIEW* aView ) const
             // If the global ratsnest is disabled, the local ratsnest should be easy to turn on
             // so either element can enable it.
             if( rs->GetGlobalRatsnestLinesEnabled() )
-                show = sourceNode->Parent()->GetLocalRatsnestVisible() &&
-                       targetNode->Parent()->GetLocalRatsnestVisible();
+                show = sourceNode.Parent()->GetLocalRatsnestVisible() &&
+                       targetNode.Parent()->GetLocalRatsnestVisible();
             else
-                show = sourceNode->Parent()->GetLocalRatsnestVisible() ||
-                       targetNode->Parent()->GetLocalRatsnestVisible();
+                show = sourceNode.Parent()->GetLocalRatsnestVisible() ||
+                       targetNode.Parent()->GetLocalRatsnestVisible();
 
             if ( enable && show )
             {
@@ -80,84 +80,22 @@ public:
     virtual wxString NetName( int aNet ) override;
 
 private:
-    struct CLEARANCE_ENT
-    {
-        int coupledNet;
-        int dpClearance;
-        int clearance;
-    };
-
-    int localPadClearance( const PNS::ITEM* aItem ) const;
+    const D_PAD* parentPad( const PNS::ITEM* aItem ) const;
+    int itemClearance( const PNS::ITEM* aItem ) const;
     int matchDpSuffix( wxString aNetName, wxString& aComplementNet, wxString& aBaseDpName );
 
     PNS::ROUTER* m_router;
     BOARD*       m_board;
 
-    std::vector<CLEARANCE_ENT> m_netClearanceCache;
-    std::unordered_map<const D_PAD*, int> m_localClearanceCache;
-    int m_defaultClearance;
+    const CLEARANCE_RESOLVER& m_clearances;
 };
 
 
 PNS_PCBNEW_RULE_RESOLVER::PNS_PCBNEW_RULE_RESOLVER( BOARD* aBoard, PNS::ROUTER* aRouter ) :
     m_router( aRouter ),
-    m_board( aBoard )
+    m_board( aBoard ),
+    m_clearances( aBoard->GetClearanceResolver() )
 {
-    PNS::NODE* world = m_router->GetWorld();
-
-    PNS::TOPOLOGY topo( world );
-    m_netClearanceCache.resize( m_board->GetNetCount() );
-
-    // Build clearance cache for net classes
-    for( unsigned int i = 0; i < m_board->GetNetCount(); i++ )
-    {
-        NETINFO_ITEM* ni = m_board->FindNet( i );
-
-        if( ni == NULL )
-            continue;
-
-        CLEARANCE_ENT ent;
-        ent.coupledNet = DpCoupledNet( i );
-
-        wxString netClassName = ni->GetClassName();
-        NETCLASSPTR nc = m_board->GetDesignSettings().m_NetClasses.Find( netClassName );
-
-        int clearance = nc->GetClearance();
-        ent.clearance = clearance;
-        ent.dpClearance = nc->GetDiffPairGap();
-        m_netClearanceCache[i] = ent;
-
-        wxLogTrace( "PNS", "Add net %u netclass %s clearance %d Diff Pair clearance %d",
-                i, netClassName.mb_str(), clearance, ent.dpClearance );
-    }
-
-    // Build clearance cache for pads
-    for( auto mod : m_board->Modules() )
-    {
-        auto moduleClearance = mod->GetLocalClearance();
-
-        for( auto pad : mod->Pads() )
-        {
-            int padClearance = pad->GetLocalClearance();
-
-            if( padClearance > 0 )
-                m_localClearanceCache[ pad ] = padClearance;
-
-            else if( moduleClearance > 0 )
-                m_localClearanceCache[ pad ] = moduleClearance;
-        }
-    }
-
-    auto defaultRule = m_board->GetDesignSettings().m_NetClasses.Find ("Default");
-
-    if( defaultRule )
-    {
-        m_defaultClearance = defaultRule->GetClearance();
-    }
-    else
-    {
-        m_defaultClearance = Millimeter2iu(0.254);
-    }
 }
 
 
@@ -166,49 +104,39 @@ PNS_PCBNEW_RULE_RESOLVER::~PNS_PCBNEW_RULE_RESOLVER()
 }
 
 
-int PNS_PCBNEW_RULE_RESOLVER::localPadClearance( const PNS::ITEM* aItem ) const
+const D_PAD* PNS_PCBNEW_RULE_RESOLVER::parentPad( const PNS::ITEM* aItem ) const
 {
     if( !aItem->Parent() || aItem->Parent()->Type() != PCB_PAD_T )
-        return 0;
+        return nullptr;
+
+    return static_cast<const D_PAD*>( aItem->Parent() );
+}
 
-    const D_PAD* pad = static_cast<D_PAD*>( aItem->Parent() );
 
-    auto i = m_localClearanceCache.find( pad );
+int PNS_PCBNEW_RULE_RESOLVER::itemClearance( const PNS::ITEM* aItem ) const
+{
+    // Pads may override the clearance of their net
+    const D_PAD* pad = parentPad( aItem );
 
-    if( i == m_localClearanceCache.end() )
-        return 0;
+    if( pad )
+        return m_clearances.GetItemClearance( pad );
 
-    return i->second;
+    return m_clearances.GetNetClearance( aItem->Net() );
 }
 
 
 int PNS_PCBNEW_RULE_RESOLVER::Clearance( const PNS::ITEM* aA, const PNS::ITEM* aB ) const
 {
-    int net_a = aA->Net();
-    int cl_a = ( net_a >= 0 ? m_netClearanceCache[net_a].clearance : m_defaultClearance );
-    int net_b = aB->Net();
-    int cl_b = ( net_b >= 0 ? m_netClearanceCache[net_b].clearance : m_defaultClearance );
+    if( !parentPad( aA ) && !parentPad( aB ) )
+        return m_clearances.GetNetPairClearance( aA->Net(), aB->Net() );
 
-    // Pad clearance is 0 if the ITEM* is not a pad
-    int pad_a = localPadClearance( aA );
-    int pad_b = localPadClearance( aB );
-
-    if( pad_a > 0 )
-        cl_a = pad_a;
-
-    if( pad_b > 0 )
-        cl_b = pad_b;
-
-    return std::max( cl_a, cl_b );
+    return std::max( itemClearance( aA ), itemClearance( aB ) );
 }
 
 
 int PNS_PCBNEW_RULE_RESOLVER::Clearance( int aNetCode ) const
 {
-    if( aNetCode > 0 && aNetCode < (int) m_netClearanceCache.size() )
-        return m_netClearanceCache[aNetCode].clearance;
-
-    return m_defaultClearance;
+    return m_clearances.GetNetClearance( aNetCode );
 }
 
 
@@ -0,0 +1,430 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file snapshot_plugin.cpp
+ * @brief Binary board snapshot plugin, for autosaves and fast reloads.
+ */
+
+#include <cstring>
+#include <map>
+#include <memory>
+
+#include <wx/ffile.h>
+
+#include <fctsys.h>
+#include <build_version.h>
+#include <macros.h>
+#include <class_board.h>
+#include <class_zone.h>
+#include <pcb_parser.h>
+#include <snapshot_plugin.h>
+
+
+/// First bytes of every snapshot.
+static const char snapshotMagic[] = { 'K', 'i', 'C', 'a', 'd', 'S', 'n', 'p' };
+
+
+/**
+ * Append the little endian integers, strings and coordinates of a snapshot to a buffer.
+ */
+class SNAPSHOT_WRITER
+{
+public:
+    SNAPSHOT_WRITER( std::string& aBuffer ) :
+        m_buf( aBuffer )
+    {
+    }
+
+    void PutU32( uint32_t aValue )
+    {
+        for( int i = 0; i < 4; ++i )
+            m_buf += char( ( aValue >> ( 8 * i ) ) & 0xFF );
+    }
+
+    /// Unsigned LEB128: 7 bits per byte, most coordinates deltas fit in 1 to 3 bytes.
+    void PutVarint( uint64_t aValue )
+    {
+        while( aValue >= 0x80 )
+        {
+            m_buf += char( ( aValue & 0x7F ) | 0x80 );
+            aValue >>= 7;
+        }
+
+        m_buf += char( aValue );
+    }
+
+    /// Zigzag encoding, so small negative values are short too.
+    void PutSigned( int64_t aValue )
+    {
+        PutVarint( ( uint64_t( aValue ) << 1 ) ^ uint64_t( aValue >> 63 ) );
+    }
+
+    void PutString( const std::string& aText )
+    {
+        PutVarint( aText.size() );
+        m_buf += aText;
+    }
+
+private:
+    std::string& m_buf;
+};
+
+
+/**
+ * Read back what SNAPSHOT_WRITER wrote, throwing an IO_ERROR if the data is truncated.
+ */
+class SNAPSHOT_READER
+{
+public:
+    SNAPSHOT_READER( const std::string& aBuffer, const wxString& aSource ) :
+        m_ptr( aBuffer.data() ),
+        m_end( aBuffer.data() + aBuffer.size() ),
+        m_source( aSource )
+    {
+    }
+
+    const char* GetBytes( size_t aCount )
+    {
+        if( size_t( m_end - m_ptr ) < aCount )
+            THROW_IO_ERROR( wxString::Format( _( "Snapshot file \"%s\" is truncated" ),
+                                              m_source ) );
+
+        const char* bytes = m_ptr;
+        m_ptr += aCount;
+        return bytes;
+    }
+
+    uint32_t GetU32()
+    {
+        const unsigned char* bytes = (const unsigned char*) GetBytes( 4 );
+
+        return uint32_t( bytes[0] ) | uint32_t( bytes[1] ) << 8
+                | uint32_t( bytes[2] ) << 16 | uint32_t( bytes[3] ) << 24;
+    }
+
+    uint64_t GetVarint()
+    {
+        uint64_t value = 0;
+
+        for( int shift = 0; shift < 64; shift += 7 )
+        {
+            unsigned char byte = *GetBytes( 1 );
+
+            value |= uint64_t( byte & 0x7F ) << shift;
+
+            if( !( byte & 0x80 ) )
+                return value;
+        }
+
+        THROW_IO_ERROR( wxString::Format( _( "Snapshot file \"%s\" is corrupted" ), m_source ) );
+    }
+
+    int64_t GetSigned()
+    {
+        uint64_t value = GetVarint();
+
+        return int64_t( value >> 1 ) ^ -int64_t( value & 1 );
+    }
+
+    /// A count of items, each of them using at least one byte.
+    size_t GetCount()
+    {
+        uint64_t count = GetVarint();
+
+        if( count > uint64_t( m_end - m_ptr ) )
+            THROW_IO_ERROR( wxString::Format( _( "Snapshot file \"%s\" is corrupted" ),
+                                              m_source ) );
+
+        return count;
+    }
+
+    std::string GetString()
+    {
+        size_t size = GetCount();
+
+        return std::string( GetBytes( size ), size );
+    }
+
+private:
+    const char*     m_ptr;
+    const char*     m_end;
+    const wxString& m_source;
+};
+
+
+SNAPSHOT_PLUGIN::SNAPSHOT_PLUGIN() :
+    PCB_IO( CTL_FOR_BOARD | CTL_OMIT_ZONE_FILLS )
+{
+}
+
+
+void SNAPSHOT_PLUGIN::Save( const wxString& aFileName, BOARD* aBoard,
+                            const PROPERTIES* aProperties )
+{
+    init( aProperties );
+
+    m_board = aBoard;       // after init()
+
+    // Prepare net mapping that assures that net codes saved in a file are consecutive integers
+    m_mapping->SetBoard( aBoard );
+
+    STRING_FORMATTER boardText;
+
+    m_out = &boardText;     // no ownership
+
+    m_out->Print( 0, "(kicad_pcb (version %d) (host pcbnew %s)\n", SEXPR_BOARD_FILE_VERSION,
+                  boardText.Quotew( GetBuildVersion() ).c_str() );
+
+    Format( aBoard, 1 );
+
+    m_out->Print( 0, ")\n" );
+    m_out = &m_sf;
+
+    // Build the string tables of the nets and layers of the zones
+    std::map<wxString, unsigned>     netIndices;
+    std::map<PCB_LAYER_ID, unsigned> layerIndices;
+    std::vector<wxString>            netNames;
+    std::vector<PCB_LAYER_ID>        layers;
+
+    for( int ii = 0; ii < aBoard->GetAreaCount(); ++ii )
+    {
+        ZONE_CONTAINER* zone = aBoard->GetArea( ii );
+
+        if( netIndices.emplace( zone->GetNetname(), netNames.size() ).second )
+            netNames.push_back( zone->GetNetname() );
+
+        if( layerIndices.emplace( zone->GetLayer(), layers.size() ).second )
+            layers.push_back( zone->GetLayer() );
+    }
+
+    std::string     buffer( snapshotMagic, sizeof( snapshotMagic ) );
+    SNAPSHOT_WRITER writer( buffer );
+
+    writer.PutU32( SNAPSHOT_FILE_VERSION );
+
+    writer.PutVarint( netNames.size() );
+
+    for( const wxString& netName : netNames )
+        writer.PutString( TO_UTF8( netName ) );
+
+    writer.PutVarint( layers.size() );
+
+    for( PCB_LAYER_ID layer : layers )
+        writer.PutString( TO_UTF8( aBoard->GetLayerName( layer ) ) );
+
+    writer.PutString( boardText.GetString() );
+
+    // The zones are written and parsed back in the board order
+    writer.PutVarint( aBoard->GetAreaCount() );
+
+    for( int ii = 0; ii < aBoard->GetAreaCount(); ++ii )
+    {
+        ZONE_CONTAINER*       zone = aBoard->GetArea( ii );
+        const SHAPE_POLY_SET& fill = zone->GetFilledPolysList();
+        VECTOR2I              last( 0, 0 );
+
+        writer.PutVarint( netIndices[zone->GetNetname()] );
+        writer.PutVarint( layerIndices[zone->GetLayer()] );
+        writer.PutVarint( fill.OutlineCount() );
+
+        for( int ipoly = 0; ipoly < fill.OutlineCount(); ++ipoly )
+        {
+            writer.PutVarint( fill.HoleCount( ipoly ) + 1 );
+
+            for( int icontour = 0; icontour <= fill.HoleCount( ipoly ); ++icontour )
+            {
+                const SHAPE_LINE_CHAIN& contour = icontour == 0 ? fill.COutline( ipoly )
+                                                                : fill.CHole( ipoly, icontour - 1 );
+
+                writer.PutVarint( contour.PointCount() );
+
+                for( int ipt = 0; ipt < contour.PointCount(); ++ipt )
+                {
+                    const VECTOR2I& pt = contour.CPoint( ipt );
+
+                    writer.PutSigned( int64_t( pt.x ) - last.x );
+                    writer.PutSigned( int64_t( pt.y ) - last.y );
+                    last = pt;
+                }
+            }
+        }
+    }
+
+    wxFFile file( aFileName, wxT( "wb" ) );
+
+    if( !file.IsOpened() || !file.Write( buffer.data(), buffer.size() ) || !file.Close() )
+        THROW_IO_ERROR( wxString::Format( _( "Cannot write snapshot file \"%s\"" ), aFileName ) );
+}
+
+
+BOARD* SNAPSHOT_PLUGIN::Load( const wxString& aFileName, BOARD* aAppendToMe,
+                              const PROPERTIES* aProperties )
+{
+    std::string buffer;
+    wxFFile     file( aFileName, wxT( "rb" ) );
+
+    if( !file.IsOpened() )
+        THROW_IO_ERROR( wxString::Format( _( "Unable to open snapshot file \"%s\"" ), aFileName ) );
+
+    buffer.resize( file.Length() );
+
+    if( file.Read( &buffer[0], buffer.size() ) != buffer.size() )
+        THROW_IO_ERROR( wxString::Format( _( "Cannot read snapshot file \"%s\"" ), aFileName ) );
+
+    file.Close();
+
+    SNAPSHOT_READER reader( buffer, aFileName );
+
+    if( memcmp( reader.GetBytes( sizeof( snapshotMagic ) ), snapshotMagic,
+                sizeof( snapshotMagic ) ) != 0 )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "\"%s\" is not a board snapshot" ), aFileName ) );
+    }
+
+    uint32_t version = reader.GetU32();
+
+    if( version != SNAPSHOT_FILE_VERSION )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "Board snapshot \"%s\" has version %u, "
+                                             "only version %d can be read" ),
+                                          aFileName, version, SNAPSHOT_FILE_VERSION ) );
+    }
+
+    std::vector<wxString> netNames( reader.GetCount() );
+
+    for( wxString& netName : netNames )
+        netName = FROM_UTF8( reader.GetString().c_str() );
+
+    std::vector<wxString> layerNames( reader.GetCount() );
+
+    for( wxString& layerName : layerNames )
+        layerName = FROM_UTF8( reader.GetString().c_str() );
+
+    init( aProperties );
+
+    int    firstZone = aAppendToMe ? aAppendToMe->GetAreaCount() : 0;
+    BOARD* board;
+
+    {
+        STRING_LINE_READER boardText( reader.GetString(), aFileName );
+
+        m_parser->SetLineReader( &boardText );
+        m_parser->SetBoard( aAppendToMe );
+
+        try
+        {
+            board = dynamic_cast<BOARD*>( m_parser->Parse() );
+        }
+        catch( const FUTURE_FORMAT_ERROR& )
+        {
+            // Don't wrap a FUTURE_FORMAT_ERROR in another
+            throw;
+        }
+        catch( const PARSE_ERROR& parse_error )
+        {
+            if( m_parser->IsTooRecent() )
+                throw FUTURE_FORMAT_ERROR( parse_error, m_parser->GetRequiredVersion() );
+            else
+                throw;
+        }
+
+        if( !board )
+        {
+            // The parser loaded something that was valid, but wasn't a board.
+            THROW_PARSE_ERROR( _( "this file does not contain a PCB" ),
+                    m_parser->CurSource(), m_parser->CurLine(),
+                    m_parser->CurLineNumber(), m_parser->CurOffset() );
+        }
+    }
+
+    // Don't leak a new board if the fills cannot be read
+    std::unique_ptr<BOARD> deleter( aAppendToMe ? nullptr : board );
+
+    // Attach the fills to the zones, checking the snapshot matches what was parsed
+    wxString inconsistent = wxString::Format( _( "Board snapshot \"%s\" is inconsistent" ),
+                                              aFileName );
+    size_t   zoneCount = reader.GetCount();
+
+    if( board->GetAreaCount() - firstZone != int( zoneCount ) )
+        THROW_IO_ERROR( inconsistent );
+
+    for( size_t ii = 0; ii < zoneCount; ++ii )
+    {
+        ZONE_CONTAINER* zone = board->GetArea( firstZone + ii );
+        size_t          netIndex = reader.GetVarint();
+        size_t          layerIndex = reader.GetVarint();
+        size_t          polyCount = reader.GetCount();
+        SHAPE_POLY_SET  fill;
+        VECTOR2I        last( 0, 0 );
+
+        if( polyCount == 0 )
+            continue;
+
+        // Keepout and non copper zones lose their net when parsed, so only filled zones
+        // can be checked
+        if( netIndex >= netNames.size() || layerIndex >= layerNames.size()
+                || zone->GetNetname() != netNames[netIndex]
+                || zone->GetLayer() != board->GetLayerID( layerNames[layerIndex] ) )
+        {
+            THROW_IO_ERROR( inconsistent );
+        }
+
+        for( size_t ipoly = 0; ipoly < polyCount; ++ipoly )
+        {
+            size_t contourCount = reader.GetCount();
+
+            if( contourCount == 0 )
+                THROW_IO_ERROR( inconsistent );
+
+            for( size_t icontour = 0; icontour < contourCount; ++icontour )
+            {
+                SHAPE_LINE_CHAIN contour;
+                size_t           pointCount = reader.GetCount();
+
+                for( size_t ipt = 0; ipt < pointCount; ++ipt )
+                {
+                    last.x += reader.GetSigned();
+                    last.y += reader.GetSigned();
+                    contour.Append( last, true );
+                }
+
+                contour.SetClosed( true );
+
+                if( icontour == 0 )
+                    fill.AddOutline( contour );
+                else
+                    fill.AddHole( contour );
+            }
+        }
+
+        zone->SetFilledPolysList( fill );
+    }
+
+    // Give the filename to the board if it's new
+    if( !aAppendToMe )
+        board->SetFileName( aFileName );
+
+    deleter.release();
+    return board;
+}
@@ -0,0 +1,86 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file snapshot_plugin.h
+ * @brief Binary board snapshot plugin, for autosaves and fast reloads.
+ */
+
+#ifndef SNAPSHOT_PLUGIN_H_
+#define SNAPSHOT_PLUGIN_H_
+
+#include <kicad_plugin.h>
+
+
+/**
+ * Current version of the snapshot container.  Snapshots are meant to be reread by the
+ * build which wrote them, so there is no attempt to read older versions: bump this
+ * whenever the layout below changes.
+ */
+#define SNAPSHOT_FILE_VERSION       1
+
+
+/**
+ * Class SNAPSHOT_PLUGIN
+ * is a PLUGIN which saves and loads a BOARD in a compact binary container.
+ *
+ * Most of the time spent saving and loading large boards goes to the filled zone polygons,
+ * which are formatted and parsed point by point in the s-expression format.  A snapshot
+ * holds:
+ *  - a header with a magic number and #SNAPSHOT_FILE_VERSION,
+ *  - string tables of the names of the nets and layers of the zones,
+ *  - the board itself, formatted by PCB_IO without the zone fills,
+ *  - for each zone, its net and layer as indices in the tables above and its filled
+ *    polygons as packed arrays of delta encoded coordinates.
+ *
+ * All the integers are written little endian, whatever the host is.  The snapshot is not
+ * meant to be edited or kept under version control: use PCB_IO for that.
+ */
+class SNAPSHOT_PLUGIN : public PCB_IO
+{
+public:
+
+    //-----<PLUGIN API>---------------------------------------------------------
+
+    wxString PluginName() const override
+    {
+        return wxT( "KiCad snapshot" );
+    }
+
+    wxString GetFileExtension() const override
+    {
+        return wxT( "kicad_pcb_snapshot" );
+    }
+
+    void Save( const wxString& aFileName, BOARD* aBoard,
+               const PROPERTIES* aProperties = NULL ) override;
+
+    BOARD* Load( const wxString& aFileName, BOARD* aAppendToMe,
+                 const PROPERTIES* aProperties = NULL ) override;
+
+    //-----</PLUGIN API>--------------------------------------------------------
+
+    SNAPSHOT_PLUGIN();
+};
+
+#endif  // SNAPSHOT_PLUGIN_H_
@@ -3445,6 +3445,7 @@ void SPECCTRA_DB::ExportPCB( const wxString& aFilename, bool aNameChange )
             pcb->pcbname = TO_UTF8( aFilename );
 
         pcb->Format( &formatter, 0 );
+        formatter.Finish();
     }
 }
 
@@ -3456,6 +3457,7 @@ void SPECCTRA_DB::ExportSESSION( const wxString& aFilename )
         FILE_OUTPUTFORMATTER formatter( aFilename, wxT( "wt" ), quote_char[0] );
 
         session->Format( &formatter, 0 );
+        formatter.Finish();
     }
 }
 
@@ -43,6 +43,8 @@
 #include <class_zone.h>
 #include <class_drawsegment.h>
 #include <connectivity/connectivity_data.h>
+#include <tool/tool_manager.h>
+#include <tools/drc.h>
 #include <view/view.h>
 #include "specctra.h"
 
@@ -79,6 +81,10 @@ bool PCB_EDIT_FRAME::ImportSpecctraSession( const wxString& fullFileName )
     GetBoard()->GetConnectivity()->Clear();
     GetBoard()->GetConnectivity()->Build( GetBoard() );
 
+    // The tracks were replaced without a board commit
+    if( DRC* drcTool = m_toolManager->GetTool<DRC>() )
+        drcTool->InvalidateOnlineIndex();
+
     if( GetCanvas() )    // Update view:
     {
         // Update footprint positions
@@ -57,12 +57,33 @@
 #include <geometry/shape_arc.h>
 
 #include <drc/courtyard_overlap.h>
+#include <drc/drc_rtree.h>
+#include <zone_filler.h>
+#include <thread_pool.h>
+#include <widgets/progress_reporter.h>
+
+#include <atomic>
+#include <unordered_map>
+#include <unordered_set>
+
+
+thread_local wxPoint DRC::m_padToTestPos;
+thread_local wxPoint DRC::m_segmEnd;
+thread_local double  DRC::m_segmAngle = 0;
+thread_local int     DRC::m_segmLength = 0;
+thread_local int     DRC::m_xcliplo = 0;
+thread_local int     DRC::m_ycliplo = 0;
+thread_local int     DRC::m_xcliphi = 0;
+thread_local int     DRC::m_ycliphi = 0;
 
 
 DRC::DRC() :
         PCB_TOOL_BASE( "pcbnew.DRCTool" )
 {
     m_drcDialog  = NULL;
+    m_pcbEditorFrame = nullptr;
+    m_pcb = nullptr;
+    m_clearances = nullptr;
 
     // establish initial values for everything:
     m_doPad2PadTest     = true;         // enable pad to pad clearance tests
@@ -72,6 +93,10 @@ DRC::DRC() :
     m_refillZones = false;              // Only fill zones if requested by user.
     m_reportAllTrackErrors = false;
     m_testFootprints = false;
+    m_onlineDRC = false;                // Only re-test changed items if requested by user.
+    m_onlineIndexValid = false;
+    m_onlineRulesRevision = 0;
+    m_onlineOutlinesValid = false;
 
     m_drcRun = false;
     m_footprintsTested = false;
@@ -79,15 +104,8 @@ DRC::DRC() :
     m_doCreateRptFile = false;
     // m_rptFilename set to empty by its constructor
 
-    m_currentMarker = NULL;
-
-    m_segmAngle  = 0;
-    m_segmLength = 0;
-
-    m_xcliplo = 0;
-    m_ycliplo = 0;
-    m_xcliphi = 0;
-    m_ycliphi = 0;
+    m_phaseItemCount = 0;
+    m_phaseMarkerCount = 0;
 }
 
 
@@ -111,6 +129,7 @@ void DRC::Reset( RESET_REASON aReason )
             DestroyDRCDialog( wxID_OK );
 
         m_pcb = m_pcbEditorFrame->GetBoard();
+        InvalidateOnlineIndex();
 
         m_markerFactory.SetUnitsProvider( [=]() { return m_pcbEditorFrame->GetUserUnits(); } );
     }
@@ -163,12 +182,126 @@ int DRC::ShowDRCDialog( const TOOL_EVENT& aEvent )
 
 void DRC::addMarkerToPcb( MARKER_PCB* aMarker )
 {
+    m_phaseMarkerCount++;
+
+    if( m_markerHandler )
+    {
+        m_markerHandler( aMarker );
+        return;
+    }
+
     BOARD_COMMIT commit( m_pcbEditorFrame );
     commit.Add( aMarker );
     commit.Push( wxEmptyString, false, false );
 }
 
 
+void DRC::addMarkersToPcb( const std::vector<MARKER_PCB*>& aMarkers )
+{
+    if( aMarkers.empty() )
+        return;
+
+    m_phaseMarkerCount += aMarkers.size();
+
+    if( m_markerHandler )
+    {
+        for( MARKER_PCB* marker : aMarkers )
+            m_markerHandler( marker );
+
+        return;
+    }
+
+    BOARD_COMMIT commit( m_pcbEditorFrame );
+
+    for( MARKER_PCB* marker : aMarkers )
+        commit.Add( marker );
+
+    commit.Push( wxEmptyString, false, false );
+}
+
+
+void DRC::startPhase( const wxString& aName )
+{
+    endPhase();
+
+    // A negative duration flags the phase as running
+    m_phaseStats.push_back( { aName, 0, 0, -1.0 } );
+    m_phaseItemCount = 0;
+    m_phaseMarkerCount = 0;
+    m_phaseTimer.Start();
+}
+
+
+void DRC::endPhase()
+{
+    if( m_phaseStats.empty() || m_phaseStats.back().m_Duration >= 0.0 )
+        return;
+
+    m_phaseTimer.Stop();
+
+    DRC_PHASE_STATS& phase = m_phaseStats.back();
+    phase.m_Duration = m_phaseTimer.msecs();
+    phase.m_ItemCount = m_phaseItemCount;
+    phase.m_MarkerCount = m_phaseMarkerCount;
+}
+
+
+/**
+ * Forwards the refreshes of a THREAD_POOL loop to the progress callback of
+ * DRC::runParallel().
+ */
+class DRC_PROGRESS_CALLBACK : public PROGRESS_REPORTER
+{
+public:
+    DRC_PROGRESS_CALLBACK( const std::function<bool( size_t )>& aProgress,
+                           const std::atomic<size_t>& aDoneCount ) :
+            PROGRESS_REPORTER( 1 ),
+            m_progress( aProgress ),
+            m_doneCount( aDoneCount )
+    {
+    }
+
+protected:
+    bool updateUI() override
+    {
+        return m_progress( m_doneCount );
+    }
+
+private:
+    const std::function<bool( size_t )>& m_progress;
+    const std::atomic<size_t>&           m_doneCount;
+};
+
+
+void DRC::runParallel( size_t aCount,
+                       const std::function<void( size_t, std::vector<MARKER_PCB*>& )>& aTest,
+                       const std::function<bool( size_t )>& aProgress )
+{
+    // One marker list per work unit: merging them in unit order afterwards gives the same
+    // marker order as a serial run, whatever thread ran which unit
+    std::vector<std::vector<MARKER_PCB*>> unitMarkers( aCount );
+    std::atomic<size_t>                   doneCount( 0 );
+    DRC_PROGRESS_CALLBACK                 reporter( aProgress, doneCount );
+
+    m_phaseItemCount += aCount;
+
+    THREAD_POOL::GetInstance().ParallelFor( aCount,
+            [&]( size_t aIdx )
+            {
+                aTest( aIdx, unitMarkers[aIdx] );
+                doneCount++;
+            },
+            aProgress ? &reporter : nullptr );
+
+    std::vector<MARKER_PCB*> markers;
+
+    for( std::vector<MARKER_PCB*>& unit : unitMarkers )
+        markers.insert( markers.end(), unit.begin(), unit.end() );
+
+    addMarkersToPcb( markers );
+}
+
+
 void DRC::DestroyDRCDialog( int aReason )
 {
     if( m_drcDialog )
@@ -183,8 +316,8 @@ void DRC::DestroyDRCDialog( int aReason )
 
 int DRC::TestZoneToZoneOutline( ZONE_CONTAINER* aZone, bool aCreateMarkers )
 {
-    BOARD* board = m_pcbEditorFrame->GetBoard();
-    BOARD_COMMIT commit( m_pcbEditorFrame );
+    BOARD* board = m_pcbEditorFrame ? m_pcbEditorFrame->GetBoard() : m_pcb;
+    std::vector<MARKER_PCB*> markers;
     int nerrors = 0;
 
     std::vector<SHAPE_POLY_SET> smoothed_polys;
@@ -254,8 +387,8 @@ int DRC::TestZoneToZoneOutline( ZONE_CONTAINER* aZone, bool aCreateMarkers )
                 if( smoothed_polys[ia2].Contains( currentVertex ) )
                 {
                     if( aCreateMarkers )
-                        commit.Add( m_markerFactory.NewMarker( pt, zoneRef, zoneToTest,
-                                                               DRCE_ZONES_INTERSECT ) );
+                        markers.push_back( m_markerFactory.NewMarker( pt, zoneRef, zoneToTest,
+                                                                      DRCE_ZONES_INTERSECT ) );
 
                     nerrors++;
                 }
@@ -270,8 +403,8 @@ int DRC::TestZoneToZoneOutline( ZONE_CONTAINER* aZone, bool aCreateMarkers )
                 if( smoothed_polys[ia].Contains( currentVertex ) )
                 {
                     if( aCreateMarkers )
-                        commit.Add( m_markerFactory.NewMarker( pt, zoneToTest, zoneRef,
-                                                               DRCE_ZONES_INTERSECT ) );
+                        markers.push_back( m_markerFactory.NewMarker( pt, zoneToTest, zoneRef,
+                                                                      DRCE_ZONES_INTERSECT ) );
 
                     nerrors++;
                 }
@@ -319,8 +452,8 @@ int DRC::TestZoneToZoneOutline( ZONE_CONTAINER* aZone, bool aCreateMarkers )
             for( wxPoint pt : conflictPoints )
             {
                 if( aCreateMarkers )
-                    commit.Add( m_markerFactory.NewMarker( pt, zoneRef, zoneToTest,
-                                                           DRCE_ZONES_TOO_CLOSE ) );
+                    markers.push_back( m_markerFactory.NewMarker( pt, zoneRef, zoneToTest,
+                                                                  DRCE_ZONES_TOO_CLOSE ) );
 
                 nerrors++;
             }
@@ -328,26 +461,79 @@ int DRC::TestZoneToZoneOutline( ZONE_CONTAINER* aZone, bool aCreateMarkers )
     }
 
     if( aCreateMarkers )
-        commit.Push( wxEmptyString, false, false );
+        addMarkersToPcb( markers );
 
     return nerrors;
 }
 
 
+void DRC::SetSettings( bool aPad2PadTest, bool aUnconnectedTest, bool aZonesTest,
+                       bool aKeepoutTest, bool aRefillZones, bool aReportAllTrackErrors )
+{
+    m_doPad2PadTest        = aPad2PadTest;
+    m_doUnconnectedTest    = aUnconnectedTest;
+    m_doZonesTest          = aZonesTest;
+    m_doKeepoutTest        = aKeepoutTest;
+    m_refillZones          = aRefillZones;
+    m_reportAllTrackErrors = aReportAllTrackErrors;
+}
+
+
 void DRC::RunTests( wxTextCtrl* aMessages )
 {
     // be sure m_pcb is the current board, not a old one
     // ( the board can be reloaded )
     m_pcb = m_pcbEditorFrame->GetBoard();
 
+    runTests( aMessages );
+}
+
+
+void DRC::RunTests( BOARD* aBoard, DRC_PROVIDER::MARKER_HANDLER aMarkerHandler,
+                    EDA_UNITS_T aUnits )
+{
+    wxCHECK_RET( !m_pcbEditorFrame, "Headless DRC run on a DRC tool owned by an editor frame" );
+
+    m_pcb = aBoard;
+    m_markerHandler = aMarkerHandler;
+    m_markerFactory.SetUnits( aUnits );
+
+    // The board editor builds the connectivity when loading a board, but a board loaded
+    // elsewhere has none: the zone nets, unconnected items and refilled islands need it
+    m_pcb->BuildConnectivity();
+
+    runTests( nullptr );
+
+    m_markerHandler = nullptr;
+}
+
+
+void DRC::runTests( wxTextCtrl* aMessages )
+{
+    m_phaseStats.clear();
+
+    // Built here, the tests share it between their threads
+    m_clearances = &m_pcb->GetClearanceResolver();
+
+    // D_PAD::GetBoundingRadius() caches the radius when first called, which would be a data
+    // race between the test threads: compute all of them here
+    for( MODULE* mod : m_pcb->Modules() )
+    {
+        for( D_PAD* pad : mod->Pads() )
+            pad->GetBoundingRadius();
+    }
+
     if( aMessages )
     {
         aMessages->AppendText( _( "Board Outline...\n" ) );
         wxSafeYield();
     }
 
+    startPhase( wxT( "board_outline" ) );
     testOutline();
 
+    startPhase( wxT( "netclasses" ) );
+
     // someone should have cleared the two lists before calling this.
     if( !testNetClasses() )
     {
@@ -358,6 +544,8 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         if( aMessages )
             aMessages->AppendText( _( "Aborting\n" ) );
 
+        endPhase();
+
         // update the m_drcDialog listboxes
         updatePointers();
 
@@ -373,6 +561,7 @@ void DRC::RunTests( wxTextCtrl* aMessages )
             wxSafeYield();
         }
 
+        startPhase( wxT( "pad_clearances" ) );
         testPad2Pad();
     }
 
@@ -383,23 +572,35 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         wxSafeYield();
     }
 
+    startPhase( wxT( "drilled_holes" ) );
     testDrilledHoles();
 
-    // caller (a wxTopLevelFrame) is the wxDialog or the Pcb Editor frame that call DRC:
-    wxWindow* caller = aMessages ? aMessages->GetParent() : m_pcbEditorFrame;
-
     if( m_refillZones )
     {
         if( aMessages )
             aMessages->AppendText( _( "Refilling all zones...\n" ) );
 
-        m_pcbEditorFrame->Fill_All_Zones();
+        startPhase( wxT( "zone_fills" ) );
+
+        if( m_pcbEditorFrame )
+        {
+            m_pcbEditorFrame->Fill_All_Zones();
+        }
+        else
+        {
+            ZONE_FILLER filler( m_pcb );
+            filler.Fill( m_pcb->Zones() );
+        }
     }
-    else
+    else if( m_pcbEditorFrame )
     {
+        // caller (a wxTopLevelFrame) is the wxDialog or the Pcb Editor frame that call DRC:
+        wxWindow* caller = aMessages ? aMessages->GetParent() : m_pcbEditorFrame;
+
         if( aMessages )
             aMessages->AppendText( _( "Checking zone fills...\n" ) );
 
+        startPhase( wxT( "zone_fills" ) );
         m_pcbEditorFrame->Check_All_Zones( caller );
     }
 
@@ -410,7 +611,8 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         wxSafeYield();
     }
 
-    testTracks( aMessages ? aMessages->GetParent() : m_pcbEditorFrame, true );
+    startPhase( wxT( "track_clearances" ) );
+    testTracks( aMessages ? aMessages->GetParent() : m_pcbEditorFrame, m_pcbEditorFrame != nullptr );
 
     // test zone clearances to other zones
     if( aMessages )
@@ -419,6 +621,7 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         wxSafeYield();
     }
 
+    startPhase( wxT( "zone_clearances" ) );
     testZones();
 
     // find and gather unconnected pads.
@@ -430,7 +633,11 @@ void DRC::RunTests( wxTextCtrl* aMessages )
             aMessages->Refresh();
         }
 
+        startPhase( wxT( "unconnected_items" ) );
         testUnconnected();
+
+        // Unconnected items are not markers, but are reported as such
+        m_phaseMarkerCount += (int) m_unconnected.size();
     }
 
     // find and gather vias, tracks, pads inside keepout areas.
@@ -442,6 +649,7 @@ void DRC::RunTests( wxTextCtrl* aMessages )
             aMessages->Refresh();
         }
 
+        startPhase( wxT( "keepout_areas" ) );
         testKeepoutAreas();
     }
 
@@ -452,6 +660,7 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         wxSafeYield();
     }
 
+    startPhase( wxT( "text_and_graphic_clearances" ) );
     testCopperTextAndGraphics();
 
     // find overlapping courtyard ares.
@@ -464,6 +673,7 @@ void DRC::RunTests( wxTextCtrl* aMessages )
             aMessages->Refresh();
         }
 
+        startPhase( wxT( "courtyards" ) );
         doFootprintOverlappingDrc();
     }
 
@@ -473,7 +683,8 @@ void DRC::RunTests( wxTextCtrl* aMessages )
     m_footprints.clear();
     m_footprintsTested = false;
 
-    if( m_testFootprints && !Kiface().IsSingle() )
+    // The schematic is only available through the editor frame
+    if( m_testFootprints && m_pcbEditorFrame && !Kiface().IsSingle() )
     {
         if( aMessages )
         {
@@ -481,6 +692,8 @@ void DRC::RunTests( wxTextCtrl* aMessages )
             aMessages->Refresh();
         }
 
+        startPhase( wxT( "footprints" ) );
+
         NETLIST netlist;
         m_pcbEditorFrame->FetchNetlistFromSchematic( netlist, PCB_EDIT_FRAME::ANNOTATION_DIALOG );
 
@@ -492,7 +705,9 @@ void DRC::RunTests( wxTextCtrl* aMessages )
     }
 
     // Check if there are items on disabled layers
+    startPhase( wxT( "disabled_layers" ) );
     testDisabledLayers();
+    endPhase();
 
     if( aMessages )
     {
@@ -516,6 +731,10 @@ void DRC::RunTests( wxTextCtrl* aMessages )
 
 void DRC::updatePointers()
 {
+    // Nothing to update for headless runs
+    if( !m_pcbEditorFrame )
+        return;
+
     // update my pointers, m_pcbEditorFrame is the only unchangeable one
     m_pcb = m_pcbEditorFrame->GetBoard();
 
@@ -539,7 +758,7 @@ bool DRC::doNetClass( const NETCLASSPTR& nc, wxString& msg )
 
     const BOARD_DESIGN_SETTINGS& g = m_pcb->GetDesignSettings();
 
-#define FmtVal( x ) GetChars( StringFromValue( m_pcbEditorFrame->GetUserUnits(), x ) )
+#define FmtVal( x ) GetChars( StringFromValue( m_markerFactory.GetUnits(), x ) )
 
 #if 0   // set to 1 when (if...) BOARD_DESIGN_SETTINGS has a m_MinClearance value
     if( nc->GetClearance() < g.m_MinClearance )
@@ -550,8 +769,7 @@ bool DRC::doNetClass( const NETCLASSPTR& nc, wxString& msg )
                     FmtVal( g.m_TrackClearance )
                     );
 
-        addMarkerToPcb( fillMarker( DRCE_NETCLASS_CLEARANCE, msg, m_currentMarker ) );
-        m_currentMarker = nullptr;
+        addMarkerToPcb( m_markerFactory.NewMarker( DRCE_NETCLASS_CLEARANCE, msg ) );
         ret = false;
     }
 #endif
@@ -665,18 +883,16 @@ void DRC::testPad2Pad()
     // Upper limit of pad list (limit not included)
     D_PAD** listEnd = &sortedPads[0] + sortedPads.size();
 
-    // Test the pads
-    for( auto& pad : sortedPads )
-    {
-        int x_limit = pad->GetClearance() + pad->GetBoundingRadius() + pad->GetPosition().x;
+    // Test the pads, each pad being a work unit
+    runParallel( sortedPads.size(),
+            [&]( size_t aIdx, std::vector<MARKER_PCB*>& aMarkers )
+            {
+                D_PAD*& pad = sortedPads[aIdx];
+                int x_limit = m_clearances->GetItemClearance( pad ) + pad->GetBoundingRadius()
+                              + pad->GetPosition().x;
 
-        if( !doPadToPadsDrc( pad, &pad, listEnd, max_size + x_limit ) )
-        {
-            wxASSERT( m_currentMarker );
-            addMarkerToPcb ( m_currentMarker );
-            m_currentMarker = nullptr;
-        }
-    }
+                doPadToPadsDrc( pad, &pad, listEnd, max_size + x_limit, aMarkers );
+            } );
 }
 
 
@@ -728,28 +944,31 @@ void DRC::testDrilledHoles()
         }
     }
 
-    for( size_t ii = 0; ii < holes.size(); ++ii )
-    {
-        const DRILLED_HOLE& refHole = holes[ ii ];
-
-        for( size_t jj = ii + 1; jj < holes.size(); ++jj )
-        {
-            const DRILLED_HOLE& checkHole = holes[ jj ];
-
-            // Holes with identical locations are allowable
-            if( checkHole.m_location == refHole.m_location )
-                continue;
-
-            if( KiROUND( GetLineLength( checkHole.m_location, refHole.m_location ) )
-                    <  checkHole.m_drillRadius + refHole.m_drillRadius + holeToHoleMin )
+    runParallel( holes.size(),
+            [&]( size_t ii, std::vector<MARKER_PCB*>& aMarkers )
             {
-                addMarkerToPcb( new MARKER_PCB( m_pcbEditorFrame->GetUserUnits(),
-                                                DRCE_DRILLED_HOLES_TOO_CLOSE, refHole.m_location,
-                                                refHole.m_owner, refHole.m_location,
-                                                checkHole.m_owner, checkHole.m_location ) );
-            }
-        }
-    }
+                const DRILLED_HOLE& refHole = holes[ ii ];
+
+                for( size_t jj = ii + 1; jj < holes.size(); ++jj )
+                {
+                    const DRILLED_HOLE& checkHole = holes[ jj ];
+
+                    // Holes with identical locations are allowable
+                    if( checkHole.m_location == refHole.m_location )
+                        continue;
+
+                    if( KiROUND( GetLineLength( checkHole.m_location, refHole.m_location ) )
+                            <  checkHole.m_drillRadius + refHole.m_drillRadius + holeToHoleMin )
+                    {
+                        aMarkers.push_back( new MARKER_PCB( m_markerFactory.GetUnits(),
+                                                            DRCE_DRILLED_HOLES_TOO_CLOSE,
+                                                            refHole.m_location,
+                                                            refHole.m_owner, refHole.m_location,
+                                                            checkHole.m_owner,
+                                                            checkHole.m_location ) );
+                    }
+                }
+            } );
 }
 
 
@@ -772,41 +991,567 @@ void DRC::testTracks( wxWindow *aActiveWindow, bool aShowProgressBar )
         progressDialog->Update( 0, wxEmptyString );
     }
 
-    int ii = 0;
-    count = 0;
+    // Index tracks and pads by their position in the board lists, so that candidates
+    // returned by the spatial index come back in board order and the markers are the same
+    // as the ones a full forward scan would produce.
+    std::vector<TRACK*> tracks( m_pcb->Tracks().begin(), m_pcb->Tracks().end() );
+    std::vector<D_PAD*> pads;
+    DRC_RTREE<int>      trackIndex;
+    DRC_RTREE<int>      padIndex;
+    int                 maxClearance = 0;
+
+    for( MODULE* mod : m_pcb->Modules() )
+    {
+        for( D_PAD* pad : mod->Pads() )
+            pads.push_back( pad );
+    }
 
-    for( auto seg_it = m_pcb->Tracks().begin(); seg_it != m_pcb->Tracks().end(); seg_it++ )
+    for( int idx = 0; idx < (int) tracks.size(); ++idx )
     {
-        if( ii++ > delta )
+        TRACK* track = tracks[idx];
+
+        trackIndex.Insert( idx, track->GetBoundingBox(), track->GetLayerSet() );
+        maxClearance = std::max( maxClearance, m_clearances->GetItemClearance( track ) );
+    }
+
+    for( int idx = 0; idx < (int) pads.size(); ++idx )
+    {
+        D_PAD*   pad = pads[idx];
+        EDA_RECT bbox = pad->GetBoundingBox();
+        LSET     layers = pad->GetLayerSet();
+
+        // A pad hole is tested against tracks on every copper layer, even the ones the
+        // pad itself is not on
+        if( pad->GetDrillSize().x )
         {
-            ii = 0;
-            count++;
+            int holeRadius = std::max( pad->GetDrillSize().x, pad->GetDrillSize().y ) / 2;
 
-            if( progressDialog )
-            {
-                if( !progressDialog->Update( count, wxEmptyString ) )
-                    break;  // Aborted by user
+            bbox.Merge( EDA_RECT( pad->GetPosition(), wxSize( 0, 0 ) ).Inflate( holeRadius ) );
+            layers = LSET::AllCuMask();
+        }
+
+        padIndex.Insert( idx, bbox, layers );
+        maxClearance = std::max( maxClearance, m_clearances->GetItemClearance( pad ) );
+    }
+
+    count = 0;
+
+    auto reportProgress = [&]( size_t aDone ) -> bool
+    {
+        if( !progressDialog || (int) aDone / delta <= count )
+            return true;
+
+        count = std::min<int>( aDone / delta, deltamax );
+
+        if( !progressDialog->Update( count, wxEmptyString ) )
+            return false;   // Aborted by user
 #ifdef __WXMAC__
-                // Work around a dialog z-order issue on OS X
-                if( count == deltamax )
-                    aActiveWindow->Raise();
+        // Work around a dialog z-order issue on OS X
+        if( count == deltamax )
+            aActiveWindow->Raise();
 #endif
+        return true;
+    };
+
+    // Each track is a work unit
+    runParallel( tracks.size(),
+            [&]( size_t aIdx, std::vector<MARKER_PCB*>& aMarkers )
+            {
+                TRACK*              refSeg = tracks[aIdx];
+                std::vector<int>    candidates;
+                std::vector<TRACK*> nearTracks;
+                std::vector<D_PAD*> nearPads;
+
+                // Only the items closer than the worst case clearance can be in violation.
+                // The extra unit absorbs rounding in the bounding box computations.
+                int      clearance = std::max( m_clearances->GetItemClearance( refSeg ),
+                                               maxClearance );
+                EDA_RECT searchBox = refSeg->GetBoundingBox();
+                searchBox.Inflate( clearance + 1 );
+
+                // Each pair of tracks is tested once, from the first of the two in board order
+                trackIndex.Query( searchBox, refSeg->GetLayerSet(), candidates );
+
+                for( int idx : candidates )
+                {
+                    if( idx > (int) aIdx )
+                        nearTracks.push_back( tracks[idx] );
+                }
+
+                padIndex.Query( searchBox, refSeg->GetLayerSet(), candidates );
+
+                for( int idx : candidates )
+                    nearPads.push_back( pads[idx] );
+
+                // Test new segment against tracks and pads, optionally against copper zones
+                doTrackDrc( refSeg, nearTracks, nearPads, m_doZonesTest, true,
+                            m_reportAllTrackErrors, aMarkers );
+            },
+            reportProgress );
+
+    if( progressDialog )
+        progressDialog->Destroy();
+}
+
+
+/**
+ * @return true if the markers of the given error code come from the tests run by the
+ * online DRC, i.e. from doTrackDrc() and doPadToPadsDrc()
+ */
+static bool isOnlineDrcCode( int aErrorCode )
+{
+    switch( aErrorCode )
+    {
+    case DRCE_TRACK_NEAR_THROUGH_HOLE:
+    case DRCE_TRACK_NEAR_PAD:
+    case DRCE_TRACK_NEAR_VIA:
+    case DRCE_VIA_NEAR_VIA:
+    case DRCE_VIA_NEAR_TRACK:
+    case DRCE_TRACK_ENDS1:
+    case DRCE_TRACK_ENDS2:
+    case DRCE_TRACK_ENDS3:
+    case DRCE_TRACK_ENDS4:
+    case DRCE_TRACK_SEGMENTS_TOO_CLOSE:
+    case DRCE_TRACKS_CROSSING:
+    case DRCE_ENDS_PROBLEM1:
+    case DRCE_ENDS_PROBLEM2:
+    case DRCE_ENDS_PROBLEM3:
+    case DRCE_ENDS_PROBLEM4:
+    case DRCE_ENDS_PROBLEM5:
+    case DRCE_PAD_NEAR_PAD1:
+    case DRCE_VIA_HOLE_BIGGER:
+    case DRCE_MICRO_VIA_INCORRECT_LAYER_PAIR:
+    case DRCE_HOLE_NEAR_PAD:
+    case DRCE_TOO_SMALL_TRACK_WIDTH:
+    case DRCE_TOO_SMALL_VIA:
+    case DRCE_TOO_SMALL_MICROVIA:
+    case DRCE_TOO_SMALL_VIA_DRILL:
+    case DRCE_TOO_SMALL_MICROVIA_DRILL:
+    case DRCE_TRACK_NEAR_ZONE:
+    case DRCE_MICRO_VIA_NOT_ALLOWED:
+    case DRCE_BURIED_VIA_NOT_ALLOWED:
+    case DRCE_TRACK_NEAR_EDGE:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+
+int DRC::ToggleOnlineDRC( const TOOL_EVENT& aEvent )
+{
+    m_onlineDRC = !m_onlineDRC;
+
+    return 0;
+}
+
+
+void DRC::TestCommitChanges( const std::vector<BOARD_ITEM*>& aChangedItems,
+                             const std::vector<BOARD_ITEM*>& aRemovedItems )
+{
+    if( !m_pcbEditorFrame )
+        return;
+
+    m_pcb = m_pcbEditorFrame->GetBoard();
+    m_clearances = &m_pcb->GetClearanceResolver();
+
+    // The items whose markers are out of date
+    std::unordered_set<const void*> staleItems;
+    std::vector<TRACK*>             changedTracks;
+    std::vector<D_PAD*>             changedPads;
+
+    auto isOnEdgeCuts = []( const BOARD_ITEM* aItem ) -> bool
+    {
+        if( aItem->Type() == PCB_MODULE_T )
+        {
+            for( const BOARD_ITEM* item : static_cast<const MODULE*>( aItem )->GraphicalItems() )
+            {
+                if( item->GetLayer() == Edge_Cuts )
+                    return true;
             }
+
+            return false;
         }
 
-        // Test new segment against tracks and pads, optionally against copper zones
-        if( !doTrackDrc( *seg_it, seg_it + 1, m_pcb->Tracks().end(), m_doZonesTest ) )
+        return aItem->GetLayer() == Edge_Cuts;
+    };
+
+    for( BOARD_ITEM* item : aRemovedItems )
+    {
+        staleItems.insert( item );
+        removeFromOnlineIndex( item );
+
+        if( item->Type() == PCB_MODULE_T )
         {
-            if( m_currentMarker )
+            for( D_PAD* pad : static_cast<MODULE*>( item )->Pads() )
             {
-                addMarkerToPcb ( m_currentMarker );
-                m_currentMarker = nullptr;
+                staleItems.insert( pad );
+                removeFromOnlineIndex( pad );
             }
         }
+
+        if( isOnEdgeCuts( item ) )
+            m_onlineOutlinesValid = false;
     }
 
-    if( progressDialog )
-        progressDialog->Destroy();
+    for( BOARD_ITEM* item : aChangedItems )
+    {
+        // An item can be both changed and removed by the same commit
+        if( staleItems.count( item ) )
+            continue;
+
+        if( isOnEdgeCuts( item ) )
+            m_onlineOutlinesValid = false;
+
+        switch( item->Type() )
+        {
+        case PCB_TRACE_T:
+        case PCB_VIA_T:
+            changedTracks.push_back( static_cast<TRACK*>( item ) );
+            break;
+
+        case PCB_PAD_T:
+            changedPads.push_back( static_cast<D_PAD*>( item ) );
+            break;
+
+        case PCB_MODULE_T:
+            for( D_PAD* pad : static_cast<MODULE*>( item )->Pads() )
+                changedPads.push_back( pad );
+
+            break;
+
+        default:
+            continue;
+        }
+    }
+
+    // A module and one of its pads can both be in the commit
+    std::sort( changedPads.begin(), changedPads.end() );
+    changedPads.erase( std::unique( changedPads.begin(), changedPads.end() ), changedPads.end() );
+    std::sort( changedTracks.begin(), changedTracks.end() );
+    changedTracks.erase( std::unique( changedTracks.begin(), changedTracks.end() ),
+                         changedTracks.end() );
+
+    staleItems.insert( changedTracks.begin(), changedTracks.end() );
+    staleItems.insert( changedPads.begin(), changedPads.end() );
+
+    if( staleItems.empty() )
+        return;
+
+    // The clearances of the indexed items change with the design rules
+    if( m_onlineRulesRevision != m_pcb->GetDesignRulesRevision() )
+        m_onlineIndexValid = false;
+
+    if( m_onlineIndexValid )
+    {
+        for( TRACK* track : changedTracks )
+            updateOnlineIndex( track );
+
+        for( D_PAD* pad : changedPads )
+            updateOnlineIndex( pad );
+
+        // The item counts are a cheap check against the tools which change the tracks or
+        // the pads without a board commit
+        size_t padCount = 0;
+
+        for( MODULE* mod : m_pcb->Modules() )
+            padCount += mod->Pads().size();
+
+        if( m_onlineEntries.size() != m_pcb->Tracks().size() + padCount )
+            m_onlineIndexValid = false;
+    }
+
+    if( !m_onlineIndexValid )
+        buildOnlineIndex();
+
+    std::vector<MARKER_PCB*> staleMarkers;
+
+    for( int ii = 0; ii < m_pcb->GetMARKERCount(); ++ii )
+    {
+        MARKER_PCB*     marker = m_pcb->GetMARKER( ii );
+        const DRC_ITEM& item = marker->GetReporter();
+
+        if( !isOnlineDrcCode( item.GetErrorCode() ) )
+            continue;
+
+        if( staleItems.count( item.GetMainItemWeakRef() )
+                || ( item.HasSecondItem() && staleItems.count( item.GetAuxiliaryItemWeakRef() ) ) )
+        {
+            staleMarkers.push_back( marker );
+        }
+    }
+
+    std::vector<MARKER_PCB*> markers;
+
+    if( !changedTracks.empty() || !changedPads.empty() )
+    {
+        // The board outline is needed by the track to board edge test
+        if( !m_onlineOutlinesValid )
+        {
+            m_board_outlines.RemoveAllContours();
+
+            if( !m_pcb->GetBoardPolygonOutlines( m_board_outlines ) )
+                m_board_outlines.RemoveAllContours();
+
+            m_onlineOutlinesValid = true;
+        }
+
+        doIncrementalDrc( changedTracks, changedPads, markers );
+    }
+
+    if( staleMarkers.empty() && markers.empty() )
+        return;
+
+    // The markers are not part of the design: they are changed directly, so the commit which
+    // called us does not need a nested one (and a second ratsnest update)
+    for( MARKER_PCB* marker : staleMarkers )
+    {
+        view()->Remove( marker );
+        m_pcb->Remove( marker );
+        delete marker;
+    }
+
+    for( MARKER_PCB* marker : markers )
+    {
+        m_pcb->Add( marker );
+        view()->Add( marker );
+    }
+
+    if( m_drcDialog )
+        updatePointers();
+}
+
+
+/**
+ * @return the bounding box and the layers of a pad for the clearance tests: a pad hole is
+ * tested against the tracks on every copper layer, even the ones the pad itself is not on.
+ */
+static void padTestArea( const D_PAD* aPad, EDA_RECT& aBBox, LSET& aLayers )
+{
+    aBBox = aPad->GetBoundingBox();
+    aLayers = aPad->GetLayerSet();
+
+    if( aPad->GetDrillSize().x )
+    {
+        int holeRadius = std::max( aPad->GetDrillSize().x, aPad->GetDrillSize().y ) / 2;
+
+        aBBox.Merge( EDA_RECT( aPad->GetPosition(), wxSize( 0, 0 ) ).Inflate( holeRadius ) );
+        aLayers = LSET::AllCuMask();
+    }
+}
+
+
+void DRC::buildOnlineIndex()
+{
+    m_onlineTracks.RemoveAll();
+    m_onlinePads.RemoveAll();
+    m_onlineEntries.clear();
+    m_onlineLocalClearances.clear();
+
+    for( TRACK* track : m_pcb->Tracks() )
+        updateOnlineIndex( track );
+
+    for( MODULE* mod : m_pcb->Modules() )
+    {
+        for( D_PAD* pad : mod->Pads() )
+            updateOnlineIndex( pad );
+    }
+
+    m_onlineIndexValid = true;
+    m_onlineRulesRevision = m_pcb->GetDesignRulesRevision();
+    m_onlineOutlinesValid = false;
+}
+
+
+void DRC::updateOnlineIndex( BOARD_ITEM* aItem )
+{
+    removeFromOnlineIndex( aItem );
+
+    ONLINE_ENTRY entry;
+
+    entry.m_Type = aItem->Type();
+    entry.m_LocalClearance = 0;
+
+    if( aItem->Type() == PCB_PAD_T )
+    {
+        D_PAD* pad = static_cast<D_PAD*>( aItem );
+
+        padTestArea( pad, entry.m_BBox, entry.m_Layers );
+
+        if( pad->GetLocalClearance() )
+            entry.m_LocalClearance = pad->GetLocalClearance();
+        else if( pad->GetParent() )
+            entry.m_LocalClearance = pad->GetParent()->GetLocalClearance();
+
+        m_onlinePads.Insert( pad, entry.m_BBox, entry.m_Layers );
+        m_onlineLocalClearances[ entry.m_LocalClearance ]++;
+    }
+    else
+    {
+        TRACK* track = static_cast<TRACK*>( aItem );
+
+        entry.m_BBox = track->GetBoundingBox();
+        entry.m_Layers = track->GetLayerSet();
+
+        m_onlineTracks.Insert( track, entry.m_BBox, entry.m_Layers );
+    }
+
+    m_onlineEntries[ aItem ] = entry;
+}
+
+
+void DRC::removeFromOnlineIndex( const BOARD_ITEM* aItem )
+{
+    auto it = m_onlineEntries.find( aItem );
+
+    if( it == m_onlineEntries.end() )
+        return;
+
+    const ONLINE_ENTRY& entry = it->second;
+
+    // Only the pointer value is used, the item may be deleted already
+    if( entry.m_Type == PCB_PAD_T )
+    {
+        m_onlinePads.Remove( (D_PAD*) aItem, entry.m_BBox, entry.m_Layers );
+
+        auto count = m_onlineLocalClearances.find( entry.m_LocalClearance );
+
+        if( --count->second == 0 )
+            m_onlineLocalClearances.erase( count );
+    }
+    else
+    {
+        m_onlineTracks.Remove( (TRACK*) aItem, entry.m_BBox, entry.m_Layers );
+    }
+
+    m_onlineEntries.erase( it );
+}
+
+
+int DRC::getOnlineMaxClearance() const
+{
+    int maxClearance = m_clearances->GetMaxNetClearance();
+
+    if( !m_onlineLocalClearances.empty() )
+        maxClearance = std::max( maxClearance, m_onlineLocalClearances.rbegin()->first );
+
+    return maxClearance;
+}
+
+
+void DRC::doIncrementalDrc( const std::vector<TRACK*>& aChangedTracks,
+                            const std::vector<D_PAD*>& aChangedPads,
+                            std::vector<MARKER_PCB*>& aMarkers )
+{
+    // The extra unit absorbs rounding in the bounding box computations
+    int margin = getOnlineMaxClearance() + 1;
+
+    // Each pair of changed items is tested once, from the first one in the commit.
+    // A changed item is tested against all the unchanged items near it.
+    std::unordered_map<const BOARD_ITEM*, int> changedOrder;
+
+    for( int idx = 0; idx < (int) aChangedTracks.size(); ++idx )
+        changedOrder[ aChangedTracks[idx] ] = idx;
+
+    for( int idx = 0; idx < (int) aChangedPads.size(); ++idx )
+        changedOrder[ aChangedPads[idx] ] = idx;
+
+    auto isTestedBefore = [&]( const BOARD_ITEM* aItem, int aOrder ) -> bool
+    {
+        auto it = changedOrder.find( aItem );
+        return it != changedOrder.end() && it->second <= aOrder;
+    };
+
+    // doPadToPadsDrc() expects the pads sorted by X position, as in a full DRC
+    auto sortByX = []( std::vector<D_PAD*>& aPads )
+    {
+        std::sort( aPads.begin(), aPads.end(),
+                   []( const D_PAD* a, const D_PAD* b )
+                   {
+                       if( a->GetPosition().x != b->GetPosition().x )
+                           return a->GetPosition().x < b->GetPosition().x;
+
+                       return a < b;
+                   } );
+    };
+
+    std::vector<TRACK*> foundTracks;
+    std::vector<D_PAD*> foundPads;
+    std::vector<TRACK*> testTracks;
+    std::vector<D_PAD*> testPads;
+    EDA_RECT            bbox;
+    LSET                layers;
+
+    for( int order = 0; order < (int) aChangedTracks.size(); ++order )
+    {
+        TRACK*   refSeg = aChangedTracks[order];
+        EDA_RECT searchBox = refSeg->GetBoundingBox();
+        searchBox.Inflate( margin );
+
+        testTracks.clear();
+        m_onlineTracks.Query( searchBox, refSeg->GetLayerSet(), foundTracks );
+
+        for( TRACK* track : foundTracks )
+        {
+            if( !isTestedBefore( track, order ) )
+                testTracks.push_back( track );
+        }
+
+        m_onlinePads.Query( searchBox, refSeg->GetLayerSet(), testPads );
+
+        doTrackDrc( refSeg, testTracks, testPads, m_doZonesTest, true, true, aMarkers );
+    }
+
+    if( aChangedPads.empty() )
+        return;
+
+    // The unchanged tracks near a changed pad are tested against the changed pads only
+    std::map<TRACK*, std::vector<D_PAD*>> padsNearTracks;
+
+    for( D_PAD* pad : aChangedPads )
+    {
+        padTestArea( pad, bbox, layers );
+        bbox.Inflate( margin );
+
+        m_onlineTracks.Query( bbox, layers, foundTracks );
+
+        for( TRACK* track : foundTracks )
+        {
+            if( !changedOrder.count( track ) )
+                padsNearTracks[ track ].push_back( pad );
+        }
+    }
+
+    for( std::pair<TRACK* const, std::vector<D_PAD*>>& trackPads : padsNearTracks )
+    {
+        doTrackDrc( trackPads.first, std::vector<TRACK*>(), trackPads.second, false, false, true,
+                    aMarkers );
+    }
+
+    for( int order = 0; order < (int) aChangedPads.size(); ++order )
+    {
+        D_PAD* refPad = aChangedPads[order];
+
+        padTestArea( refPad, bbox, layers );
+        bbox.Inflate( margin );
+
+        testPads.clear();
+        m_onlinePads.Query( bbox, layers, foundPads );
+
+        for( D_PAD* pad : foundPads )
+        {
+            if( !isTestedBefore( pad, order ) )
+                testPads.push_back( pad );
+        }
+
+        if( !testPads.empty() )
+        {
+            sortByX( testPads );
+            doPadToPadsDrc( refPad, &testPads[0], &testPads[0] + testPads.size(), INT_MAX,
+                            aMarkers );
+        }
+    }
 }
 
 
@@ -831,11 +1576,11 @@ void DRC::testUnconnected()
         auto src = edge.GetSourcePos();
         auto dst = edge.GetTargetPos();
 
-        m_unconnected.emplace_back( new DRC_ITEM( m_pcbEditorFrame->GetUserUnits(),
+        m_unconnected.emplace_back( new DRC_ITEM( m_markerFactory.GetUnits(),
                                                   DRCE_UNCONNECTED_ITEMS,
-                                                  edge.GetSourceNode()->Parent(),
+                                                  edge.GetSourceNode().Parent(),
                                                   wxPoint( src.x, src.y ),
-                                                  edge.GetTargetNode()->Parent(),
+                                                  edge.GetTargetNode().Parent(),
                                                   wxPoint( dst.x, dst.y ) ) );
     }
 }
@@ -879,63 +1624,65 @@ void DRC::testZones()
 
 void DRC::testKeepoutAreas()
 {
-    // Test keepout areas for vias, tracks and pads inside keepout areas
-    for( int ii = 0; ii < m_pcb->GetAreaCount(); ii++ )
-    {
-        ZONE_CONTAINER* area = m_pcb->GetArea( ii );
-
-        if( !area->GetIsKeepout() )
-            continue;
-
-        for( auto segm : m_pcb->Tracks() )
-        {
-            if( segm->Type() == PCB_TRACE_T )
+    // Test keepout areas for vias, tracks and pads inside keepout areas, each keepout
+    // area being a work unit
+    runParallel( m_pcb->GetAreaCount(),
+            [&]( size_t aIdx, std::vector<MARKER_PCB*>& aMarkers )
             {
-                if( !area->GetDoNotAllowTracks()  )
-                    continue;
-
-                // Ignore if the keepout zone is not on the same layer
-                if( !area->IsOnLayer( segm->GetLayer() ) )
-                    continue;
+                ZONE_CONTAINER* area = m_pcb->GetArea( aIdx );
 
-                SEG trackSeg( segm->GetStart(), segm->GetEnd() );
+                if( !area->GetIsKeepout() )
+                    return;
 
-                if( area->Outline()->Distance( trackSeg, segm->GetWidth() ) == 0 )
-                    addMarkerToPcb(
-                            m_markerFactory.NewMarker( segm, area, DRCE_TRACK_INSIDE_KEEPOUT ) );
-            }
-            else if( segm->Type() == PCB_VIA_T )
-            {
-                if( ! area->GetDoNotAllowVias()  )
-                    continue;
-
-                auto viaLayers = segm->GetLayerSet();
-
-                if( !area->CommonLayerExists( viaLayers ) )
-                    continue;
-
-                if( area->Outline()->Distance( segm->GetPosition() ) < segm->GetWidth()/2 )
-                    addMarkerToPcb(
-                            m_markerFactory.NewMarker( segm, area, DRCE_VIA_INSIDE_KEEPOUT ) );
-            }
-        }
-        // Test pads: TODO
-    }
+                for( auto segm : m_pcb->Tracks() )
+                {
+                    if( segm->Type() == PCB_TRACE_T )
+                    {
+                        if( !area->GetDoNotAllowTracks()  )
+                            continue;
+
+                        // Ignore if the keepout zone is not on the same layer
+                        if( !area->IsOnLayer( segm->GetLayer() ) )
+                            continue;
+
+                        SEG trackSeg( segm->GetStart(), segm->GetEnd() );
+
+                        if( area->Outline()->Distance( trackSeg, segm->GetWidth() ) == 0 )
+                            aMarkers.push_back( m_markerFactory.NewMarker(
+                                    segm, area, DRCE_TRACK_INSIDE_KEEPOUT ) );
+                    }
+                    else if( segm->Type() == PCB_VIA_T )
+                    {
+                        if( ! area->GetDoNotAllowVias()  )
+                            continue;
+
+                        auto viaLayers = segm->GetLayerSet();
+
+                        if( !area->CommonLayerExists( viaLayers ) )
+                            continue;
+
+                        if( area->Outline()->Distance( segm->GetPosition() ) < segm->GetWidth()/2 )
+                            aMarkers.push_back( m_markerFactory.NewMarker(
+                                    segm, area, DRCE_VIA_INSIDE_KEEPOUT ) );
+                    }
+                }
+                // Test pads: TODO
+            } );
 }
 
 
 void DRC::testCopperTextAndGraphics()
 {
     // Test copper items for clearance violations with vias, tracks and pads
+    // Gather the items to test first: each one is then a work unit
+    std::vector<BOARD_ITEM*> items;
 
     for( BOARD_ITEM* brdItem : m_pcb->Drawings() )
     {
         if( IsCopperLayer( brdItem->GetLayer() ) )
         {
-            if( brdItem->Type() == PCB_TEXT_T )
-                testCopperTextItem( brdItem );
-            else if( brdItem->Type() == PCB_LINE_T )
-                testCopperDrawItem( static_cast<DRAWSEGMENT*>( brdItem ));
+            if( brdItem->Type() == PCB_TEXT_T || brdItem->Type() == PCB_LINE_T )
+                items.push_back( brdItem );
         }
     }
 
@@ -945,10 +1692,10 @@ void DRC::testCopperTextAndGraphics()
         TEXTE_MODULE& val = module->Value();
 
         if( ref.IsVisible() && IsCopperLayer( ref.GetLayer() ) )
-            testCopperTextItem( &ref );
+            items.push_back( &ref );
 
         if( val.IsVisible() && IsCopperLayer( val.GetLayer() ) )
-            testCopperTextItem( &val );
+            items.push_back( &val );
 
         if( module->IsNetTie() )
             continue;
@@ -957,17 +1704,41 @@ void DRC::testCopperTextAndGraphics()
         {
             if( IsCopperLayer( item->GetLayer() ) )
             {
-                if( item->Type() == PCB_MODULE_TEXT_T && ( (TEXTE_MODULE*) item )->IsVisible() )
-                    testCopperTextItem( item );
-                else if( item->Type() == PCB_MODULE_EDGE_T )
-                    testCopperDrawItem( static_cast<DRAWSEGMENT*>( item ));
+                if( ( item->Type() == PCB_MODULE_TEXT_T && ( (TEXTE_MODULE*) item )->IsVisible() )
+                        || item->Type() == PCB_MODULE_EDGE_T )
+                {
+                    items.push_back( item );
+                }
             }
         }
     }
+
+    // Text shapes are built with the stroke font renderer, which is not thread safe,
+    // so they are built here before running the tests
+    std::vector<std::vector<wxPoint>> textShapes( items.size() );
+
+    for( size_t ii = 0; ii < items.size(); ++ii )
+    {
+        EDA_TEXT* text = dynamic_cast<EDA_TEXT*>( items[ii] );
+
+        if( text )
+            text->TransformTextShapeToSegmentList( textShapes[ii] );
+    }
+
+    runParallel( items.size(),
+            [&]( size_t aIdx, std::vector<MARKER_PCB*>& aMarkers )
+            {
+                BOARD_ITEM* item = items[aIdx];
+
+                if( item->Type() == PCB_LINE_T || item->Type() == PCB_MODULE_EDGE_T )
+                    testCopperDrawItem( static_cast<DRAWSEGMENT*>( item ), aMarkers );
+                else
+                    testCopperTextItem( item, textShapes[aIdx], aMarkers );
+            } );
 }
 
 
-void DRC::testCopperDrawItem( DRAWSEGMENT* aItem )
+void DRC::testCopperDrawItem( DRAWSEGMENT* aItem, std::vector<MARKER_PCB*>& aMarkers )
 {
     std::vector<SEG> itemShape;
     int itemWidth = aItem->GetWidth();
@@ -1036,10 +1807,10 @@ void DRC::testCopperDrawItem( DRAWSEGMENT* aItem )
             if( trackAsSeg.Distance( itemSeg ) < minDist )
             {
                 if( track->Type() == PCB_VIA_T )
-                    addMarkerToPcb( m_markerFactory.NewMarker(
+                    aMarkers.push_back( m_markerFactory.NewMarker(
                             track, aItem, itemSeg, DRCE_VIA_NEAR_COPPER ) );
                 else
-                    addMarkerToPcb( m_markerFactory.NewMarker(
+                    aMarkers.push_back( m_markerFactory.NewMarker(
                             track, aItem, itemSeg, DRCE_TRACK_NEAR_COPPER ) );
                 break;
             }
@@ -1063,7 +1834,8 @@ void DRC::testCopperDrawItem( DRAWSEGMENT* aItem )
         {
             if( padOutline.Distance( itemSeg, itemWidth ) == 0 )
             {
-                addMarkerToPcb( m_markerFactory.NewMarker( pad, aItem, DRCE_PAD_NEAR_COPPER ) );
+                aMarkers.push_back( m_markerFactory.NewMarker( pad, aItem,
+                                                               DRCE_PAD_NEAR_COPPER ) );
                 break;
             }
         }
@@ -1071,20 +1843,17 @@ void DRC::testCopperDrawItem( DRAWSEGMENT* aItem )
 }
 
 
-void DRC::testCopperTextItem( BOARD_ITEM* aTextItem )
+void DRC::testCopperTextItem( BOARD_ITEM* aTextItem, const std::vector<wxPoint>& aTextShape,
+                              std::vector<MARKER_PCB*>& aMarkers )
 {
     EDA_TEXT* text = dynamic_cast<EDA_TEXT*>( aTextItem );
 
     if( text == nullptr )
         return;
 
-    std::vector<wxPoint> textShape;      // a buffer to store the text shape (set of segments)
     int textWidth = text->GetThickness();
 
-    // So far the bounding box makes up the text-area
-    text->TransformTextShapeToSegmentList( textShape );
-
-    if( textShape.size() == 0 )     // Should not happen (empty text?)
+    if( aTextShape.size() == 0 )     // Should not happen (empty text?)
         return;
 
     EDA_RECT bbox = text->GetTextBox();
@@ -1103,17 +1872,17 @@ void DRC::testCopperTextItem( BOARD_ITEM* aTextItem )
         if( !rect_area.Collide( trackAsSeg, minDist ) )
             continue;
 
-        for( unsigned jj = 0; jj < textShape.size(); jj += 2 )
+        for( unsigned jj = 0; jj < aTextShape.size(); jj += 2 )
         {
-            SEG textSeg( textShape[jj], textShape[jj+1] );
+            SEG textSeg( aTextShape[jj], aTextShape[jj+1] );
 
             if( trackAsSeg.Distance( textSeg ) < minDist )
             {
                 if( track->Type() == PCB_VIA_T )
-                    addMarkerToPcb( m_markerFactory.NewMarker(
+                    aMarkers.push_back( m_markerFactory.NewMarker(
                             track, aTextItem, textSeg, DRCE_VIA_NEAR_COPPER ) );
                 else
-                    addMarkerToPcb( m_markerFactory.NewMarker(
+                    aMarkers.push_back( m_markerFactory.NewMarker(
                             track, aTextItem, textSeg, DRCE_TRACK_NEAR_COPPER ) );
                 break;
             }
@@ -1139,13 +1908,14 @@ void DRC::testCopperTextItem( BOARD_ITEM* aTextItem )
         int minDist = textWidth/2 + pad->GetClearance( NULL );
         pad->TransformShapeWithClearanceToPolygon( padOutline, 0 );
 
-        for( unsigned jj = 0; jj < textShape.size(); jj += 2 )
+        for( unsigned jj = 0; jj < aTextShape.size(); jj += 2 )
         {
-            SEG textSeg( textShape[jj], textShape[jj+1] );
+            SEG textSeg( aTextShape[jj], aTextShape[jj+1] );
 
             if( padOutline.Distance( textSeg, 0 ) <= minDist )
             {
-                addMarkerToPcb( m_markerFactory.NewMarker( pad, aTextItem, DRCE_PAD_NEAR_COPPER ) );
+                aMarkers.push_back( m_markerFactory.NewMarker( pad, aTextItem,
+                                                               DRCE_PAD_NEAR_COPPER ) );
                 break;
             }
         }
@@ -1169,7 +1939,7 @@ void DRC::testOutline()
 
 void DRC::testDisabledLayers()
 {
-    BOARD* board = m_pcbEditorFrame->GetBoard();
+    BOARD* board = m_pcb;
     wxCHECK( board, /*void*/ );
     LSET disabledLayers = board->GetEnabledLayers().flip();
 
@@ -1204,7 +1974,8 @@ void DRC::testDisabledLayers()
 }
 
 
-bool DRC::doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_limit )
+bool DRC::doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_limit,
+                          std::vector<MARKER_PCB*>& aMarkers )
 {
     const static LSET all_cu = LSET::AllCuMask();
 
@@ -1276,7 +2047,8 @@ bool DRC::doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_li
                 if( !checkClearancePadToPad( aRefPad, &dummypad ) )
                 {
                     // here we have a drc error on pad!
-                    m_currentMarker = m_markerFactory.NewMarker( pad, aRefPad, DRCE_HOLE_NEAR_PAD );
+                    aMarkers.push_back( m_markerFactory.NewMarker( pad, aRefPad,
+                                                                   DRCE_HOLE_NEAR_PAD ) );
                     return false;
                 }
             }
@@ -1292,7 +2064,8 @@ bool DRC::doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_li
                 if( !checkClearancePadToPad( pad, &dummypad ) )
                 {
                     // here we have a drc error on aRefPad!
-                    m_currentMarker = m_markerFactory.NewMarker( aRefPad, pad, DRCE_HOLE_NEAR_PAD );
+                    aMarkers.push_back( m_markerFactory.NewMarker( aRefPad, pad,
+                                                                   DRCE_HOLE_NEAR_PAD ) );
                     return false;
                 }
             }
@@ -1327,7 +2100,7 @@ bool DRC::doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_li
         if( !checkClearancePadToPad( aRefPad, pad ) )
         {
             // here we have a drc error!
-            m_currentMarker = m_markerFactory.NewMarker( aRefPad, pad, DRCE_PAD_NEAR_PAD1 );
+            aMarkers.push_back( m_markerFactory.NewMarker( aRefPad, pad, DRCE_PAD_NEAR_PAD1 ) );
             return false;
         }
     }
@@ -1400,6 +2173,7 @@ void DRC::TestFootprints( NETLIST& aNetlist, BOARD* aPCB, EDA_UNITS_T aUnits,
 void DRC::setTransitions()
 {
     Go( &DRC::ShowDRCDialog,              PCB_ACTIONS::runDRC.MakeEvent() );
+    Go( &DRC::ToggleOnlineDRC,            PCB_ACTIONS::toggleOnlineDRC.MakeEvent() );
 }
 
 
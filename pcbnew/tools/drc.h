@@ -29,10 +29,16 @@
 #include <class_track.h>
 #include <geometry/seg.h>
 #include <geometry/shape_poly_set.h>
+#include <functional>
+#include <map>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 #include <tools/pcb_tool_base.h>
 #include <drc/drc_marker_factory.h>
+#include <drc/drc_provider.h>
+#include <drc/drc_rtree.h>
+#include <profile.h>
 
 #define OK_DRC  0
 #define BAD_DRC 1
@@ -175,6 +181,18 @@ public:
 typedef std::vector<DRC_ITEM*> DRC_LIST;
 
 
+/**
+ * Timing and size statistics of one phase of a DRC run.
+ */
+struct DRC_PHASE_STATS
+{
+    wxString m_Name;            ///< Untranslated phase name, suitable for reports
+    int      m_ItemCount;       ///< Number of items tested (0 if not counted)
+    int      m_MarkerCount;     ///< Number of markers (or unconnected items) reported
+    double   m_Duration;        ///< Wall-clock duration, in milliseconds
+};
+
+
 /**
  * Design Rule Checker object that performs all the DRC tests.  The output of
  * the checking goes to the BOARD file in the form of two MARKER lists.  Those
@@ -205,36 +223,39 @@ private:
     bool     m_refillZones;             // refill zones if requested (by user).
     bool     m_reportAllTrackErrors;    // Report all tracks errors (or only 4 first errors)
     bool     m_testFootprints;          // Test footprints against schematic
+    bool     m_onlineDRC;               // re-test the items changed by each board commit
 
     wxString m_rptFilename;
 
-    MARKER_PCB* m_currentMarker;
-
     /* In DRC functions, many calculations are using coordinates relative
      * to the position of the segment under test (segm to segm DRC, segm to pad DRC
      * Next variables store coordinates relative to the start point of this segment
+     * These working variables are per thread, so the tests can run on worker threads.
      */
-    wxPoint m_padToTestPos; // Position of the pad to compare in drc test segm to pad or pad to pad
-    wxPoint m_segmEnd;      // End point of the reference segment (start point = (0,0) )
+    static thread_local wxPoint m_padToTestPos; // Position of the pad to compare in drc test
+                                                // segm to pad or pad to pad
+    static thread_local wxPoint m_segmEnd;      // End point of the reference segment
+                                                // (start point = (0,0) )
 
     /* Some functions are comparing the ref segm to pads or others segments using
      * coordinates relative to the ref segment considered as the X axis
      * so we store the ref segment length (the end point relative to these axis)
      * and the segment orientation (used to rotate other coordinates)
      */
-    double m_segmAngle;     // Ref segm orientation in 0,1 degre
-    int m_segmLength;       // length of the reference segment
+    static thread_local double m_segmAngle;     // Ref segm orientation in 0,1 degre
+    static thread_local int    m_segmLength;    // length of the reference segment
 
     /* variables used in checkLine to test DRC segm to segm:
      * define the area relative to the ref segment that does not contains any other segment
      */
-    int                 m_xcliplo;
-    int                 m_ycliplo;
-    int                 m_xcliphi;
-    int                 m_ycliphi;
+    static thread_local int m_xcliplo;
+    static thread_local int m_ycliplo;
+    static thread_local int m_xcliphi;
+    static thread_local int m_ycliphi;
 
     PCB_EDIT_FRAME*     m_pcbEditorFrame;   ///< The pcb frame editor which owns the board
     BOARD*              m_pcb;
+    const CLEARANCE_RESOLVER* m_clearances; ///< The clearances of m_pcb during a test run
     SHAPE_POLY_SET      m_board_outlines;   ///< The board outline including cutouts
     DIALOG_DRC_CONTROL* m_drcDialog;
     DRC_MARKER_FACTORY  m_markerFactory;    ///< Class that generates markers
@@ -244,6 +265,35 @@ private:
     bool                m_drcRun;
     bool                m_footprintsTested;
 
+    /// When set (headless runs), receives the markers instead of the board
+    DRC_PROVIDER::MARKER_HANDLER m_markerHandler;
+
+    std::vector<DRC_PHASE_STATS> m_phaseStats;      ///< statistics of the last run
+    PROF_COUNTER                 m_phaseTimer;
+    int                          m_phaseItemCount;
+    int                          m_phaseMarkerCount;
+
+    /// Where a track or pad is in the online DRC index
+    struct ONLINE_ENTRY
+    {
+        KICAD_T  m_Type;
+        EDA_RECT m_BBox;
+        LSET     m_Layers;
+        int      m_LocalClearance;  ///< pad or footprint clearance of a pad, 0 if none
+    };
+
+    /* The tracks and pads of the board, indexed for the online DRC.  The index follows the
+     * board commits and the undo/redo changes, and is only built again when it is invalidated
+     * (new board, changed design rules).
+     */
+    bool                                              m_onlineIndexValid;
+    unsigned                                          m_onlineRulesRevision;
+    bool                                              m_onlineOutlinesValid;
+    DRC_RTREE<TRACK*>                                 m_onlineTracks;
+    DRC_RTREE<D_PAD*>                                 m_onlinePads;
+    std::unordered_map<const BOARD_ITEM*, ONLINE_ENTRY> m_onlineEntries;
+    std::map<int, int>                                m_onlineLocalClearances;  ///< value, count
+
 
     ///> Sets up handlers for various events.
     void setTransitions() override;
@@ -258,6 +308,45 @@ private:
      */
     void addMarkerToPcb( MARKER_PCB* aMarker );
 
+    /**
+     * Adds a list of DRC markers to the PCB through a single COMMIT, in list order.
+     */
+    void addMarkersToPcb( const std::vector<MARKER_PCB*>& aMarkers );
+
+    /**
+     * Start the statistics of a new test phase, closing the current one if any.
+     * @param aName the untranslated name of the phase
+     */
+    void startPhase( const wxString& aName );
+
+    /**
+     * Close the statistics of the current test phase.
+     */
+    void endPhase();
+
+    /**
+     * Run the tests on m_pcb.  The editor frame is only used if m_pcbEditorFrame is set.
+     */
+    void runTests( wxTextCtrl* aMessages );
+
+    /**
+     * Run a DRC test over aCount independent work units, on the shared THREAD_POOL.
+     *
+     * The markers created by each work unit are kept apart, and added to the board in work
+     * unit order once all the units have completed, so the result is the same as a serial
+     * run and does not depend on thread scheduling.
+     *
+     * @param aCount the number of work units
+     * @param aTest the test to run for one work unit; it must only report problems through
+     *              the marker list it is given
+     * @param aProgress optional callback, run periodically with the number of units completed
+     *                  so far when called from the main thread.  Returning false cancels the
+     *                  remaining units.
+     */
+    void runParallel( size_t aCount,
+                      const std::function<void( size_t, std::vector<MARKER_PCB*>& )>& aTest,
+                      const std::function<bool( size_t )>& aProgress = nullptr );
+
     //-----<categorical group tests>-----------------------------------------
 
     /**
@@ -274,6 +363,8 @@ private:
     /**
      * Perform the DRC on all tracks.
      *
+     * Tracks and pads are spatially indexed, so each track is only tested against the
+     * items lying within the worst case clearance of it.
      * This test can take a while, a progress bar can be displayed
      * @param aActiveWindow = the active window ued as parent for the progress bar
      * @param aShowProgressBar = true to show a progress bar
@@ -292,9 +383,11 @@ private:
     void testKeepoutAreas();
 
     // aTextItem is type BOARD_ITEM* to accept either TEXTE_PCB or TEXTE_MODULE
-    void testCopperTextItem( BOARD_ITEM* aTextItem );
+    // aTextShape is the text shape as a set of segments, from TransformTextShapeToSegmentList()
+    void testCopperTextItem( BOARD_ITEM* aTextItem, const std::vector<wxPoint>& aTextShape,
+                             std::vector<MARKER_PCB*>& aMarkers );
 
-    void testCopperDrawItem( DRAWSEGMENT* aDrawing );
+    void testCopperDrawItem( DRAWSEGMENT* aDrawing, std::vector<MARKER_PCB*>& aMarkers );
 
     void testCopperTextAndGraphics();
 
@@ -321,27 +414,67 @@ private:
      * @param x_limit is used to stop the test
      * (i.e. when the current pad pos X in list exceeds this limit, because the list
      * is sorted by X coordinate)
+     * @param aMarkers receives the marker of the first problem found
+     * @return bool - true if no problems, else false
      */
-    bool doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_limit );
+    bool doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_limit,
+                         std::vector<MARKER_PCB*>& aMarkers );
 
     /**
      * Test the current segment.
      *
      * @param aRefSeg The segment to test
-     * @param aStartIt the iterator to the first track to test
-     * @param aEndIt the marker for the iterator end
+     * @param aTracks the tracks to test against aRefSeg, in board order
+     * @param aPads the pads to test against aRefSeg, in board order
      * @param aTestZones true if should do copper zones test. This can be very time consumming
-     * @return bool - true if no problems, else false and m_currentMarker is
-     *          filled in with the problem information.
+     * @param aTestRefSeg true to test aRefSeg on its own too (size and board edge tests)
+     * @param aReportAllErrors true to report all the problems of aRefSeg, false to stop at
+     *                         the first one
+     * @param aMarkers receives the markers of the problems found
+     * @return bool - true if no problems, else false
      */
-    bool doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterator aEndIt,
-                     bool aTestZones );
+    bool doTrackDrc( TRACK* aRefSeg, const std::vector<TRACK*>& aTracks,
+                     const std::vector<D_PAD*>& aPads, bool aTestZones, bool aTestRefSeg,
+                     bool aReportAllErrors, std::vector<MARKER_PCB*>& aMarkers );
 
     /**
      * Test for footprint courtyard overlaps.
      */
     void doFootprintOverlappingDrc();
 
+    /**
+     * Index all the tracks and pads of the board for the online DRC.
+     */
+    void buildOnlineIndex();
+
+    /**
+     * Add a track or pad to the online DRC index, or move it to its current place.
+     */
+    void updateOnlineIndex( BOARD_ITEM* aItem );
+
+    /**
+     * Remove a track or pad from the online DRC index.  aItem is not dereferenced, so it
+     * can be an item which is not on the board anymore.
+     */
+    void removeFromOnlineIndex( const BOARD_ITEM* aItem );
+
+    /**
+     * @return the biggest clearance of the items of the online DRC index.
+     */
+    int getOnlineMaxClearance() const;
+
+    /**
+     * Test the items changed by a board commit against the tracks and pads near them,
+     * found in the online DRC index.
+     *
+     * @param aChangedTracks the changed tracks and vias
+     * @param aChangedPads the changed pads
+     * @param aMarkers receives the markers of the problems found
+     */
+    void doIncrementalDrc( const std::vector<TRACK*>& aChangedTracks,
+                           const std::vector<D_PAD*>& aChangedPads,
+                           std::vector<MARKER_PCB*>& aMarkers );
+
     //-----<single tests>----------------------------------------------
 
     /**
@@ -432,6 +565,42 @@ public:
 
     int ShowDRCDialog( const TOOL_EVENT& aEvent );
 
+    ///> Enables or disables the online DRC.
+    int ToggleOnlineDRC( const TOOL_EVENT& aEvent );
+
+    bool IsOnlineDRC() const
+    {
+        return m_onlineDRC;
+    }
+
+    /**
+     * Online DRC: re-test the items changed by a board commit against the items near them,
+     * and replace the markers involving these items.
+     *
+     * Only the track and pad clearance tests are run, so the markers of the other tests are
+     * left as they are until the next full DRC.  All the errors of the changed tracks are
+     * reported, as a full DRC does with "report all track errors".  A pad still gets only its
+     * first error, as in a full DRC, but the pads are not tested in the same order so it can
+     * be another one.
+     *
+     * The undo and redo commands, which do not use board commits, call it with the items they
+     * restored.  The markers are added to the board directly, without another commit.
+     *
+     * @param aChangedItems the items added or modified by the commit
+     * @param aRemovedItems the items removed by the commit
+     */
+    void TestCommitChanges( const std::vector<BOARD_ITEM*>& aChangedItems,
+                            const std::vector<BOARD_ITEM*>& aRemovedItems );
+
+    /**
+     * Make the online DRC index all the tracks and pads again.  Must be called when they are
+     * changed without a board commit.
+     */
+    void InvalidateOnlineIndex()
+    {
+        m_onlineIndexValid = false;
+    }
+
     /**
      * Deletes this ui dialog box and zeros out its pointer to remember
      * the state of the dialog's existence.
@@ -442,12 +611,50 @@ public:
      */
     void DestroyDRCDialog( int aReason );
 
+    /**
+     * Set the optional tests to run, and how to run them.
+     */
+    void SetSettings( bool aPad2PadTest, bool aUnconnectedTest, bool aZonesTest,
+                      bool aKeepoutTest, bool aRefillZones, bool aReportAllTrackErrors );
+
     /**
      * Run all the tests specified with a previous call to
      * SetSettings()
      * @param aMessages = a wxTextControl where to display some activity messages. Can be NULL
      */
     void RunTests( wxTextCtrl* aMessages = NULL );
+
+    /**
+     * Run all the board tests of RunTests() on a board which is not loaded in an editor
+     * frame, e.g. from a command line tool.
+     *
+     * The markers are passed to aMarkerHandler, which takes their ownership, instead of
+     * being added to the board.  The connectivity of the board is built first, zones are
+     * refilled if requested in SetSettings(), and the footprints are not tested against the
+     * schematic.
+     *
+     * @param aBoard the board to test
+     * @param aMarkerHandler the handler receiving the markers
+     * @param aUnits the units used in the marker messages
+     */
+    void RunTests( BOARD* aBoard, DRC_PROVIDER::MARKER_HANDLER aMarkerHandler,
+                   EDA_UNITS_T aUnits );
+
+    /**
+     * @return the unconnected items found by the last run
+     */
+    const DRC_LIST& GetUnconnectedItems() const
+    {
+        return m_unconnected;
+    }
+
+    /**
+     * @return the per phase statistics of the last run, in run order
+     */
+    const std::vector<DRC_PHASE_STATS>& GetPhaseStats() const
+    {
+        return m_phaseStats;
+    }
 };
 
 
@@ -37,7 +37,6 @@
 #include <math_for_graphics.h>
 #include <polygon_test_point_inside.h>
 #include <convert_basic_shapes_to_polygon.h>
-#include <board_commit.h>
 
 
 /**
@@ -110,40 +109,21 @@ bool poly2segmentDRC( wxPoint* aTref, int aTrefCount, wxPoint aSegStart, wxPoint
 #define PUSH_NEW_MARKER_4( a, b, c, d ) push_back( m_markerFactory.NewMarker( a, b, c, d ) )
 
 
-bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterator aEndIt,
-                      bool aTestZones )
+bool DRC::doTrackDrc( TRACK* aRefSeg, const std::vector<TRACK*>& aTracks,
+                      const std::vector<D_PAD*>& aPads, bool aTestZones, bool aTestRefSeg,
+                      bool aReportAllErrors, std::vector<MARKER_PCB*>& aMarkers )
 {
-    TRACK*    track;
     wxPoint   delta;           // length on X and Y axis of segments
     wxPoint   shape_pos;
 
-    std::vector<MARKER_PCB*> markers;
-
-    auto commitMarkers = [&]()
-    {
-        BOARD_COMMIT commit( m_pcbEditorFrame );
-
-        for( MARKER_PCB* marker : markers )
-            commit.Add( marker );
-
-        commit.Push( wxEmptyString, false, false );
-    };
+    size_t    initialMarkerCount = aMarkers.size();
 
     // Returns false if we should return false from call site, or true to continue
     auto handleNewMarker = [&]() -> bool
     {
-        if( !m_reportAllTrackErrors )
-        {
-            if( markers.size() > 0 )
-                commitMarkers();
-
-            return false;
-        }
-        else
-            return true;
+        return aReportAllErrors;
     };
 
-    NETCLASSPTR netclass = aRefSeg->GetNetClass();
     BOARD_DESIGN_SETTINGS& dsnSettings = m_pcb->GetDesignSettings();
 
     /* In order to make some calculations more easier or faster,
@@ -156,7 +136,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
 
     LSET layerMask = aRefSeg->GetLayerSet();
     int  net_code_ref = aRefSeg->GetNetCode();
-    int  ref_seg_clearance  = netclass->GetClearance();
+    int  ref_seg_clearance  = m_clearances->GetItemClearance( aRefSeg );
     int  ref_seg_width = aRefSeg->GetWidth();
 
 
@@ -164,7 +144,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
     /* Phase 0 : via DRC tests :              */
     /******************************************/
 
-    if( aRefSeg->Type() == PCB_VIA_T )
+    if( aTestRefSeg && aRefSeg->Type() == PCB_VIA_T )
     {
         VIA *refvia = static_cast<VIA*>( aRefSeg );
         wxPoint refviaPos = refvia->GetPosition();
@@ -174,7 +154,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
         {
             if( refvia->GetWidth() < dsnSettings.m_MicroViasMinSize )
             {
-                markers.PUSH_NEW_MARKER_3( refviaPos, refvia, DRCE_TOO_SMALL_MICROVIA );
+                aMarkers.PUSH_NEW_MARKER_3( refviaPos, refvia, DRCE_TOO_SMALL_MICROVIA );
 
                 if( !handleNewMarker() )
                     return false;
@@ -182,7 +162,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
 
             if( refvia->GetDrillValue() < dsnSettings.m_MicroViasMinDrill )
             {
-                markers.PUSH_NEW_MARKER_3( refviaPos, refvia, DRCE_TOO_SMALL_MICROVIA_DRILL );
+                aMarkers.PUSH_NEW_MARKER_3( refviaPos, refvia, DRCE_TOO_SMALL_MICROVIA_DRILL );
 
                 if( !handleNewMarker() )
                     return false;
@@ -192,7 +172,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
         {
             if( refvia->GetWidth() < dsnSettings.m_ViasMinSize )
             {
-                markers.PUSH_NEW_MARKER_3( refviaPos, refvia, DRCE_TOO_SMALL_VIA );
+                aMarkers.PUSH_NEW_MARKER_3( refviaPos, refvia, DRCE_TOO_SMALL_VIA );
 
                 if( !handleNewMarker() )
                     return false;
@@ -200,7 +180,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
 
             if( refvia->GetDrillValue() < dsnSettings.m_ViasMinDrill )
             {
-                markers.PUSH_NEW_MARKER_3( refviaPos, refvia, DRCE_TOO_SMALL_VIA_DRILL );
+                aMarkers.PUSH_NEW_MARKER_3( refviaPos, refvia, DRCE_TOO_SMALL_VIA_DRILL );
 
                 if( !handleNewMarker() )
                     return false;
@@ -212,7 +192,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
         // and a default via hole can be bigger than some vias sizes
         if( refvia->GetDrillValue() > refvia->GetWidth() )
         {
-            markers.PUSH_NEW_MARKER_3( refviaPos, refvia, DRCE_VIA_HOLE_BIGGER );
+            aMarkers.PUSH_NEW_MARKER_3( refviaPos, refvia, DRCE_VIA_HOLE_BIGGER );
 
             if( !handleNewMarker() )
                 return false;
@@ -221,7 +201,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
         // test if the type of via is allowed due to design rules
         if( refvia->GetViaType() == VIA_MICROVIA && !dsnSettings.m_MicroViasAllowed )
         {
-            markers.PUSH_NEW_MARKER_3( refviaPos, refvia, DRCE_MICRO_VIA_NOT_ALLOWED );
+            aMarkers.PUSH_NEW_MARKER_3( refviaPos, refvia, DRCE_MICRO_VIA_NOT_ALLOWED );
 
             if( !handleNewMarker() )
                 return false;
@@ -230,7 +210,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
         // test if the type of via is allowed due to design rules
         if( refvia->GetViaType() == VIA_BLIND_BURIED && !dsnSettings.m_BlindBuriedViaAllowed )
         {
-            markers.PUSH_NEW_MARKER_3( refviaPos, refvia, DRCE_BURIED_VIA_NOT_ALLOWED );
+            aMarkers.PUSH_NEW_MARKER_3( refviaPos, refvia, DRCE_BURIED_VIA_NOT_ALLOWED );
 
             if( !handleNewMarker() )
                 return false;
@@ -256,7 +236,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
 
             if( err )
             {
-                markers.PUSH_NEW_MARKER_3( refviaPos, refvia, DRCE_MICRO_VIA_INCORRECT_LAYER_PAIR );
+                aMarkers.PUSH_NEW_MARKER_3( refviaPos, refvia, DRCE_MICRO_VIA_INCORRECT_LAYER_PAIR );
 
                 if( !handleNewMarker() )
                     return false;
@@ -264,13 +244,13 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
         }
 
     }
-    else    // This is a track segment
+    else if( aTestRefSeg )    // This is a track segment
     {
         if( ref_seg_width < dsnSettings.m_TrackMinWidth )
         {
             wxPoint refsegMiddle = ( aRefSeg->GetStart() + aRefSeg->GetEnd() ) / 2;
 
-            markers.PUSH_NEW_MARKER_3( refsegMiddle, aRefSeg, DRCE_TOO_SMALL_TRACK_WIDTH );
+            aMarkers.PUSH_NEW_MARKER_3( refsegMiddle, aRefSeg, DRCE_TOO_SMALL_TRACK_WIDTH );
 
             if( !handleNewMarker() )
                 return false;
@@ -309,58 +289,55 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
     dummypad.SetLayerSet( LSET::AllCuMask() );     // Ensure the hole is on all layers
 
     // Compute the min distance to pads
-    for( MODULE* mod : m_pcb->Modules() )
+    for( D_PAD* pad : aPads )
     {
-        for( D_PAD* pad : mod->Pads() )
-        {
-            SEG padSeg( pad->GetPosition(), pad->GetPosition() );
-
-            // No problem if pads are on another layer, but if a drill hole exists (a pad on
-            // a single layer can have a hole!) we must test the hole
-            if( !( pad->GetLayerSet() & layerMask ).any() )
-            {
-                // We must test the pad hole. In order to use checkClearanceSegmToPad(), a
-                // pseudo pad is used, with a shape and a size like the hole
-                if( pad->GetDrillSize().x == 0 )
-                    continue;
-
-                dummypad.SetSize( pad->GetDrillSize() );
-                dummypad.SetPosition( pad->GetPosition() );
-                dummypad.SetShape( pad->GetDrillShape() == PAD_DRILL_SHAPE_OBLONG ?
-                                   PAD_SHAPE_OVAL : PAD_SHAPE_CIRCLE );
-                dummypad.SetOrientation( pad->GetOrientation() );
-
-                m_padToTestPos = dummypad.GetPosition() - origin;
-
-                if( !checkClearanceSegmToPad( &dummypad, ref_seg_width, ref_seg_clearance ) )
-                {
-                    markers.PUSH_NEW_MARKER_4( aRefSeg, pad, padSeg, DRCE_TRACK_NEAR_THROUGH_HOLE );
-
-                    if( !handleNewMarker() )
-                        return false;
-                }
+        SEG padSeg( pad->GetPosition(), pad->GetPosition() );
 
+        // No problem if pads are on another layer, but if a drill hole exists (a pad on
+        // a single layer can have a hole!) we must test the hole
+        if( !( pad->GetLayerSet() & layerMask ).any() )
+        {
+            // We must test the pad hole. In order to use checkClearanceSegmToPad(), a
+            // pseudo pad is used, with a shape and a size like the hole
+            if( pad->GetDrillSize().x == 0 )
                 continue;
-            }
 
-            // The pad must be in a net (i.e pt_pad->GetNet() != 0 )
-            // but no problem if the pad netcode is the current netcode (same net)
-            if( pad->GetNetCode()                       // the pad must be connected
-               && net_code_ref == pad->GetNetCode() )   // the pad net is the same as current net -> Ok
-                continue;
+            dummypad.SetSize( pad->GetDrillSize() );
+            dummypad.SetPosition( pad->GetPosition() );
+            dummypad.SetShape( pad->GetDrillShape() == PAD_DRILL_SHAPE_OBLONG ?
+                               PAD_SHAPE_OVAL : PAD_SHAPE_CIRCLE );
+            dummypad.SetOrientation( pad->GetOrientation() );
 
-            // DRC for the pad
-            shape_pos = pad->ShapePos();
-            m_padToTestPos = shape_pos - origin;
-            int segToPadClearance = std::max( ref_seg_clearance, pad->GetClearance() );
+            m_padToTestPos = dummypad.GetPosition() - origin;
 
-            if( !checkClearanceSegmToPad( pad, ref_seg_width, segToPadClearance ) )
+            if( !checkClearanceSegmToPad( &dummypad, ref_seg_width, ref_seg_clearance ) )
             {
-                markers.PUSH_NEW_MARKER_4( aRefSeg, pad, padSeg, DRCE_TRACK_NEAR_PAD );
+                aMarkers.PUSH_NEW_MARKER_4( aRefSeg, pad, padSeg, DRCE_TRACK_NEAR_THROUGH_HOLE );
 
                 if( !handleNewMarker() )
                     return false;
             }
+
+            continue;
+        }
+
+        // The pad must be in a net (i.e pt_pad->GetNet() != 0 )
+        // but no problem if the pad netcode is the current netcode (same net)
+        if( pad->GetNetCode()                       // the pad must be connected
+           && net_code_ref == pad->GetNetCode() )   // the pad net is the same as current net -> Ok
+            continue;
+
+        // DRC for the pad
+        shape_pos = pad->ShapePos();
+        m_padToTestPos = shape_pos - origin;
+        int segToPadClearance = m_clearances->GetClearance( aRefSeg, pad );
+
+        if( !checkClearanceSegmToPad( pad, ref_seg_width, segToPadClearance ) )
+        {
+            aMarkers.PUSH_NEW_MARKER_4( aRefSeg, pad, padSeg, DRCE_TRACK_NEAR_PAD );
+
+            if( !handleNewMarker() )
+                return false;
         }
     }
 
@@ -374,9 +351,8 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
     wxPoint segStartPoint;
     wxPoint segEndPoint;
 
-    for( auto it = aStartIt; it != aEndIt; it++ )
+    for( TRACK* track : aTracks )
     {
-        track = *it;
         // No problem if segments have the same net code:
         if( net_code_ref == track->GetNetCode() )
             continue;
@@ -387,7 +363,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
 
         // the minimum distance = clearance plus half the reference track
         // width plus half the other track's width
-        int w_dist = std::max( ref_seg_clearance, track->GetClearance() );
+        int w_dist = m_clearances->GetClearance( aRefSeg, track );
         w_dist += ( ref_seg_width + track->GetWidth() ) / 2;
 
         // Due to many double to int conversions during calculations, which
@@ -409,7 +385,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
                 // Test distance between two vias, i.e. two circles, trivial case
                 if( EuclideanNorm( segStartPoint ) < w_dist )
                 {
-                    markers.PUSH_NEW_MARKER_4( pos, aRefSeg, track, DRCE_VIA_NEAR_VIA );
+                    aMarkers.PUSH_NEW_MARKER_4( pos, aRefSeg, track, DRCE_VIA_NEAR_VIA );
 
                     if( !handleNewMarker() )
                         return false;
@@ -426,7 +402,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
 
                 if( !checkMarginToCircle( segStartPoint, w_dist, delta.x ) )
                 {
-                    markers.PUSH_NEW_MARKER_4( pos, aRefSeg, track, DRCE_VIA_NEAR_TRACK );
+                    aMarkers.PUSH_NEW_MARKER_4( pos, aRefSeg, track, DRCE_VIA_NEAR_TRACK );
 
                     if( !handleNewMarker() )
                         return false;
@@ -452,7 +428,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
             if( checkMarginToCircle( segStartPoint, w_dist, m_segmLength ) )
                 continue;
 
-            markers.PUSH_NEW_MARKER_4( aRefSeg, track, seg, DRCE_TRACK_NEAR_VIA );
+            aMarkers.PUSH_NEW_MARKER_4( aRefSeg, track, seg, DRCE_TRACK_NEAR_VIA );
 
             if( !handleNewMarker() )
                 return false;
@@ -480,7 +456,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
                 // Fine test : we consider the rounded shape of each end of the track segment:
                 if( segStartPoint.x >= 0 && segStartPoint.x <= m_segmLength )
                 {
-                    markers.PUSH_NEW_MARKER_4( aRefSeg, track, seg, DRCE_TRACK_ENDS1 );
+                    aMarkers.PUSH_NEW_MARKER_4( aRefSeg, track, seg, DRCE_TRACK_ENDS1 );
 
                     if( !handleNewMarker() )
                         return false;
@@ -488,7 +464,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
 
                 if( !checkMarginToCircle( segStartPoint, w_dist, m_segmLength ) )
                 {
-                    markers.PUSH_NEW_MARKER_4( aRefSeg, track, seg, DRCE_TRACK_ENDS2 );
+                    aMarkers.PUSH_NEW_MARKER_4( aRefSeg, track, seg, DRCE_TRACK_ENDS2 );
 
                     if( !handleNewMarker() )
                         return false;
@@ -503,7 +479,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
                 // Fine test : we consider the rounded shape of the ends
                 if( segEndPoint.x >= 0 && segEndPoint.x <= m_segmLength )
                 {
-                    markers.PUSH_NEW_MARKER_4( aRefSeg, track, seg, DRCE_TRACK_ENDS3 );
+                    aMarkers.PUSH_NEW_MARKER_4( aRefSeg, track, seg, DRCE_TRACK_ENDS3 );
 
                     if( !handleNewMarker() )
                         return false;
@@ -511,7 +487,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
 
                 if( !checkMarginToCircle( segEndPoint, w_dist, m_segmLength ) )
                 {
-                    markers.PUSH_NEW_MARKER_4( aRefSeg, track, seg, DRCE_TRACK_ENDS4 );
+                    aMarkers.PUSH_NEW_MARKER_4( aRefSeg, track, seg, DRCE_TRACK_ENDS4 );
 
                     if( !handleNewMarker() )
                         return false;
@@ -525,7 +501,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
                 // handled)
                 //  X.............X
                 //    O--REF--+
-                markers.PUSH_NEW_MARKER_4( aRefSeg, track, seg, DRCE_TRACK_SEGMENTS_TOO_CLOSE );
+                aMarkers.PUSH_NEW_MARKER_4( aRefSeg, track, seg, DRCE_TRACK_SEGMENTS_TOO_CLOSE );
 
                 if( !handleNewMarker() )
                     return false;
@@ -545,7 +521,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
                 MARKER_PCB* m = m_markerFactory.NewMarker( aRefSeg, track, seg,
                                                            DRCE_TRACKS_CROSSING );
                 m->SetPosition( wxPoint( track->GetStart().x, aRefSeg->GetStart().y ) );
-                markers.push_back( m );
+                aMarkers.push_back( m );
 
                 if( !handleNewMarker() )
                     return false;
@@ -554,14 +530,14 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
             // At this point the drc error is due to an end near a reference segm end
             if( !checkMarginToCircle( segStartPoint, w_dist, m_segmLength ) )
             {
-                markers.PUSH_NEW_MARKER_4( aRefSeg, track, seg, DRCE_ENDS_PROBLEM1 );
+                aMarkers.PUSH_NEW_MARKER_4( aRefSeg, track, seg, DRCE_ENDS_PROBLEM1 );
 
                 if( !handleNewMarker() )
                     return false;
             }
             if( !checkMarginToCircle( segEndPoint, w_dist, m_segmLength ) )
             {
-                markers.PUSH_NEW_MARKER_4( aRefSeg, track, seg, DRCE_ENDS_PROBLEM2 );
+                aMarkers.PUSH_NEW_MARKER_4( aRefSeg, track, seg, DRCE_ENDS_PROBLEM2 );
 
                 if( !handleNewMarker() )
                     return false;
@@ -605,7 +581,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
                         m = m_markerFactory.NewMarker( aRefSeg, track, seg, DRCE_ENDS_PROBLEM3 );
                     }
 
-                    markers.push_back( m );
+                    aMarkers.push_back( m );
 
                     if( !handleNewMarker() )
                         return false;
@@ -634,7 +610,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
 
                     if( !checkMarginToCircle( relStartPos, w_dist, delta.x ) )
                     {
-                        markers.PUSH_NEW_MARKER_4( aRefSeg, track, seg, DRCE_ENDS_PROBLEM4 );
+                        aMarkers.PUSH_NEW_MARKER_4( aRefSeg, track, seg, DRCE_ENDS_PROBLEM4 );
 
                         if( !handleNewMarker() )
                             return false;
@@ -642,7 +618,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
 
                     if( !checkMarginToCircle( relEndPos, w_dist, delta.x ) )
                     {
-                        markers.PUSH_NEW_MARKER_4( aRefSeg, track, seg, DRCE_ENDS_PROBLEM5 );
+                        aMarkers.PUSH_NEW_MARKER_4( aRefSeg, track, seg, DRCE_ENDS_PROBLEM5 );
 
                         if( !handleNewMarker() )
                             return false;
@@ -658,7 +634,11 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
     // Can be *very* time consumming.
     if( aTestZones )
     {
-        SEG refSeg( aRefSeg->GetStart(), aRefSeg->GetEnd() );
+        SEG    refSeg( aRefSeg->GetStart(), aRefSeg->GetEnd() );
+
+        // The zone markers of a segment come before its other markers, as in the serial
+        // DRC which added them to the board right away and committed the others at the end
+        size_t zoneMarkerPos = initialMarkerCount;
 
         for( ZONE_CONTAINER* zone : m_pcb->Zones() )
         {
@@ -671,17 +651,22 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
             if( zone->GetNetCode() && zone->GetNetCode() == net_code_ref )
                 continue;
 
-            int clearance = std::max( ref_seg_clearance, zone->GetClearance() );
+            int clearance = m_clearances->GetClearance( aRefSeg, zone );
             SHAPE_POLY_SET* outline = const_cast<SHAPE_POLY_SET*>( &zone->GetFilledPolysList() );
 
             if( outline->Distance( refSeg, ref_seg_width ) < clearance )
-                addMarkerToPcb( m_markerFactory.NewMarker( aRefSeg, zone, DRCE_TRACK_NEAR_ZONE ) );
+            {
+                aMarkers.insert( aMarkers.begin() + zoneMarkerPos++,
+                                 m_markerFactory.NewMarker( aRefSeg, zone,
+                                                            DRCE_TRACK_NEAR_ZONE ) );
+            }
         }
     }
 
     /***********************************************/
     /* Phase 4: test DRC with to board edge        */
     /***********************************************/
+    if( aTestRefSeg )
     {
         SEG test_seg( aRefSeg->GetStart(), aRefSeg->GetEnd() );
 
@@ -719,9 +704,9 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
                 BOARD::IterateForward<BOARD_ITEM*>( m_pcb->Drawings(), inspector, nullptr, types );
 
                 if( edge )
-                    markers.PUSH_NEW_MARKER_4( (wxPoint) pt, aRefSeg, edge, DRCE_TRACK_NEAR_EDGE );
+                    aMarkers.PUSH_NEW_MARKER_4( (wxPoint) pt, aRefSeg, edge, DRCE_TRACK_NEAR_EDGE );
                 else
-                    markers.PUSH_NEW_MARKER_3( (wxPoint) pt, aRefSeg, DRCE_TRACK_NEAR_EDGE );
+                    aMarkers.PUSH_NEW_MARKER_3( (wxPoint) pt, aRefSeg, DRCE_TRACK_NEAR_EDGE );
 
                 if( !handleNewMarker() )
                     return false;
@@ -730,13 +715,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
     }
 
 
-    if( markers.size() > 0 )
-    {
-        commitMarkers();
-        return false;
-    }
-    else
-        return true;
+    return aMarkers.size() == initialMarkerCount;
 }
 
 
@@ -746,7 +725,7 @@ bool DRC::checkClearancePadToPad( D_PAD* aRefPad, D_PAD* aPad )
     double pad_angle;
 
     // Get the clearance between the 2 pads. this is the min distance between aRefPad and aPad
-    int     dist_min = aRefPad->GetClearance( aPad );
+    int     dist_min = m_clearances->GetClearance( aRefPad, aPad );
 
     // relativePadPos is the aPad shape position relative to the aRefPad shape position
     wxPoint relativePadPos = aPad->ShapePos() - aRefPad->ShapePos();
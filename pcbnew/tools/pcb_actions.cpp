@@ -170,6 +170,12 @@ TOOL_ACTION PCB_ACTIONS::runDRC( "pcbnew.DRCTool.runDRC",
         _( "Design Rules Checker" ), _( "Show the design rules checker window" ),
         erc_xpm );
 
+TOOL_ACTION PCB_ACTIONS::toggleOnlineDRC( "pcbnew.DRCTool.toggleOnlineDRC",
+        AS_GLOBAL, 0, "",
+        _( "Online DRC" ),
+        _( "Check the clearances of the changed tracks and pads after each edit" ),
+        erc_xpm );
+
 
 // EDIT_TOOL
 //
@@ -325,6 +325,7 @@ public:
     
     static TOOL_ACTION listNets;
     static TOOL_ACTION runDRC;
+    static TOOL_ACTION toggleOnlineDRC;
 
     static TOOL_ACTION editFootprintInFpEditor;
     static TOOL_ACTION showLayersManager;
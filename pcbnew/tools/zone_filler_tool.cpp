@@ -53,8 +53,23 @@ ZONE_FILLER_TOOL::~ZONE_FILLER_TOOL()
 
 void ZONE_FILLER_TOOL::Reset( RESET_REASON aReason )
 {
+    if( aReason == MODEL_RELOAD )
+        InvalidateFills();
 }
 
+
+void ZONE_FILLER_TOOL::MarkDirty( const BOARD_ITEM* aItem )
+{
+    m_fillTracker.MarkDirty( aItem );
+}
+
+
+void ZONE_FILLER_TOOL::InvalidateFills()
+{
+    m_fillTracker.Invalidate();
+}
+
+
 // Zone actions
 int ZONE_FILLER_TOOL::ZoneFill( const TOOL_EVENT& aEvent )
 {
@@ -93,17 +108,19 @@ int ZONE_FILLER_TOOL::ZoneFillAll( const TOOL_EVENT& aEvent )
 
     BOARD_COMMIT commit( this );
 
-    for( auto zone : board()->Zones() )
-    {
-        toFill.push_back(zone);
-    }
+    // When the changes since the last fill are known, only the zones they can affect
+    // need to be refilled
+    m_fillTracker.CollectDirtyZones( board(), toFill );
 
     ZONE_FILLER filler( board(), &commit );
     filler.SetProgressReporter(
             std::make_unique<WX_PROGRESS_REPORTER>( frame(), _( "Fill All Zones" ), 4 ) );
 
-    if( filler.Fill( toFill ) )
+    if( toFill.empty() || filler.Fill( toFill ) )
+    {
         getEditFrame<PCB_EDIT_FRAME>()->m_ZoneFillsDirty = false;
+        m_fillTracker.SetFilled( board() );
+    }
 
     canvas()->Refresh();
 
@@ -26,6 +26,7 @@
 #define ZONE_FILLER_TOOL_H
 
 #include <tools/pcb_tool_base.h>
+#include <zone_filler.h>
 
 
 class PCB_EDIT_FRAME;
@@ -50,9 +51,25 @@ public:
     int ZoneUnfill( const TOOL_EVENT& aEvent );
     int ZoneUnfillAll( const TOOL_EVENT& aEvent );
 
+    /**
+     * Record an item changed by a board commit.  While the changes are tracked, filling
+     * all zones only refills the zones which can be affected by the recorded items.
+     * @param aItem the changed item, before or after the change
+     */
+    void MarkDirty( const BOARD_ITEM* aItem );
+
+    /**
+     * Stop tracking the board changes, so the next zone fill refills all the zones.
+     * Must be called when the board is modified without a board commit.
+     */
+    void InvalidateFills();
+
 private:
     ///> Sets up handlers for various events.
     void setTransitions() override;
+
+    ///> The board changes since the last fill of all zones
+    ZONE_FILL_TRACKER m_fillTracker;
 };
 
 #endif
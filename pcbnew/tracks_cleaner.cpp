@@ -252,7 +252,7 @@ bool TRACKS_CLEANER::testTrackEndpointDangling( TRACK* aTrack )
 
     for( const auto& anchor : anchors )
     {
-        if( anchor->IsDangling() )
+        if( anchor.IsDangling() )
             return true;
     }
 
@@ -281,12 +281,12 @@ bool TRACKS_CLEANER::testTrackEndpointIsNode( TRACK* aTrack, bool aTstStart )
 
     for( const auto& anchor : anchors )
     {
-        if( anchor->Pos() != refpoint )
+        if( anchor.Pos() != refpoint )
             continue;
 
         // The right anchor point is found: if more than one other item
         // (pad, via, track...) is connected, it is a node:
-        return anchor->ConnectedItemsCount() > 1;
+        return anchor.ConnectedItemsCount() > 1;
     }
 
     return false;
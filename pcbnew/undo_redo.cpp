@@ -25,6 +25,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <algorithm>
 #include <functional>
 using namespace std::placeholders;
 #include <fctsys.h>
@@ -45,9 +46,11 @@ using namespace std::placeholders;
 #include <connectivity/connectivity_data.h>
 #include <tool/tool_manager.h>
 #include <tool/actions.h>
+#include <tools/drc.h>
 #include <tools/selection_tool.h>
 #include <tools/pcbnew_control.h>
 #include <tools/pcb_editor_control.h>
+#include <tools/zone_filler_tool.h>
 #include <view/view.h>
 #include <ws_proxy_undo_item.h>
 
@@ -397,6 +400,10 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
     auto view = GetCanvas()->GetView();
     auto connectivity = GetBoard()->GetConnectivity();
 
+    // The items restored for the online DRC, as a board commit would report them
+    std::vector<BOARD_ITEM*> changedItems;
+    std::vector<BOARD_ITEM*> removedItems;
+
     // Undo in the reverse order of list creation: (this can allow stacked changes
     // like the same item can be changes and deleted in the same complex command
 
@@ -474,6 +481,12 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
 
             view->Add( eda_item );
             connectivity->Add( item );
+
+            // The pads of a module are swapped with the ones of its image
+            changedItems.push_back( item );
+
+            if( image )
+                removedItems.push_back( image );
         }
         break;
 
@@ -481,12 +494,14 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
             aList->SetPickedItemStatus( UR_DELETED, ii );
             GetModel()->Remove( (BOARD_ITEM*) eda_item );
             view->Remove( eda_item );
+            removedItems.push_back( (BOARD_ITEM*) eda_item );
             break;
 
         case UR_DELETED:    /* deleted items are put in List, as new items */
             aList->SetPickedItemStatus( UR_NEW, ii );
             GetModel()->Add( (BOARD_ITEM*) eda_item );
             view->Add( eda_item );
+            changedItems.push_back( (BOARD_ITEM*) eda_item );
             break;
 
         case UR_MOVED:
@@ -495,6 +510,7 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
             item->Move( aRedoCommand ? aList->m_TransformPoint : -aList->m_TransformPoint );
             view->Update( item, KIGFX::GEOMETRY );
             connectivity->Update( item );
+            changedItems.push_back( item );
         }
             break;
 
@@ -505,6 +521,7 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
                           aRedoCommand ? m_rotationAngle : -m_rotationAngle );
             view->Update( item, KIGFX::GEOMETRY );
             connectivity->Update( item );
+            changedItems.push_back( item );
         }
             break;
 
@@ -515,6 +532,7 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
                           aRedoCommand ? -m_rotationAngle : m_rotationAngle );
             view->Update( item, KIGFX::GEOMETRY );
             connectivity->Update( item );
+            changedItems.push_back( item );
         }
             break;
 
@@ -524,6 +542,7 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
             item->Flip( aList->m_TransformPoint );
             view->Update( item, KIGFX::LAYERS );
             connectivity->Update( item );
+            changedItems.push_back( item );
         }
             break;
 
@@ -573,6 +592,27 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
     SELECTION_TOOL* selTool = m_toolManager->GetTool<SELECTION_TOOL>();
     selTool->RebuildSelection();
 
+    // Undo and redo do not use board commits, so the zone filler cannot know what changed
+    if( ZONE_FILLER_TOOL* zoneFiller = m_toolManager->GetTool<ZONE_FILLER_TOOL>() )
+        zoneFiller->InvalidateFills();
+
+    // Nor does the online DRC, which is given the restored items instead
+    DRC* drcTool = m_toolManager->GetTool<DRC>();
+
+    if( IsType( FRAME_PCB ) && drcTool && drcTool->IsOnlineDRC() )
+    {
+        // Markers are the output of the DRC, they do not need to be tested
+        auto isMarker = []( BOARD_ITEM* aItem ) { return aItem->Type() == PCB_MARKER_T; };
+
+        changedItems.erase( std::remove_if( changedItems.begin(), changedItems.end(), isMarker ),
+                            changedItems.end() );
+        removedItems.erase( std::remove_if( removedItems.begin(), removedItems.end(), isMarker ),
+                            removedItems.end() );
+
+        if( !changedItems.empty() || !removedItems.empty() )
+            drcTool->TestCommitChanges( changedItems, removedItems );
+    }
+
     GetBoard()->SanitizeNetcodes();
 }
 
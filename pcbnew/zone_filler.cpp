@@ -24,10 +24,9 @@
  */
 
 #include <cstdint>
-#include <thread>
 #include <mutex>
 #include <algorithm>
-#include <future>
+#include <numeric>
 
 #include <class_board.h>
 #include <class_zone.h>
@@ -48,6 +47,7 @@
 #include <geometry/convex_hull.h>
 #include <geometry/geometry_utils.h>
 #include <confirm.h>
+#include <thread_pool.h>
 
 #include "zone_filler.h"
 
@@ -81,7 +81,7 @@ static const bool s_DumpZonesWhenFilling = false;
 
 ZONE_FILLER::ZONE_FILLER(  BOARD* aBoard, COMMIT* aCommit ) :
     m_board( aBoard ), m_brdOutlinesValid( false ), m_commit( aCommit ),
-    m_progressReporter( nullptr )
+    m_progressReporter( nullptr ), m_clearances( nullptr )
 {
 }
 
@@ -130,6 +130,10 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
     m_boardOutline.RemoveAllContours();
     m_brdOutlinesValid = m_board->GetBoardPolygonOutlines( m_boardOutline );
 
+    // Shared (read only) by all the fill threads
+    m_clearances = &m_board->GetClearanceResolver();
+    buildKnockoutIndex();
+
     for( auto zone : aZones )
     {
         // Keepout zones are not filled
@@ -151,54 +155,28 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
         zone->UnFill();
     }
 
-    std::atomic<size_t> nextItem( 0 );
-    size_t              parallelThreadCount =
-            std::min<size_t>( std::thread::hardware_concurrency(), aZones.size() );
-    std::vector<std::future<size_t>> returns( parallelThreadCount );
-
-    auto fill_lambda = [&] ( PROGRESS_REPORTER* aReporter ) -> size_t
+    auto fill_lambda = [&]( size_t aIndex )
     {
-        size_t num = 0;
-
-        for( size_t i = nextItem++; i < toFill.size(); i = nextItem++ )
-        {
-            ZONE_CONTAINER* zone = toFill[i].m_zone;
-            zone->SetFilledPolysUseThickness( filledPolyWithOutline );
-            SHAPE_POLY_SET rawPolys, finalPolys;
-            fillSingleZone( zone, rawPolys, finalPolys );
-
-            zone->SetRawPolysList( rawPolys );
-            zone->SetFilledPolysList( finalPolys );
-            zone->SetIsFilled( true );
+        ZONE_CONTAINER* zone = toFill[aIndex].m_zone;
+        zone->SetFilledPolysUseThickness( filledPolyWithOutline );
+        SHAPE_POLY_SET rawPolys, finalPolys;
+        fillSingleZone( zone, rawPolys, finalPolys );
 
-            if( m_progressReporter )
-                m_progressReporter->AdvanceProgress();
+        zone->SetRawPolysList( rawPolys );
+        zone->SetFilledPolysList( finalPolys );
+        zone->SetIsFilled( true );
 
-            num++;
-        }
-
-        return num;
+        if( m_progressReporter )
+            m_progressReporter->AdvanceProgress();
     };
 
-    if( parallelThreadCount <= 1 )
-        fill_lambda( m_progressReporter );
-    else
+    if( !THREAD_POOL::GetInstance().ParallelFor( toFill.size(), fill_lambda, m_progressReporter ) )
     {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, fill_lambda, m_progressReporter );
-
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            // Here we balance returns with a 100ms timeout to allow UI updating
-            std::future_status status;
-            do
-            {
-                if( m_progressReporter )
-                    m_progressReporter->KeepRefreshing();
+        // Cancelled by the user: the zones not reached yet are left unfilled
+        if( m_commit )
+            m_commit->Revert();
 
-                status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
-            } while( status != std::future_status::ready );
-        }
+        return false;
     }
 
     // Now update the connectivity to check for copper islands
@@ -285,43 +263,21 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
     }
 
 
-    nextItem = 0;
-
-    auto tri_lambda = [&] ( PROGRESS_REPORTER* aReporter ) -> size_t
+    auto tri_lambda = [&]( size_t aIndex )
     {
-        size_t num = 0;
-
-        for( size_t i = nextItem++; i < toFill.size(); i = nextItem++ )
-        {
-            toFill[i].m_zone->CacheTriangulation();
-            num++;
-
-            if( m_progressReporter )
-                m_progressReporter->AdvanceProgress();
-        }
+        toFill[aIndex].m_zone->CacheTriangulation();
 
-        return num;
+        if( m_progressReporter )
+            m_progressReporter->AdvanceProgress();
     };
 
-    if( parallelThreadCount <= 1 )
-        tri_lambda( m_progressReporter );
-    else
+    if( !THREAD_POOL::GetInstance().ParallelFor( toFill.size(), tri_lambda, m_progressReporter ) )
     {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, tri_lambda, m_progressReporter );
-
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            // Here we balance returns with a 100ms timeout to allow UI updating
-            std::future_status status;
-            do
-            {
-                if( m_progressReporter )
-                    m_progressReporter->KeepRefreshing();
+        if( m_commit )
+            m_commit->Revert();
 
-                status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
-            } while( status != std::future_status::ready );
-        }
+        connectivity->SetProgressReporter( nullptr );
+        return false;
     }
 
     if( m_progressReporter )
@@ -488,13 +444,81 @@ void ZONE_FILLER::knockoutThermalReliefs( const ZONE_CONTAINER* aZone, SHAPE_POL
 }
 
 
+void ZONE_FILLER::buildKnockoutIndex()
+{
+    m_knockoutPads.clear();
+    m_knockoutTracks.clear();
+    m_knockoutGraphics.clear();
+    m_padIndex.RemoveAll();
+    m_trackIndex.RemoveAll();
+    m_graphicIndex.RemoveAll();
+
+    int biggestClearance = m_board->GetDesignSettings().GetBiggestClearanceValue();
+
+    for( auto module : m_board->Modules() )
+    {
+        for( auto pad : module->Pads() )
+        {
+            EDA_RECT bbox = pad->GetBoundingBox();
+            LSET     layers = pad->GetLayerSet();
+
+            // A pad hole is knocked out of zones on every copper layer
+            if( pad->GetDrillSize().x || pad->GetDrillSize().y )
+            {
+                int holeRadius = std::max( pad->GetDrillSize().x, pad->GetDrillSize().y ) / 2;
+
+                bbox.Merge( EDA_RECT( pad->GetPosition(), wxSize( 0, 0 ) ).Inflate( holeRadius ) );
+                layers = LSET::AllCuMask();
+            }
+
+            // The hole of a pad is tested with the clearance of a (dummy) pad without net
+            bbox.Inflate( std::max( m_clearances->GetItemClearance( pad ), biggestClearance ) );
+
+            m_padIndex.Insert( m_knockoutPads.size(), bbox, layers );
+            m_knockoutPads.push_back( pad );
+        }
+    }
+
+    for( auto track : m_board->Tracks() )
+    {
+        m_trackIndex.Insert( m_knockoutTracks.size(), track->GetBoundingBox(),
+                             track->GetLayerSet() );
+        m_knockoutTracks.push_back( track );
+    }
+
+    auto addGraphicItem = [&]( BOARD_ITEM* aItem )
+    {
+        LSET layers = aItem->GetLayerSet();
+
+        // A item on the Edge_Cuts is always seen as on any layer
+        if( aItem->IsOnLayer( Edge_Cuts ) )
+            layers = LSET::AllCuMask();
+
+        m_graphicIndex.Insert( m_knockoutGraphics.size(), aItem->GetBoundingBox(), layers );
+        m_knockoutGraphics.push_back( aItem );
+    };
+
+    for( auto module : m_board->Modules() )
+    {
+        addGraphicItem( &module->Reference() );
+        addGraphicItem( &module->Value() );
+
+        for( auto item : module->GraphicalItems() )
+            addGraphicItem( item );
+    }
+
+    for( auto item : m_board->Drawings() )
+        addGraphicItem( item );
+}
+
+
 /**
  * Removes clearance from the shape for copper items which share the zone's layer but are
  * not connected to it.
  */
 void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aHoles )
 {
-    int zone_clearance = aZone->GetClearance();
+    int zone_clearance = m_clearances->GetItemClearance( aZone );
     int edgeClearance = m_board->GetDesignSettings().m_CopperEdgeClearance;
     int zone_to_edgecut_clearance = std::max( aZone->GetZoneClearance(), edgeClearance );
 
@@ -505,6 +529,23 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_
     biggest_clearance = std::max( biggest_clearance, zone_clearance );
     zone_boundingbox.Inflate( biggest_clearance );
 
+    // Copper zones only visit the items indexed near them; the (rare) zones on other layers
+    // visit every item.  Either way, the items are visited in board order.
+    std::vector<int> candidates;
+
+    auto getCandidates = [&]( DRC_RTREE<int>& aIndex, size_t aCount )
+    {
+        if( aZone->IsOnCopperLayer() )
+        {
+            aIndex.Query( zone_boundingbox, LSET( aZone->GetLayer() ), candidates );
+        }
+        else
+        {
+            candidates.resize( aCount );
+            std::iota( candidates.begin(), candidates.end(), 0 );
+        }
+    };
+
     // Use a dummy pad to calculate hole clearance when a pad has a hole but is not on the
     // zone's copper layer.  The dummy pad has the size and shape of the original pad's hole.
     // We have to give it a parent because some functions expect a non-null parent to find
@@ -514,57 +555,62 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_
 
     // Add non-connected pad clearances
     //
-    for( auto module : m_board->Modules() )
+    getCandidates( m_padIndex, m_knockoutPads.size() );
+
+    for( int idx : candidates )
     {
-        for( auto pad : module->Pads() )
+        D_PAD* pad = m_knockoutPads[idx];
+
+        if( !pad->IsOnLayer( aZone->GetLayer() ) )
         {
-            if( !pad->IsOnLayer( aZone->GetLayer() ) )
-            {
-                /*
-                 * Test for pads that are on top or bottom only and have a hole.
-                 * There are curious pads but they can be used for some components that are
-                 * inside the board (in fact inside the hole. Some photo diodes and Leds are
-                 * like this)
-                 */
-                if( pad->GetDrillSize().x == 0 && pad->GetDrillSize().y == 0 )
-                    continue;
-
-                // Use a dummy pad to calculate a hole shape that have the same dimension as
-                // the pad hole
-                dummypad.SetSize( pad->GetDrillSize() );
-                dummypad.SetOrientation( pad->GetOrientation() );
-                dummypad.SetShape( pad->GetDrillShape() == PAD_DRILL_SHAPE_OBLONG ? PAD_SHAPE_OVAL
-                                                                              : PAD_SHAPE_CIRCLE );
-                dummypad.SetPosition( pad->GetPosition() );
-
-                pad = &dummypad;
-            }
+            /*
+             * Test for pads that are on top or bottom only and have a hole.
+             * There are curious pads but they can be used for some components that are
+             * inside the board (in fact inside the hole. Some photo diodes and Leds are
+             * like this)
+             */
+            if( pad->GetDrillSize().x == 0 && pad->GetDrillSize().y == 0 )
+                continue;
 
-            if( pad->GetNetCode() != aZone->GetNetCode()
-                  || pad->GetNetCode() <= 0
-                  || aZone->GetPadConnection( pad ) == PAD_ZONE_CONN_NONE )
-            {
-                int gap = std::max( zone_clearance, pad->GetClearance() );
-                EDA_RECT item_boundingbox = pad->GetBoundingBox();
-                item_boundingbox.Inflate( pad->GetClearance() );
+            // Use a dummy pad to calculate a hole shape that have the same dimension as
+            // the pad hole
+            dummypad.SetSize( pad->GetDrillSize() );
+            dummypad.SetOrientation( pad->GetOrientation() );
+            dummypad.SetShape( pad->GetDrillShape() == PAD_DRILL_SHAPE_OBLONG ? PAD_SHAPE_OVAL
+                                                                          : PAD_SHAPE_CIRCLE );
+            dummypad.SetPosition( pad->GetPosition() );
 
-                if( item_boundingbox.Intersects( zone_boundingbox ) )
-                    addKnockout( pad, gap, aHoles );
-            }
+            pad = &dummypad;
+        }
+
+        if( pad->GetNetCode() != aZone->GetNetCode()
+              || pad->GetNetCode() <= 0
+              || aZone->GetPadConnection( pad ) == PAD_ZONE_CONN_NONE )
+        {
+            int gap = m_clearances->GetClearance( aZone, pad );
+            EDA_RECT item_boundingbox = pad->GetBoundingBox();
+            item_boundingbox.Inflate( m_clearances->GetItemClearance( pad ) );
+
+            if( item_boundingbox.Intersects( zone_boundingbox ) )
+                addKnockout( pad, gap, aHoles );
         }
     }
 
     // Add non-connected track clearances
     //
-    for( auto track : m_board->Tracks() )
+    getCandidates( m_trackIndex, m_knockoutTracks.size() );
+
+    for( int idx : candidates )
     {
+        TRACK* track = m_knockoutTracks[idx];
+
         if( !track->IsOnLayer( aZone->GetLayer() ) )
             continue;
 
         if( track->GetNetCode() == aZone->GetNetCode()  && ( aZone->GetNetCode() != 0) )
             continue;
 
-        int gap = std::max( zone_clearance, track->GetClearance() );
+        int gap = m_clearances->GetClearance( aZone, track );
         EDA_RECT item_boundingbox = track->GetBoundingBox();
 
         if( item_boundingbox.Intersects( zone_boundingbox ) )
@@ -597,17 +643,10 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_
         addKnockout( aItem, gap, ignoreLineWidth, aHoles );
     };
 
-    for( auto module : m_board->Modules() )
-    {
-        doGraphicItem( &module->Reference() );
-        doGraphicItem( &module->Value() );
+    getCandidates( m_graphicIndex, m_knockoutGraphics.size() );
 
-        for( auto item : module->GraphicalItems() )
-            doGraphicItem( item );
-    }
-
-    for( auto item : m_board->Drawings() )
-        doGraphicItem( item );
+    for( int idx : candidates )
+        doGraphicItem( m_knockoutGraphics[idx] );
 
     // Add zones outlines having an higher priority and keepout
     //
@@ -636,10 +675,8 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_
         // connections, etc.).
         bool sameNet = aZone->GetNetCode() == zone->GetNetCode();
         bool useNetClearance = true;
-        int  minClearance = zone_clearance;
-
         // The final clearance is obviously the max value of each zone clearance
-        minClearance = std::max( minClearance, zone->GetClearance() );
+        int  minClearance = m_clearances->GetClearance( aZone, zone );
 
         if( zone->GetIsKeepout() || sameNet )
         {
@@ -1065,3 +1102,119 @@ void ZONE_FILLER::addHatchFillTypeOnZone( const ZONE_CONTAINER* aZone, SHAPE_POL
     // generate strictly simple polygons needed by Gerber files and Fracture()
     aRawPolys.BooleanSubtract( aRawPolys, holes, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
 }
+
+
+ZONE_FILL_TRACKER::ZONE_FILL_TRACKER() :
+    m_fillsTracked( false ),
+    m_fillsRulesRevision( 0 )
+{
+}
+
+
+void ZONE_FILL_TRACKER::MarkDirty( const BOARD_ITEM* aItem )
+{
+    if( !m_fillsTracked )
+        return;
+
+    LSET layers = aItem->GetLayerSet();
+
+    // The board outline clips every zone
+    if( layers.test( Edge_Cuts ) )
+    {
+        Invalidate();
+        return;
+    }
+
+    // The fills keep the items at their own clearance, which can be a local one larger
+    // than the netclass clearances
+    int clearance = 0;
+
+    if( aItem->Type() == PCB_MODULE_T )
+    {
+        // Module pads can be on any copper layer
+        layers |= LSET::AllCuMask();
+
+        for( const D_PAD* pad : static_cast<const MODULE*>( aItem )->Pads() )
+        {
+            clearance = std::max( clearance, pad->GetClearance() );
+
+            if( pad->GetNetCode() > 0 )
+                m_dirtyNets.insert( pad->GetNetCode() );
+        }
+    }
+    else if( aItem->IsConnected() )
+    {
+        auto item = static_cast<const BOARD_CONNECTED_ITEM*>( aItem );
+
+        clearance = item->GetClearance();
+
+        if( item->GetNetCode() > 0 )
+            m_dirtyNets.insert( item->GetNetCode() );
+    }
+
+    EDA_RECT area = aItem->GetBoundingBox();
+    area.Normalize();
+    area.Inflate( clearance );
+
+    m_dirtyAreas.push_back( { area, layers } );
+}
+
+
+void ZONE_FILL_TRACKER::Invalidate()
+{
+    m_fillsTracked = false;
+    m_dirtyAreas.clear();
+    m_dirtyNets.clear();
+}
+
+
+void ZONE_FILL_TRACKER::SetFilled( const BOARD* aBoard )
+{
+    // The fill commit itself does not change the other zones' fills
+    m_dirtyAreas.clear();
+    m_dirtyNets.clear();
+    m_fillsTracked = true;
+    m_fillsRulesRevision = aBoard->GetDesignRulesRevision();
+}
+
+
+void ZONE_FILL_TRACKER::CollectDirtyZones( BOARD* aBoard,
+                                           std::vector<ZONE_CONTAINER*>& aZones ) const
+{
+    // A change of the clearances or netclasses can affect any zone
+    if( !m_fillsTracked || m_fillsRulesRevision != aBoard->GetDesignRulesRevision() )
+    {
+        for( ZONE_CONTAINER* zone : aBoard->Zones() )
+            aZones.push_back( zone );
+
+        return;
+    }
+
+    // A zone fill depends on the items lying within their clearance and thermal relief
+    // gap of the zone outline.  The dirty areas already include the item clearances.
+    int biggestClearance = aBoard->GetDesignSettings().GetBiggestClearanceValue();
+
+    for( ZONE_CONTAINER* zone : aBoard->Zones() )
+    {
+        if( zone->GetNetCode() > 0 && m_dirtyNets.count( zone->GetNetCode() ) )
+        {
+            aZones.push_back( zone );
+            continue;
+        }
+
+        EDA_RECT zoneBox = zone->GetBoundingBox();
+        zoneBox.Inflate( std::max( zone->GetClearance(), biggestClearance )
+                         + zone->GetThermalReliefGap() + zone->GetMinThickness() );
+
+        LSET zoneLayers = zone->GetLayerSet();
+
+        for( const DIRTY_AREA& dirty : m_dirtyAreas )
+        {
+            if( ( dirty.m_Layers & zoneLayers ).any() && dirty.m_Area.Intersects( zoneBox ) )
+            {
+                aZones.push_back( zone );
+                break;
+            }
+        }
+    }
+}
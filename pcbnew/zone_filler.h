@@ -26,11 +26,14 @@
 #ifndef __ZONE_FILLER_H
 #define __ZONE_FILLER_H
 
+#include <set>
 #include <vector>
 #include <class_zone.h>
+#include <drc/drc_rtree.h>
 
 class WX_PROGRESS_REPORTER;
 class BOARD;
+class CLEARANCE_RESOLVER;
 class COMMIT;
 class SHAPE_POLY_SET;
 class SHAPE_LINE_CHAIN;
@@ -54,6 +57,13 @@ private:
 
     void knockoutThermalReliefs( const ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aFill );
 
+    /**
+     * Function buildKnockoutIndex
+     * Builds the spatial indexes of the pads, tracks and graphic items which can be knocked
+     * out of the copper zones, so each zone only visits the items near it.
+     */
+    void buildKnockoutIndex();
+
     void buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aHoles );
 
     /**
@@ -108,6 +118,18 @@ private:
                                         // false if not (not closed outlines for instance)
     COMMIT* m_commit;
     WX_PROGRESS_REPORTER* m_progressReporter;
+
+    // The clearances of the board items, shared (read only) by all the fill threads
+    const CLEARANCE_RESOLVER* m_clearances;
+
+    // Items which can be knocked out of zones, in board order, and their per copper layer
+    // indexes (of positions in these lists).  Built once per Fill() call.
+    std::vector<D_PAD*>      m_knockoutPads;
+    std::vector<TRACK*>      m_knockoutTracks;
+    std::vector<BOARD_ITEM*> m_knockoutGraphics;
+    DRC_RTREE<int>           m_padIndex;
+    DRC_RTREE<int>           m_trackIndex;
+    DRC_RTREE<int>           m_graphicIndex;
     std::unique_ptr<WX_PROGRESS_REPORTER> m_uniqueReporter;
 
     // m_high_def can be used to define a high definition arc to polygon approximation
@@ -120,4 +142,58 @@ private:
     int m_low_def;
 };
 
+
+/**
+ * Class ZONE_FILL_TRACKER
+ * Records the board changes made since all the zones were filled, to find the zones whose
+ * fill they can change.  A zone is affected by the items changed near its outline, and by
+ * any change of the connectivity of its net, which decides what islands are removed.
+ */
+class ZONE_FILL_TRACKER
+{
+public:
+    ZONE_FILL_TRACKER();
+
+    /**
+     * Record a changed item.  Items are recorded both before and after their change.
+     */
+    void MarkDirty( const BOARD_ITEM* aItem );
+
+    /**
+     * Stop tracking the board changes, so all the zones are affected.
+     */
+    void Invalidate();
+
+    /**
+     * Start tracking the board changes, once all the zones of aBoard are filled.
+     */
+    void SetFilled( const BOARD* aBoard );
+
+    /**
+     * Collect the zones of aBoard affected by the changes recorded since the last call of
+     * SetFilled(): all of them if the changes were not tracked.
+     */
+    void CollectDirtyZones( BOARD* aBoard, std::vector<ZONE_CONTAINER*>& aZones ) const;
+
+private:
+    struct DIRTY_AREA
+    {
+        EDA_RECT m_Area;            ///< Bounding box of an item, inflated by its clearance
+        LSET     m_Layers;
+    };
+
+    std::vector<DIRTY_AREA> m_dirtyAreas;
+
+    ///> Nets of the changed items, whose zones may have gained or lost islands
+    std::set<int> m_dirtyNets;
+
+    ///> true if all the board changes since the last fill of all zones are recorded
+    bool m_fillsTracked;
+
+    ///> Design rules revision of the board at the last fill of all zones.  The design settings
+    ///> and the netclasses are changed without board commits, so the recorded changes cannot
+    ///> be trusted once it differs from BOARD::GetDesignRulesRevision()
+    unsigned m_fillsRulesRevision;
+};
+
 #endif
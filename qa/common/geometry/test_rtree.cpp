@@ -0,0 +1,157 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/rtree.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+
+// Ids are pointer-sized, like the items of the real indexes
+typedef RTree<intptr_t, int, 2, double> TEST_RTREE;
+
+
+/**
+ * A grid of aCount x aCount 10x10 boxes, 20 units apart, numbered row by row
+ */
+static std::vector<TEST_RTREE::BulkItem> makeGrid( int aCount )
+{
+    std::vector<TEST_RTREE::BulkItem> items;
+
+    for( int y = 0; y < aCount; ++y )
+    {
+        for( int x = 0; x < aCount; ++x )
+        {
+            items.push_back(
+                    { { x * 20, y * 20 }, { x * 20 + 10, y * 20 + 10 }, y * aCount + x } );
+        }
+    }
+
+    return items;
+}
+
+
+/**
+ * @return the sorted ids found in the given box
+ */
+static std::vector<intptr_t> search( TEST_RTREE& aTree, int aMinX, int aMinY, int aMaxX,
+                                     int aMaxY )
+{
+    const int             min[2] = { aMinX, aMinY };
+    const int             max[2] = { aMaxX, aMaxY };
+    std::vector<intptr_t> found;
+
+    auto visitor = [&found]( intptr_t aId ) -> bool
+    {
+        found.push_back( aId );
+        return true;
+    };
+
+    aTree.Search( min, max, visitor );
+    std::sort( found.begin(), found.end() );
+
+    return found;
+}
+
+
+BOOST_AUTO_TEST_SUITE( Rtree )
+
+
+/**
+ * A bulk loaded tree finds the same items as one built by insertion
+ */
+BOOST_AUTO_TEST_CASE( BulkLoadMatchesInsertion )
+{
+    const std::vector<TEST_RTREE::BulkItem> items = makeGrid( 50 );
+
+    TEST_RTREE inserted;
+    TEST_RTREE bulk;
+
+    for( const TEST_RTREE::BulkItem& item : items )
+        inserted.Insert( item.m_min, item.m_max, item.m_data );
+
+    bulk.BulkLoad( items );
+
+    BOOST_CHECK_EQUAL( bulk.Count(), (int) items.size() );
+
+    for( int pos = 0; pos < 1000; pos += 35 )
+    {
+        BOOST_TEST_CONTEXT( "Position " << pos )
+        {
+            BOOST_CHECK( search( bulk, pos, pos, pos + 50, pos + 15 )
+                         == search( inserted, pos, pos, pos + 50, pos + 15 ) );
+        }
+    }
+
+    BOOST_CHECK( search( bulk, 20, 20, 30, 30 ) == std::vector<intptr_t>( { 51 } ) );
+}
+
+
+/**
+ * Bulk loading keeps the existing items, and the tree can still be modified afterwards
+ */
+BOOST_AUTO_TEST_CASE( BulkLoadThenModify )
+{
+    std::vector<TEST_RTREE::BulkItem> items = makeGrid( 10 );
+
+    TEST_RTREE tree;
+    tree.Insert( items[0].m_min, items[0].m_max, items[0].m_data );
+
+    tree.BulkLoad( std::vector<TEST_RTREE::BulkItem>( items.begin() + 1, items.end() ) );
+    BOOST_CHECK_EQUAL( tree.Count(), 100 );
+    BOOST_CHECK( search( tree, 0, 0, 10, 10 ) == std::vector<intptr_t>( { 0 } ) );
+
+    for( const TEST_RTREE::BulkItem& item : items )
+    {
+        if( item.m_data % 2 )
+            BOOST_CHECK( !tree.Remove( item.m_min, item.m_max, item.m_data ) );
+    }
+
+    const int extra[2] = { 5, 5 };
+    tree.Insert( extra, extra, 1000 );
+
+    BOOST_CHECK_EQUAL( tree.Count(), 51 );
+    BOOST_CHECK( search( tree, 0, 0, 30, 10 ) == std::vector<intptr_t>( { 0, 1000 } ) );
+}
+
+
+/**
+ * Bulk loading nothing leaves an empty, usable tree
+ */
+BOOST_AUTO_TEST_CASE( BulkLoadEmpty )
+{
+    TEST_RTREE tree;
+
+    tree.BulkLoad( {} );
+    BOOST_CHECK_EQUAL( tree.Count(), 0 );
+    BOOST_CHECK( search( tree, -100, -100, 100, 100 ).empty() );
+
+    const int point[2] = { 0, 0 };
+    tree.Insert( point, point, 1 );
+    BOOST_CHECK( search( tree, -100, -100, 100, 100 ) == std::vector<intptr_t>( { 1 } ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
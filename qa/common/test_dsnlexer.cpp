@@ -0,0 +1,83 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_dsnlexer.cpp
+ * Test suite for the keyword lookup of the generated DSNLEXERs
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <lib_table_lexer.h>
+
+
+BOOST_AUTO_TEST_SUITE( DsnLexer )
+
+
+/**
+ * Every keyword of the grammar is found by the generated lookup
+ */
+BOOST_AUTO_TEST_CASE( Keywords )
+{
+    using namespace LIB_TABLE_T;
+
+    const T keywords[] = { T_fp_lib_table, T_sym_lib_table, T_lib, T_name, T_type, T_uri,
+                           T_options, T_descr, T_disabled };
+
+    for( T keyword : keywords )
+    {
+        std::string text = LIB_TABLE_LEXER::TokenName( keyword );
+
+        BOOST_TEST_CONTEXT( text )
+        {
+            LIB_TABLE_LEXER lexer( text, "keywords" );
+
+            BOOST_CHECK_EQUAL( lexer.NextTok(), keyword );
+        }
+    }
+}
+
+
+/**
+ * Text which only looks like a keyword is a symbol
+ */
+BOOST_AUTO_TEST_CASE( Symbols )
+{
+    using namespace LIB_TABLE_T;
+
+    const std::string symbols[] = { "l", "li", "lid", "libs", "Lib", "uri_", "descr2",
+                                    "sym_lib_tablf" };
+
+    for( const std::string& text : symbols )
+    {
+        BOOST_TEST_CONTEXT( text )
+        {
+            LIB_TABLE_LEXER lexer( text, "symbols" );
+
+            BOOST_CHECK_EQUAL( lexer.NextTok(), T_SYMBOL );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -31,6 +31,8 @@
 // Code under test
 #include <kicad_string.h>
 
+#include <cmath>
+
 /**
  * Declare the test suite
  */
@@ -107,4 +109,53 @@ BOOST_AUTO_TEST_CASE( NaturalNumberCompare )
     }
 }
 
+/**
+ * Test the #StrToDouble method against strtod() in the "C" locale.
+ */
+BOOST_AUTO_TEST_CASE( StringToDouble )
+{
+    const std::vector<std::string> cases = {
+        "0", "-0", "12.7", "-0.5", " 3.25)", ".5", "1.", "+42 x", "2147.483647", "0.1",
+        "1.2345678901234", "123456789012345678", "0.00000000000000000000000123", "1.5.3",
+        "1e3", "-2.5E-3", "0x10", "inf", "-", "", "abc",
+    };
+
+    for( const auto& c : cases )
+    {
+        char*  end;
+        char*  expectedEnd;
+        double value = StrToDouble( c.c_str(), &end );
+        double expected = strtod( c.c_str(), &expectedEnd );
+
+        BOOST_TEST_CONTEXT( "Text \"" << c << "\"" )
+        {
+            BOOST_CHECK_EQUAL( value, expected );
+            BOOST_CHECK_EQUAL( std::signbit( value ), std::signbit( expected ) );
+            BOOST_CHECK_EQUAL( end - c.c_str(), expectedEnd - c.c_str() );
+        }
+    }
+}
+
+/**
+ * Test the #FormatDouble method.
+ */
+BOOST_AUTO_TEST_CASE( FormatDoubleValues )
+{
+    using CASE = std::pair<std::pair<std::string, double>, std::string>;
+
+    const std::vector<CASE> cases = {
+        { { "%g", 1.5 }, "1.5" },
+        { { "%.10g", -0.000001 }, "-1e-06" },
+        { { "%f", -2.25 }, "-2.250000" },
+        { { "%g", 1e20 }, "1e+20" },
+        { { "%-6g|", 3.5 }, "3.5   |" },
+        { { "%.10g", 2147.483647 }, "2147.483647" },
+    };
+
+    for( const auto& c : cases )
+    {
+        BOOST_CHECK_EQUAL( FormatDouble( c.first.first.c_str(), c.first.second ), c.second );
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,268 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the LINE_READERs and OUTPUTFORMATTERs
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <richio.h>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+#include <wx/mstream.h>
+#include <wx/zstream.h>
+
+#if !defined( _WIN32 )
+#include <unistd.h>     // ftruncate()
+#endif
+
+
+/**
+ * A temporary file holding the given text, removed when going out of scope
+ */
+class TEMP_TEXT_FILE
+{
+public:
+    TEMP_TEXT_FILE( const std::string& aText )
+    {
+        m_name = wxFileName::CreateTempFileName( "richio" );
+
+        wxFFile file( m_name, "wb" );
+        file.Write( aText.c_str(), aText.size() );
+    }
+
+    ~TEMP_TEXT_FILE()
+    {
+        wxRemoveFile( m_name );
+    }
+
+    const wxString& GetName() const
+    {
+        return m_name;
+    }
+
+private:
+    wxString m_name;
+};
+
+
+/**
+ * Declare the test suite
+ */
+BOOST_AUTO_TEST_SUITE( RichIO )
+
+
+/**
+ * The mapped reader hands out the same lines as the string reader, in place or as nul
+ * terminated copies
+ */
+BOOST_AUTO_TEST_CASE( MmapMatchesString )
+{
+    const std::vector<std::string> texts = {
+        "(kicad_pcb (version 20171130)\n  (layers)\n)\n",
+        "no final newline\n\nlast",
+        "\n",
+        "",
+    };
+
+    for( const std::string& text : texts )
+    {
+        for( bool nulTerminated : { false, true } )
+        {
+            BOOST_TEST_CONTEXT( "Text \"" << text << "\", nul terminated " << nulTerminated )
+            {
+                TEMP_TEXT_FILE     file( text );
+                MMAP_LINE_READER   mmapReader( file.GetName(), nulTerminated );
+                STRING_LINE_READER stringReader( text, "test" );
+
+                while( true )
+                {
+                    char* expected = stringReader.ReadLine();
+                    char* line = mmapReader.ReadLine();
+
+                    BOOST_CHECK_EQUAL( line == nullptr, expected == nullptr );
+                    BOOST_CHECK_EQUAL( mmapReader.LineNumber(), stringReader.LineNumber() );
+                    BOOST_CHECK_EQUAL( mmapReader.Length(), stringReader.Length() );
+
+                    if( !line || !expected )
+                        break;
+
+                    BOOST_CHECK_EQUAL( std::string( line, mmapReader.Length() ),
+                                       std::string( expected ) );
+
+                    if( nulTerminated )
+                        BOOST_CHECK_EQUAL( line[ mmapReader.Length() ], 0 );
+                }
+            }
+        }
+    }
+}
+
+
+/**
+ * Lines are found again after seeking and rewinding, with their line numbers
+ */
+BOOST_AUTO_TEST_CASE( MmapSeek )
+{
+    TEMP_TEXT_FILE   file( "abc\ndef\nghi" );
+    MMAP_LINE_READER reader( file.GetName() );
+
+    reader.ReadLine();
+    size_t offset = reader.Tell();
+
+    BOOST_CHECK_EQUAL( std::string( reader.ReadLine(), reader.Length() ), "def\n" );
+
+    reader.Rewind();
+    BOOST_CHECK_EQUAL( std::string( reader.ReadLine(), reader.Length() ), "abc\n" );
+    BOOST_CHECK_EQUAL( reader.LineNumber(), 1u );
+
+    reader.Seek( offset, 2 );
+    BOOST_CHECK_EQUAL( std::string( reader.ReadLine(), reader.Length() ), "def\n" );
+    BOOST_CHECK_EQUAL( reader.LineNumber(), 2u );
+    BOOST_CHECK_EQUAL( std::string( reader.ReadLine() ), "ghi" );
+}
+
+
+#if !defined( _WIN32 )
+/**
+ * A file which shrinks while it is read is read up to its new end, from the file
+ */
+BOOST_AUTO_TEST_CASE( MmapFileSizeChange )
+{
+    std::string text;
+
+    // Longer than the interval between two checks of the file size
+    for( int ii = 0; text.size() < 3 * 1024 * 1024; ++ii )
+        text += "line " + std::to_string( ii ) + "\n";
+
+    TEMP_TEXT_FILE   file( text );
+    MMAP_LINE_READER reader( file.GetName() );
+    size_t           newSize = text.rfind( '\n', 2 * 1024 * 1024 ) + 1;
+
+    BOOST_REQUIRE( reader.ReadLine() );
+
+    {
+        wxFFile shrunk( file.GetName(), "r+b" );
+        BOOST_REQUIRE( shrunk.IsOpened() );
+        BOOST_REQUIRE( ftruncate( fileno( shrunk.fp() ), newSize ) == 0 );
+    }
+
+    std::string read( reader.Line(), reader.Length() );
+
+    while( reader.ReadLine() )
+        read.append( reader.Line(), reader.Length() );
+
+    BOOST_CHECK( read == text.substr( 0, newSize ) );
+    BOOST_CHECK_EQUAL( reader.Tell(), newSize );
+}
+#endif
+
+
+/**
+ * A missing file throws, as with the FILE_LINE_READER
+ */
+BOOST_AUTO_TEST_CASE( MmapMissingFile )
+{
+    BOOST_CHECK_THROW( MMAP_LINE_READER( "/this/file/does/not/exist" ), IO_ERROR );
+}
+
+
+/**
+ * Output enough to go through several blocks of a BUFFERED_OUTPUTFORMATTER
+ */
+static void formatTestOutput( OUTPUTFORMATTER& aFormatter )
+{
+    aFormatter.Print( 0, "(kicad_pcb (version %d)\n", 20171130 );
+
+    for( int i = 0; i < 20000; ++i )
+    {
+        aFormatter.Print( i % 25, "(segment (start %d %d) (width %s)", i, -i, "0.25" );
+        aFormatter.Print( 0, ")\n" );
+    }
+
+    aFormatter.Print( 0, ")\n" );
+}
+
+
+/**
+ * The file formatter writes what the string formatter holds
+ */
+BOOST_AUTO_TEST_CASE( FileFormatterMatchesString )
+{
+    TEMP_TEXT_FILE   file( "" );
+    STRING_FORMATTER expected;
+
+    formatTestOutput( expected );
+
+    {
+        FILE_OUTPUTFORMATTER formatter( file.GetName(), wxT( "wb" ) );
+
+        formatTestOutput( formatter );
+        formatter.Finish();
+    }
+
+    wxFFile     result( file.GetName(), "rb" );
+    std::string text( result.Length(), '\0' );
+
+    result.Read( &text[0], text.size() );
+
+    BOOST_CHECK_GT( text.size(), (size_t) OUTPUTFMTBLOCKZ );
+    BOOST_CHECK( text == expected.GetString() );
+}
+
+
+/**
+ * The stream formatter can write gzip compressed output
+ */
+BOOST_AUTO_TEST_CASE( StreamFormatterGzip )
+{
+    STRING_FORMATTER     expected;
+    wxMemoryOutputStream compressed;
+
+    formatTestOutput( expected );
+
+    {
+        wxZlibOutputStream     zlibStream( compressed, -1, wxZLIB_GZIP );
+        STREAM_OUTPUTFORMATTER formatter( zlibStream );
+
+        formatTestOutput( formatter );
+        formatter.Finish();
+    }
+
+    wxMemoryInputStream compressedInput( compressed );
+    wxZlibInputStream   zlibInput( compressedInput, wxZLIB_GZIP );
+    std::string         text;
+    char                buffer[4096];
+
+    while( zlibInput.Read( buffer, sizeof( buffer ) ).LastRead() > 0 )
+        text.append( buffer, zlibInput.LastRead() );
+
+    BOOST_CHECK_LT( compressed.GetLength(), expected.GetString().size() );
+    BOOST_CHECK( text == expected.GetString() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
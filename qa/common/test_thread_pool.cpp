@@ -0,0 +1,163 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for THREAD_POOL
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <stdexcept>
+
+// Code under test
+#include <thread_pool.h>
+
+/**
+ * Declare the test suite
+ */
+BOOST_AUTO_TEST_SUITE( ThreadPool )
+
+
+/**
+ * Each index is run exactly once, whatever the number of workers
+ */
+BOOST_AUTO_TEST_CASE( EachIndexOnce )
+{
+    for( size_t threads : { 1, 2, 4 } )
+    {
+        BOOST_TEST_CONTEXT( "Threads: " << threads )
+        {
+            THREAD_POOL                    pool( threads );
+            std::vector<std::atomic<int>> counts( 1000 );
+
+            for( std::atomic<int>& count : counts )
+                count = 0;
+
+            BOOST_CHECK( pool.ParallelFor( counts.size(), [&]( size_t i ) { counts[i]++; } ) );
+
+            for( std::atomic<int>& count : counts )
+                BOOST_CHECK_EQUAL( count, 1 );
+        }
+    }
+}
+
+
+/**
+ * Empty loops, and loops shorter than the number of threads
+ */
+BOOST_AUTO_TEST_CASE( ShortLoops )
+{
+    THREAD_POOL       pool( 4 );
+    std::atomic<int>  total( 0 );
+
+    BOOST_CHECK( pool.ParallelFor( 0, [&]( size_t i ) { total++; } ) );
+    BOOST_CHECK_EQUAL( total, 0 );
+
+    BOOST_CHECK( pool.ParallelFor( 2, [&]( size_t i ) { total += i + 1; } ) );
+    BOOST_CHECK_EQUAL( total, 3 );
+}
+
+
+/**
+ * Loops started from the tasks of another loop complete, without deadlocks
+ */
+BOOST_AUTO_TEST_CASE( Nested )
+{
+    THREAD_POOL       pool( 2 );
+    std::atomic<int>  total( 0 );
+
+    pool.ParallelFor( 20,
+            [&]( size_t i )
+            {
+                pool.ParallelFor( 50, [&]( size_t j ) { total++; } );
+            } );
+
+    BOOST_CHECK_EQUAL( total, 20 * 50 );
+}
+
+
+/**
+ * An exception thrown by an iteration, on a worker or the calling thread, stops the loop and
+ * is rethrown by it, and the pool keeps working
+ */
+BOOST_AUTO_TEST_CASE( Exceptions )
+{
+    for( size_t threads : { 1, 2, 4 } )
+    {
+        BOOST_TEST_CONTEXT( "Threads: " << threads )
+        {
+            THREAD_POOL       pool( threads );
+            std::atomic<int>  total( 0 );
+
+            // Every runner throws, including the one of the calling thread
+            BOOST_CHECK_THROW( pool.ParallelFor( 100,
+                                                 [&]( size_t i )
+                                                 {
+                                                     throw std::runtime_error( "every" );
+                                                 } ),
+                               std::runtime_error );
+
+            // A single failing iteration skips the ones which are not started yet
+            BOOST_CHECK_THROW( pool.ParallelFor( 1000,
+                                                 [&]( size_t i )
+                                                 {
+                                                     if( i == 10 )
+                                                         throw std::runtime_error( "one" );
+
+                                                     total++;
+                                                 } ),
+                               std::runtime_error );
+
+            BOOST_CHECK_LT( total, 1000 );
+
+            // Failing nested loops are seen by the iterations of the outer loop
+            total = 0;
+
+            BOOST_CHECK( pool.ParallelFor( 10,
+                    [&]( size_t i )
+                    {
+                        try
+                        {
+                            pool.ParallelFor( 10,
+                                    [&]( size_t j )
+                                    {
+                                        throw std::runtime_error( "nested" );
+                                    } );
+                        }
+                        catch( const std::runtime_error& )
+                        {
+                            total++;
+                        }
+                    } ) );
+
+            BOOST_CHECK_EQUAL( total, 10 );
+
+            total = 0;
+            BOOST_CHECK( pool.ParallelFor( 100, [&]( size_t i ) { total++; } ) );
+            BOOST_CHECK_EQUAL( total, 100 );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -29,6 +29,7 @@
 
 #include "sexpr_parse.h"
 
+#include <sexpr/sexpr_document.h>
 #include <sexpr/sexpr_parser.h>
 
 #include <common.h>
@@ -64,6 +65,50 @@ public:
         return sexpr != nullptr;
     }
 
+    /**
+     * Parse the stream \a aRepeats times with both SEXPR::PARSER and SEXPR::DOCUMENT and
+     * print the average time each of them takes, including the release of the tree.
+     */
+    bool Benchmark( std::istream& aStream, long aRepeats )
+    {
+        const std::string sexpr_str( std::istreambuf_iterator<char>( aStream ), {} );
+
+        double parserTime = 0.0;
+        double documentTime = 0.0;
+        size_t arenaSize = 0;
+        bool   ok = true;
+
+        for( long i = 0; i < aRepeats; i++ )
+        {
+            PROF_COUNTER parserTimer;
+
+            {
+                std::unique_ptr<SEXPR::SEXPR> sexpr( m_parser.Parse( sexpr_str ) );
+                ok = ok && sexpr != nullptr;
+            }
+
+            parserTime += parserTimer.msecs();
+
+            // The document keeps its text, the copy is not part of the parse
+            std::string  text( sexpr_str );
+            PROF_COUNTER documentTimer;
+
+            {
+                SEXPR::DOCUMENT document;
+                ok = ok && document.Parse( std::move( text ) ) != nullptr;
+                arenaSize = document.GetArenaSize();
+            }
+
+            documentTime += documentTimer.msecs();
+        }
+
+        std::cout << "PARSER:   " << parserTime / aRepeats << "ms" << std::endl;
+        std::cout << "DOCUMENT: " << documentTime / aRepeats << "ms (arena " << arenaSize / 1024
+                  << " KiB)" << std::endl;
+
+        return ok;
+    }
+
 private:
     bool          m_verbose;
     SEXPR::PARSER m_parser;
@@ -84,6 +129,13 @@ static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
             "verbose",
             _( "print parsing information" ).mb_str(),
     },
+    {
+            wxCMD_LINE_OPTION,
+            "b",
+            "benchmark",
+            _( "compare the parsers, averaging the given number of runs" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
     {
             wxCMD_LINE_PARAM,
             nullptr,
@@ -118,6 +170,9 @@ int sexpr_parser_func( int argc, char* argv[] )
     const auto file_count = cl_parser.GetParamCount();
     const bool verbose = cl_parser.Found( "verbose" );
 
+    long repeats = 0;
+    cl_parser.Found( "benchmark", &repeats );
+
     QA_SEXPR_PARSER qa_parser( verbose );
 
     bool ok = true;
@@ -126,7 +181,10 @@ int sexpr_parser_func( int argc, char* argv[] )
     {
         // Parse the file provided on stdin - used by AFL to drive the
         // program
-        qa_parser.Parse( std::cin );
+        if( repeats > 0 )
+            ok = qa_parser.Benchmark( std::cin, repeats );
+        else
+            qa_parser.Parse( std::cin );
     }
     else
     {
@@ -143,7 +201,10 @@ int sexpr_parser_func( int argc, char* argv[] )
             std::ifstream fin;
             fin.open( filename );
 
-            ok = ok && qa_parser.Parse( fin );
+            if( repeats > 0 )
+                ok = qa_parser.Benchmark( fin, repeats ) && ok;
+            else
+                ok = ok && qa_parser.Parse( fin );
         }
     }
 
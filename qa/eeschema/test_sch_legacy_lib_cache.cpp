@@ -0,0 +1,200 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_sch_legacy_lib_cache.cpp
+ * Test suite for the symbol library cache of the legacy schematic plugin
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <wx/dir.h>
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+// Code under test
+#include <sch_io_mgr.h>
+#include <sch_legacy_plugin.h>
+#include <properties.h>
+#include <class_libentry.h>
+#include <lib_pin.h>
+
+
+static const char legacyLibrary[] =
+        "EESchema-LIBRARY Version 2.4\n"
+        "#encoding utf-8\n"
+        "#\n"
+        "# R\n"
+        "#\n"
+        "DEF R R 0 0 N Y 1 F N\n"
+        "F0 \"R\" 80 0 50 V V C CNN\n"
+        "F1 \"R\" 0 0 50 V V C CNN\n"
+        "ALIAS R_Small\n"
+        "DRAW\n"
+        "S -40 -100 40 100 0 1 10 N\n"
+        "X ~ 1 0 150 50 D 50 50 1 1 P\n"
+        "X ~ 2 0 -150 50 U 50 50 1 1 P\n"
+        "ENDDRAW\n"
+        "ENDDEF\n"
+        "#\n"
+        "# TP\n"
+        "#\n"
+        "DEF TP TP 0 30 N N 1 F N\n"
+        "F0 \"TP\" 0 100 50 H V C CNN\n"
+        "F1 \"TP\" 0 -100 50 H V C CNN\n"
+        "DRAW\n"
+        "C 0 0 30 0 1 0 N\n"
+        "X 1 1 0 -100 70 U 50 50 1 1 P\n"
+        "ENDDRAW\n"
+        "ENDDEF\n"
+        "#\n"
+        "#End Library\n";
+
+
+/**
+ * A legacy symbol library in a temporary file, with a temporary folder for its index.  Both
+ * are removed when going out of scope.
+ */
+class TEMP_SYMBOL_LIBRARY
+{
+public:
+    TEMP_SYMBOL_LIBRARY()
+    {
+        wxFileName fn( wxFileName::CreateTempFileName( "symlib" ) );
+
+        wxRemoveFile( fn.GetFullPath() );
+        fn.SetExt( "lib" );
+        m_path = fn.GetFullPath();
+
+        wxFFile file( m_path, "wb" );
+        file.Write( legacyLibrary, sizeof( legacyLibrary ) - 1 );
+
+        // The plugin creates the folder when writing the index
+        fn.SetExt( "idx" );
+        m_indexPath = fn.GetFullPath();
+        m_props[ SCH_LEGACY_PLUGIN::PropIndexPath ] = m_indexPath;
+    }
+
+    ~TEMP_SYMBOL_LIBRARY()
+    {
+        wxRemoveFile( m_path );
+        wxFileName::Rmdir( m_indexPath, wxPATH_RMDIR_RECURSIVE );
+    }
+
+    const wxString& GetPath() const { return m_path; }
+    const wxString& GetIndexPath() const { return m_indexPath; }
+
+    /// The plugin properties keeping the index in the temporary folder
+    const PROPERTIES* GetProperties() const { return &m_props; }
+
+private:
+    wxString   m_path;
+    wxString   m_indexPath;
+    PROPERTIES m_props;
+};
+
+
+static int pinCount( LIB_ALIAS* aAlias )
+{
+    LIB_PINS pins;
+
+    aAlias->GetPart()->GetPins( pins );
+
+    return (int) pins.size();
+}
+
+
+BOOST_AUTO_TEST_SUITE( SchLegacyLibCache )
+
+
+/**
+ * Symbols are complete when loaded, whether their draw items come from the first scan of the
+ * library or from a scan which reused the index of the previous one
+ */
+BOOST_AUTO_TEST_CASE( LoadSymbols )
+{
+    TEMP_SYMBOL_LIBRARY library;
+
+    for( int pass = 0; pass < 2; ++pass )
+    {
+        BOOST_TEST_CONTEXT( "Pass " << pass )
+        {
+            SCH_PLUGIN::SCH_PLUGIN_RELEASER pi( SCH_IO_MGR::FindPlugin( SCH_IO_MGR::SCH_LEGACY ) );
+            wxArrayString                   names;
+
+            pi->EnumerateSymbolLib( names, library.GetPath(), library.GetProperties() );
+
+            BOOST_CHECK_EQUAL( names.GetCount(), 3u );
+            BOOST_CHECK( wxDir( library.GetIndexPath() ).HasFiles() );
+
+            LIB_ALIAS* tp = pi->LoadSymbol( library.GetPath(), "TP" );
+
+            BOOST_REQUIRE( tp );
+            BOOST_CHECK_EQUAL( pinCount( tp ), 1 );
+            BOOST_CHECK_EQUAL( tp->GetPart()->GetPinNameOffset(), 30 );
+
+            LIB_ALIAS* alias = pi->LoadSymbol( library.GetPath(), "R_Small" );
+
+            BOOST_REQUIRE( alias );
+            BOOST_CHECK_EQUAL( alias->GetPart()->GetName(), "R" );
+            BOOST_CHECK_EQUAL( pinCount( alias ), 2 );
+
+            // Loading again must not add the draw items twice
+            BOOST_CHECK_EQUAL( pinCount( pi->LoadSymbol( library.GetPath(), "R" ) ), 2 );
+        }
+    }
+}
+
+
+/**
+ * Saving a library writes the draw items of the symbols which were never loaded
+ */
+BOOST_AUTO_TEST_CASE( SaveUnloadedSymbols )
+{
+    TEMP_SYMBOL_LIBRARY library;
+    wxFileName          copy( library.GetPath() );
+
+    copy.SetName( copy.GetName() + "_copy" );
+
+    {
+        SCH_PLUGIN::SCH_PLUGIN_RELEASER pi( SCH_IO_MGR::FindPlugin( SCH_IO_MGR::SCH_LEGACY ) );
+        wxArrayString                   names;
+        PROPERTIES                      props( *library.GetProperties() );
+
+        props[ SCH_LEGACY_PLUGIN::PropNoDocFile ] = "";
+
+        pi->EnumerateSymbolLib( names, library.GetPath(), &props );
+        pi->SaveLibrary( copy.GetFullPath(), &props );
+    }
+
+    SCH_PLUGIN::SCH_PLUGIN_RELEASER pi( SCH_IO_MGR::FindPlugin( SCH_IO_MGR::SCH_LEGACY ) );
+    LIB_ALIAS*                      r = pi->LoadSymbol( copy.GetFullPath(), "R",
+                                                        library.GetProperties() );
+
+    BOOST_REQUIRE( r );
+    BOOST_CHECK_EQUAL( pinCount( r ), 2 );
+
+    wxRemoveFile( copy.GetFullPath() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,169 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for SEXPR::DOCUMENT
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <sexpr/sexpr_document.h>
+#include <sexpr/sexpr_parser.h>
+
+
+/**
+ * @return true if the arena node \a aNode holds the same tree as \a aSexpr.
+ */
+static bool sameTree( const SEXPR::SEXPR& aSexpr, const SEXPR::DOCUMENT_NODE& aNode )
+{
+    if( aSexpr.IsList() )
+    {
+        if( !aNode.IsList() || aNode.GetNumberOfChildren() != aSexpr.GetNumberOfChildren() )
+            return false;
+
+        for( size_t ii = 0; ii < aSexpr.GetNumberOfChildren(); ++ii )
+        {
+            if( !sameTree( *aSexpr.GetChild( ii ), *aNode.GetChild( ii ) ) )
+                return false;
+        }
+
+        return true;
+    }
+    else if( aSexpr.IsInteger() )
+    {
+        return aNode.IsInteger() && aNode.GetLongInteger() == aSexpr.GetLongInteger();
+    }
+    else if( aSexpr.IsDouble() )
+    {
+        return aNode.IsDouble() && aNode.GetDouble() == aSexpr.GetDouble();
+    }
+    else if( aSexpr.IsString() )
+    {
+        return aNode.IsString() && aNode.GetString() == aSexpr.GetString();
+    }
+    else
+    {
+        return aNode.IsSymbol() && aNode.GetString() == aSexpr.GetSymbol();
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE( SexprDocument )
+
+
+/**
+ * The document and PARSER give the same tree
+ */
+BOOST_AUTO_TEST_CASE( SameAsParser )
+{
+    const std::vector<std::string> cases = {
+        "",
+        "  ",
+        ")",
+        "this is just writing",
+        "\"string\" ",
+        "()",
+        "(symbol \"string\" 42 3.14 (nested 4 ()))",
+        "(a \"escaped \\\" quote\" -3 - -.5 010 1.2.3 (b\n  (c d)) e)",
+        "(unclosed (list ",
+        "(first) (second)",
+    };
+
+    for( const std::string& text : cases )
+    {
+        BOOST_TEST_CONTEXT( text )
+        {
+            SEXPR::PARSER                 parser;
+            SEXPR::DOCUMENT               document;
+            std::unique_ptr<SEXPR::SEXPR> sexpr = parser.Parse( text );
+            const SEXPR::DOCUMENT_NODE*   root = document.Parse( text );
+
+            BOOST_REQUIRE_EQUAL( !sexpr, !root );
+
+            if( sexpr )
+                BOOST_CHECK( sameTree( *sexpr, *root ) );
+        }
+    }
+}
+
+
+/**
+ * Malformed text throws as with PARSER
+ */
+BOOST_AUTO_TEST_CASE( ParseExceptions )
+{
+    const std::vector<std::string> cases = { "(symbol", ",", "1", "3.14", "symbol", "(\"string" };
+
+    for( const std::string& text : cases )
+    {
+        BOOST_TEST_CONTEXT( text )
+        {
+            SEXPR::DOCUMENT document;
+
+            BOOST_CHECK_THROW( document.Parse( text ), SEXPR::PARSE_EXCEPTION );
+        }
+    }
+}
+
+
+/**
+ * Nodes give access to their values and line numbers
+ */
+BOOST_AUTO_TEST_CASE( Accessors )
+{
+    SEXPR::DOCUMENT             document;
+    const SEXPR::DOCUMENT_NODE* root = document.Parse( "(at 1.5\n  -2 (layer \"F.Cu\"))" );
+
+    BOOST_REQUIRE( root );
+    BOOST_REQUIRE_EQUAL( root->GetNumberOfChildren(), 4u );
+
+    BOOST_CHECK( root->GetChild( 0 )->IsSymbol( "at" ) );
+    BOOST_CHECK( !root->GetChild( 0 )->IsSymbol( "a" ) );
+    BOOST_CHECK_EQUAL( root->GetChild( 1 )->GetDouble(), 1.5 );
+    BOOST_CHECK_EQUAL( root->GetChild( 2 )->GetInteger(), -2 );
+    BOOST_CHECK_EQUAL( root->GetChild( 2 )->GetLineNumber(), 2u );
+    BOOST_CHECK_EQUAL( root->GetChild( 3 )->GetChild( 1 )->GetString(), "F.Cu" );
+
+    BOOST_CHECK_THROW( root->GetChild( 0 )->GetLongInteger(), SEXPR::INVALID_TYPE_EXCEPTION );
+    BOOST_CHECK_THROW( root->GetChild( 1 )->GetNumberOfChildren(),
+                       SEXPR::INVALID_TYPE_EXCEPTION );
+
+    size_t count = 0;
+
+    for( const SEXPR::DOCUMENT_NODE& child : *root )
+    {
+        BOOST_CHECK_EQUAL( &child, root->GetChild( count ) );
+        ++count;
+    }
+
+    BOOST_CHECK_EQUAL( count, 4u );
+
+    document.Clear();
+
+    BOOST_CHECK( !document.GetRoot() );
+    BOOST_CHECK_EQUAL( document.GetArenaSize(), 0u );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
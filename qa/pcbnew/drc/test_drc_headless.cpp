@@ -0,0 +1,161 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_drc_headless.cpp
+ * Test suite for the complete DRC run on a board without an editor frame, as the DRC tool does
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <algorithm>
+#include <sstream>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <class_board.h>
+#include <class_zone.h>
+
+// Code under test
+#include <drc.h>
+
+#include "drc_test_utils.h"
+
+
+/**
+ * A footprint with two pads on GND, joined by a filled GND zone
+ */
+static const char* g_zoneBoard = R"(
+(kicad_pcb (version 20190516) (host pcbnew "qa")
+  (net 0 "")
+  (net 1 GND)
+  (module R (layer F.Cu) (tedit 0) (tstamp 0)
+    (at 100 100)
+    (fp_text reference R1 (at 0 -3) (layer F.SilkS)
+      (effects (font (size 1 1) (thickness 0.15)))
+    )
+    (fp_text value R (at 0 3) (layer F.Fab)
+      (effects (font (size 1 1) (thickness 0.15)))
+    )
+    (pad 1 smd rect (at -2 0) (size 1 1) (layers F.Cu) (net 1 GND))
+    (pad 2 smd rect (at 2 0) (size 1 1) (layers F.Cu) (net 1 GND))
+  )
+  (zone (net 1) (net_name GND) (layer F.Cu) (tstamp 0) (hatch edge 0.508)
+    (connect_pads yes (clearance 0.2))
+    (min_thickness 0.2)
+    (fill yes (thermal_gap 0.5) (thermal_bridge_width 0.5))
+    (polygon
+      (pts
+        (xy 95 95) (xy 105 95) (xy 105 105) (xy 95 105)
+      )
+    )
+    (filled_polygon
+      (pts
+        (xy 95.1 95.1) (xy 104.9 95.1) (xy 104.9 104.9) (xy 95.1 104.9)
+      )
+    )
+  )
+)
+)";
+
+
+/**
+ * Runs the complete DRC on a board read from a file, as the DRC tool does
+ */
+struct DRC_HEADLESS_FIXTURE
+{
+    DRC_HEADLESS_FIXTURE()
+    {
+        std::istringstream stream( g_zoneBoard );
+
+        m_board = KI_TEST::ReadBoardFromFileOrStream( "", stream );
+    }
+
+    void runDrc( bool aRefillZones )
+    {
+        DRC drc;
+
+        drc.SetSettings( true, true, false, true, aRefillZones, false );
+        drc.RunTests( m_board.get(),
+                      [&]( MARKER_PCB* aMarker )
+                      {
+                          m_markers.push_back( std::unique_ptr<MARKER_PCB>( aMarker ) );
+                      },
+                      EDA_UNITS_T::MILLIMETRES );
+
+        m_unconnectedCount = drc.GetUnconnectedItems().size();
+    }
+
+    int markerCount( int aErrorCode ) const
+    {
+        return std::count_if( m_markers.begin(), m_markers.end(),
+                              [&]( const std::unique_ptr<MARKER_PCB>& aMarker )
+                              {
+                                  return KI_TEST::IsDrcMarkerOfType( *aMarker, aErrorCode );
+                              } );
+    }
+
+    std::unique_ptr<BOARD>                   m_board;
+    std::vector<std::unique_ptr<MARKER_PCB>> m_markers;
+    size_t                                   m_unconnectedCount = 0;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( DrcHeadless, DRC_HEADLESS_FIXTURE )
+
+
+/**
+ * The zone joins the pads of its net: it is neither suspicious nor leaves them unconnected
+ */
+BOOST_AUTO_TEST_CASE( FilledZone )
+{
+    BOOST_REQUIRE( m_board );
+    BOOST_REQUIRE_EQUAL( m_board->GetAreaCount(), 1 );
+
+    runDrc( false );
+
+    BOOST_CHECK_EQUAL( markerCount( DRCE_SUSPICIOUS_NET_FOR_ZONE_OUTLINE ), 0 );
+    BOOST_CHECK_EQUAL( m_unconnectedCount, 0u );
+    BOOST_CHECK( m_board->GetArea( 0 )->IsFilled() );
+}
+
+
+/**
+ * Refilling keeps the fill, which is connected to the pads rather than an island
+ */
+BOOST_AUTO_TEST_CASE( RefilledZone )
+{
+    BOOST_REQUIRE( m_board );
+    BOOST_REQUIRE_EQUAL( m_board->GetAreaCount(), 1 );
+
+    runDrc( true );
+
+    ZONE_CONTAINER* zone = m_board->GetArea( 0 );
+
+    BOOST_CHECK_EQUAL( markerCount( DRCE_SUSPICIOUS_NET_FOR_ZONE_OUTLINE ), 0 );
+    BOOST_CHECK_EQUAL( m_unconnectedCount, 0u );
+    BOOST_CHECK( zone->IsFilled() );
+    BOOST_CHECK_GT( zone->GetFilledPolysList().OutlineCount(), 0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
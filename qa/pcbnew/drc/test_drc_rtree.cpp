@@ -0,0 +1,117 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <drc/drc_rtree.h>
+
+
+BOOST_AUTO_TEST_SUITE( DrcRtree )
+
+
+/**
+ * Items are only found on the layers they were inserted on
+ */
+BOOST_AUTO_TEST_CASE( LayerFiltering )
+{
+    DRC_RTREE<int>   index;
+    std::vector<int> result;
+
+    index.Insert( 0, EDA_RECT( wxPoint( 0, 0 ), wxSize( 10, 10 ) ), LSET( F_Cu ) );
+    index.Insert( 1, EDA_RECT( wxPoint( 0, 0 ), wxSize( 10, 10 ) ), LSET( B_Cu ) );
+
+    index.Query( EDA_RECT( wxPoint( 5, 5 ), wxSize( 1, 1 ) ), LSET( F_Cu ), result );
+    BOOST_CHECK( result == std::vector<int>( { 0 } ) );
+
+    index.Query( EDA_RECT( wxPoint( 5, 5 ), wxSize( 1, 1 ) ), LSET( In1_Cu ), result );
+    BOOST_CHECK( result.empty() );
+
+    // Non-copper layers are not indexed
+    index.Query( EDA_RECT( wxPoint( 5, 5 ), wxSize( 1, 1 ) ), LSET( F_SilkS ), result );
+    BOOST_CHECK( result.empty() );
+}
+
+
+/**
+ * Items spanning several layers are reported once, and results come back sorted
+ */
+BOOST_AUTO_TEST_CASE( SortedUnique )
+{
+    DRC_RTREE<int>   index;
+    std::vector<int> result;
+
+    index.Insert( 2, EDA_RECT( wxPoint( 0, 0 ), wxSize( 10, 10 ) ), LSET::AllCuMask() );
+    index.Insert( 0, EDA_RECT( wxPoint( 5, 5 ), wxSize( 10, 10 ) ), LSET( F_Cu ) );
+    index.Insert( 1, EDA_RECT( wxPoint( 100, 100 ), wxSize( 10, 10 ) ), LSET::AllCuMask() );
+
+    BOOST_CHECK_EQUAL( index.Size(), 3 );
+
+    index.Query( EDA_RECT( wxPoint( 0, 0 ), wxSize( 20, 20 ) ), LSET::AllCuMask(), result );
+    BOOST_CHECK( result == std::vector<int>( { 0, 2 } ) );
+
+    index.RemoveAll();
+    index.Query( EDA_RECT( wxPoint( 0, 0 ), wxSize( 20, 20 ) ), LSET::AllCuMask(), result );
+    BOOST_CHECK( result.empty() );
+    BOOST_CHECK_EQUAL( index.Size(), 0 );
+}
+
+
+/**
+ * Removed items are not found anymore, on any of their layers
+ */
+BOOST_AUTO_TEST_CASE( Remove )
+{
+    DRC_RTREE<int>   index;
+    std::vector<int> result;
+    const EDA_RECT   bbox( wxPoint( 0, 0 ), wxSize( 10, 10 ) );
+
+    index.Insert( 0, bbox, LSET::AllCuMask() );
+    index.Insert( 1, bbox, LSET( F_Cu ) );
+
+    index.Remove( 0, bbox, LSET::AllCuMask() );
+    BOOST_CHECK_EQUAL( index.Size(), 1 );
+
+    index.Query( bbox, LSET::AllCuMask(), result );
+    BOOST_CHECK( result == std::vector<int>( { 1 } ) );
+
+    // Removing an item which is not indexed does nothing
+    index.Remove( 2, bbox, LSET( F_Cu ) );
+    BOOST_CHECK_EQUAL( index.Size(), 1 );
+}
+
+
+/**
+ * Rectangles with negative sizes are normalized before use
+ */
+BOOST_AUTO_TEST_CASE( Normalize )
+{
+    DRC_RTREE<int>   index;
+    std::vector<int> result;
+
+    index.Insert( 0, EDA_RECT( wxPoint( 10, 10 ), wxSize( -10, -10 ) ), LSET( F_Cu ) );
+
+    index.Query( EDA_RECT( wxPoint( 2, 2 ), wxSize( 1, 1 ) ), LSET( F_Cu ), result );
+    BOOST_CHECK( result == std::vector<int>( { 0 } ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,199 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_clearance_resolver.cpp
+ * Test suite for CLEARANCE_RESOLVER
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <class_zone.h>
+
+// Code under test
+#include <clearance_resolver.h>
+
+
+/**
+ * A board with nets in a few netclasses, and items with and without clearances of their own
+ */
+struct CLEARANCE_RESOLVER_FIXTURE
+{
+    CLEARANCE_RESOLVER_FIXTURE()
+    {
+        NETCLASSES& netClasses = m_board.GetDesignSettings().m_NetClasses;
+
+        netClasses.GetDefault()->SetClearance( Millimeter2iu( 0.2 ) );
+        addClass( "HV", Millimeter2iu( 1.0 ) );
+        addClass( "Fine", Millimeter2iu( 0.1 ) );
+
+        addNet( "GND", 1, nullptr );
+        addNet( "MAINS", 2, "HV" );
+        addNet( "CLK", 3, "Fine" );
+
+        m_board.SynchronizeNetsAndNetClasses();
+
+        for( int net = 0; net <= 3; ++net )
+        {
+            TRACK* track = new TRACK( &m_board );
+            m_board.Add( track );
+            track->SetNetCode( net );
+            m_items.push_back( track );
+
+            VIA* via = new VIA( &m_board );
+            m_board.Add( via );
+            via->SetNetCode( net );
+            m_items.push_back( via );
+
+            ZONE_CONTAINER* zone = new ZONE_CONTAINER( &m_board );
+            m_board.Add( zone );
+            zone->SetNetCode( net );
+            zone->SetZoneClearance( Millimeter2iu( 0.5 ) );
+            m_items.push_back( zone );
+        }
+
+        // Pads without clearance, with a footprint clearance and with both clearances
+        const std::vector<std::pair<int, int>> localClearances = {
+            { 0, 0 },
+            { Millimeter2iu( 0.4 ), 0 },
+            { Millimeter2iu( 0.4 ), Millimeter2iu( 2.0 ) },
+        };
+
+        for( const std::pair<int, int>& clearances : localClearances )
+        {
+            MODULE* module = new MODULE( &m_board );
+            m_board.Add( module );
+            module->SetLocalClearance( clearances.first );
+
+            for( int net = 0; net <= 3; ++net )
+            {
+                D_PAD* pad = new D_PAD( module );
+                module->Add( pad );
+                pad->SetNetCode( net );
+                pad->SetLocalClearance( clearances.second );
+                m_items.push_back( pad );
+            }
+        }
+    }
+
+    void addClass( const wxString& aName, int aClearance )
+    {
+        NETCLASSPTR netclass = std::make_shared<NETCLASS>( aName );
+
+        netclass->SetClearance( aClearance );
+        m_board.GetDesignSettings().m_NetClasses.Add( netclass );
+    }
+
+    void addNet( const wxString& aName, int aNetCode, const char* aClassName )
+    {
+        m_board.Add( new NETINFO_ITEM( &m_board, aName, aNetCode ) );
+
+        if( aClassName )
+            m_board.GetDesignSettings().m_NetClasses.Find( aClassName )->Add( aName );
+    }
+
+    BOARD                              m_board;
+    std::vector<BOARD_CONNECTED_ITEM*> m_items;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ClearanceResolver, CLEARANCE_RESOLVER_FIXTURE )
+
+
+/**
+ * The resolver gives the clearances of the items
+ */
+BOOST_AUTO_TEST_CASE( SameAsItems )
+{
+    const CLEARANCE_RESOLVER& resolver = m_board.GetClearanceResolver();
+
+    for( BOARD_CONNECTED_ITEM* a : m_items )
+    {
+        BOOST_TEST_CONTEXT( a->GetClass() << " net " << a->GetNetCode() )
+        {
+            BOOST_CHECK_EQUAL( resolver.GetItemClearance( a ), a->GetClearance() );
+
+            for( BOARD_CONNECTED_ITEM* b : m_items )
+            {
+                BOOST_TEST_CONTEXT( b->GetClass() << " net " << b->GetNetCode() )
+                {
+                    BOOST_CHECK_EQUAL( resolver.GetClearance( a, b ), a->GetClearance( b ) );
+                }
+            }
+        }
+    }
+}
+
+
+/**
+ * The clearances between nets come from their netclasses
+ */
+BOOST_AUTO_TEST_CASE( NetPairs )
+{
+    const CLEARANCE_RESOLVER& resolver = m_board.GetClearanceResolver();
+
+    BOOST_CHECK_EQUAL( resolver.GetDefaultClearance(), Millimeter2iu( 0.2 ) );
+    BOOST_CHECK_EQUAL( resolver.GetNetClearance( 1 ), Millimeter2iu( 0.2 ) );
+    BOOST_CHECK_EQUAL( resolver.GetNetClearance( 3 ), Millimeter2iu( 0.1 ) );
+    BOOST_CHECK_EQUAL( resolver.GetNetPairClearance( 3, 3 ), Millimeter2iu( 0.1 ) );
+    BOOST_CHECK_EQUAL( resolver.GetNetPairClearance( 2, 3 ), Millimeter2iu( 1.0 ) );
+    BOOST_CHECK_EQUAL( resolver.GetNetPairClearance( 3, 1 ), Millimeter2iu( 0.2 ) );
+    BOOST_CHECK_EQUAL( resolver.GetMaxNetClearance(), Millimeter2iu( 1.0 ) );
+
+    // Unknown nets get the default clearance
+    BOOST_CHECK_EQUAL( resolver.GetNetClearance( -1 ), Millimeter2iu( 0.2 ) );
+    BOOST_CHECK_EQUAL( resolver.GetNetPairClearance( 3, 100 ), Millimeter2iu( 0.2 ) );
+}
+
+
+/**
+ * The resolver follows the changes of the netclasses once invalidated
+ */
+BOOST_AUTO_TEST_CASE( Invalidate )
+{
+    NETCLASSPTR hv = m_board.GetDesignSettings().m_NetClasses.Find( "HV" );
+
+    BOOST_CHECK_EQUAL( m_board.GetClearanceResolver().GetNetClearance( 2 ), Millimeter2iu( 1.0 ) );
+
+    hv->SetClearance( Millimeter2iu( 1.5 ) );
+
+    BOOST_CHECK_EQUAL( m_board.GetClearanceResolver().GetNetClearance( 2 ), Millimeter2iu( 1.0 ) );
+
+    m_board.InvalidateClearanceResolver();
+
+    BOOST_CHECK_EQUAL( m_board.GetClearanceResolver().GetNetClearance( 2 ), Millimeter2iu( 1.5 ) );
+
+    // Moving a net to another netclass
+    m_board.GetDesignSettings().m_NetClasses.Find( "Fine" )->Clear();
+    hv->Add( "CLK" );
+    m_board.SynchronizeNetsAndNetClasses();
+
+    BOOST_CHECK_EQUAL( m_board.GetClearanceResolver().GetNetPairClearance( 1, 3 ),
+                       Millimeter2iu( 1.5 ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
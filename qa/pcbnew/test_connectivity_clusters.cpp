@@ -0,0 +1,231 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_connectivity_clusters.cpp
+ * Test suite for CN_CONNECTIVITY_ALGO::SearchClusters()
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <random>
+#include <set>
+
+#include <class_board.h>
+#include <class_track.h>
+
+// Code under test
+#include <connectivity/connectivity_algo.h>
+
+
+typedef std::set<CN_ITEM*> ITEM_SET;
+
+
+/**
+ * A board covered with random tracks and vias, snapped to a coarse grid so that many of them
+ * touch, on a few nets so that some of the touching items are on different nets
+ */
+struct CONNECTIVITY_CLUSTERS_FIXTURE
+{
+    CONNECTIVITY_CLUSTERS_FIXTURE()
+    {
+        std::mt19937                       rng( 42 );
+        std::uniform_int_distribution<int> coord( 0, 30 );
+        std::uniform_int_distribution<int> netCode( 0, 4 );
+        std::uniform_int_distribution<int> kind( 0, 9 );
+
+        for( int net = 1; net <= 4; ++net )
+            m_board.Add( new NETINFO_ITEM( &m_board, wxString::Format( "N%d", net ), net ) );
+
+        for( int i = 0; i < 1500; ++i )
+        {
+            wxPoint start( coord( rng ) * 100000, coord( rng ) * 100000 );
+            int     k = kind( rng );
+
+            if( k == 0 )
+            {
+                VIA* via = new VIA( &m_board );
+                m_board.Add( via );
+                via->SetPosition( start );
+                via->SetWidth( 50000 );
+                via->SetNetCode( netCode( rng ) );
+            }
+            else
+            {
+                // Short tracks, to get many small clusters rather than a few big ones
+                wxPoint end = start + wxPoint( ( coord( rng ) % 3 - 1 ) * 100000,
+                                               ( coord( rng ) % 3 - 1 ) * 100000 );
+
+                TRACK* track = new TRACK( &m_board );
+                m_board.Add( track );
+                track->SetStart( start );
+                track->SetEnd( end );
+                track->SetWidth( 20000 );
+                track->SetLayer( k % 2 ? F_Cu : B_Cu );
+                track->SetNetCode( netCode( rng ) );
+            }
+        }
+
+        m_algo.Build( &m_board );
+    }
+
+    /**
+     * The clusters found by a sequential breadth-first walk of the connections, with the same
+     * item filter as SearchClusters()
+     */
+    std::vector<ITEM_SET> searchClustersBFS( bool aWithinNet )
+    {
+        std::map<CN_ITEM*, std::vector<CN_ITEM*>> links;
+        std::vector<ITEM_SET>                     clusters;
+        std::set<CN_ITEM*>                        visited;
+
+        auto accepted = [&]( CN_ITEM* aItem )
+        {
+            return aItem->Valid() && ( !aWithinNet || aItem->Net() > 0 );
+        };
+
+        // The walk follows the connections both ways, as does the union of the sets
+        for( CN_ITEM* item : m_algo.ItemList() )
+        {
+            if( !accepted( item ) )
+                continue;
+
+            for( CN_ITEM* n : item->ConnectedItems() )
+            {
+                if( !accepted( n ) || ( aWithinNet && n->Net() != item->Net() ) )
+                    continue;
+
+                links[item].push_back( n );
+                links[n].push_back( item );
+            }
+        }
+
+        for( CN_ITEM* root : m_algo.ItemList() )
+        {
+            if( !accepted( root ) || visited.count( root ) )
+                continue;
+
+            ITEM_SET             cluster;
+            std::deque<CN_ITEM*> queue = { root };
+
+            visited.insert( root );
+
+            while( !queue.empty() )
+            {
+                CN_ITEM* item = queue.front();
+                queue.pop_front();
+                cluster.insert( item );
+
+                for( CN_ITEM* n : links[item] )
+                {
+                    if( visited.insert( n ).second )
+                        queue.push_back( n );
+                }
+            }
+
+            clusters.push_back( cluster );
+        }
+
+        std::sort( clusters.begin(), clusters.end() );
+        return clusters;
+    }
+
+    static std::vector<ITEM_SET> toSets( const CN_CONNECTIVITY_ALGO::CLUSTERS& aClusters )
+    {
+        std::vector<ITEM_SET> clusters;
+
+        for( const CN_CLUSTER_PTR& cluster : aClusters )
+            clusters.emplace_back( cluster->begin(), cluster->end() );
+
+        std::sort( clusters.begin(), clusters.end() );
+        return clusters;
+    }
+
+    BOARD                m_board;
+    CN_CONNECTIVITY_ALGO m_algo;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ConnectivityClusters, CONNECTIVITY_CLUSTERS_FIXTURE )
+
+
+/**
+ * The parallel search finds the same clusters as a sequential walk, whether the connections
+ * between different nets are followed or not
+ */
+BOOST_AUTO_TEST_CASE( SameAsBFS )
+{
+    const std::vector<std::pair<CN_CONNECTIVITY_ALGO::CLUSTER_SEARCH_MODE, bool>> modes = {
+        { CN_CONNECTIVITY_ALGO::CSM_PROPAGATE, false },
+        { CN_CONNECTIVITY_ALGO::CSM_CONNECTIVITY_CHECK, true },
+        { CN_CONNECTIVITY_ALGO::CSM_RATSNEST, true },
+    };
+
+    for( const auto& mode : modes )
+    {
+        BOOST_TEST_CONTEXT( "Mode " << mode.first )
+        {
+            std::vector<ITEM_SET> expected = searchClustersBFS( mode.second );
+            std::vector<ITEM_SET> clusters = toSets( m_algo.SearchClusters( mode.first ) );
+
+            // Several clusters, some of them with several items: the test is not trivial
+            BOOST_CHECK_GT( expected.size(), 1u );
+            BOOST_CHECK( std::any_of( expected.begin(), expected.end(),
+                                      []( const ITEM_SET& aSet ) { return aSet.size() > 1; } ) );
+
+            BOOST_CHECK_EQUAL( clusters.size(), expected.size() );
+            BOOST_CHECK( clusters == expected );
+        }
+    }
+}
+
+
+/**
+ * The clusters and their items come in the same order from a search to the next
+ */
+BOOST_AUTO_TEST_CASE( Deterministic )
+{
+    auto listItems = [&]()
+    {
+        std::vector<CN_ITEM*> items;
+
+        for( const CN_CLUSTER_PTR& cluster : m_algo.SearchClusters(
+                     CN_CONNECTIVITY_ALGO::CSM_CONNECTIVITY_CHECK ) )
+        {
+            items.insert( items.end(), cluster->begin(), cluster->end() );
+            items.push_back( nullptr );
+        }
+
+        return items;
+    };
+
+    std::vector<CN_ITEM*> first = listItems();
+
+    for( int i = 0; i < 10; ++i )
+        BOOST_CHECK( listItems() == first );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,197 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_connectivity_items.cpp
+ * Test suite for CN_ITEM and its anchors
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_track.h>
+
+// Code under test
+#include <connectivity/connectivity_items.h>
+
+
+BOOST_AUTO_TEST_SUITE( ConnectivityItems )
+
+
+/**
+ * The anchors of the items of a net are stored next to each other, and the anchors removed
+ * from an item leave invalid anchors in their place
+ */
+BOOST_AUTO_TEST_CASE( Anchors )
+{
+    const VECTOR2I points[] = { { 0, 0 }, { 100, 0 }, { 100, 100 }, { 0, 100 } };
+    auto           netAnchors = std::make_shared<CN_NET_ANCHORS>();
+    CN_ITEM        a( nullptr, false );
+
+    {
+        CN_ITEM b( nullptr, false );
+
+        a.SetAnchors( netAnchors, points, 4 );
+        b.SetAnchors( netAnchors, points, 2 );
+
+        BOOST_REQUIRE_EQUAL( netAnchors->Size(), 6 );
+        BOOST_REQUIRE_EQUAL( a.Anchors().size(), 4u );
+        BOOST_CHECK_EQUAL( a.FirstAnchor(), 0 );
+        BOOST_CHECK_EQUAL( b.FirstAnchor(), 4 );
+
+        for( int i = 0; i < 4; i++ )
+        {
+            BOOST_CHECK_EQUAL( a.Anchors()[i].Pos(), points[i] );
+            BOOST_CHECK_EQUAL( a.Anchors()[i].Item(), &a );
+            BOOST_CHECK_EQUAL( &a.Anchors()[i], &( *netAnchors )[i] );
+        }
+
+        BOOST_CHECK_EQUAL( b.Anchors()[1].Item(), &b );
+    }
+
+    // The anchors of a deleted item are removed
+    BOOST_CHECK_EQUAL( netAnchors->Size(), 6 );
+    BOOST_CHECK_EQUAL( netAnchors->RemovedCount(), 2 );
+    BOOST_CHECK( !( *netAnchors )[4].Valid() );
+    BOOST_CHECK( ( *netAnchors )[3].Valid() );
+
+    a.SetAnchors( netAnchors, points, 1 );
+
+    BOOST_REQUIRE_EQUAL( a.Anchors().size(), 1u );
+    BOOST_CHECK_EQUAL( a.FirstAnchor(), 6 );
+    BOOST_CHECK_EQUAL( a.Anchors()[0].Pos(), points[0] );
+    BOOST_CHECK_EQUAL( netAnchors->RemovedCount(), 6 );
+}
+
+
+/**
+ * The anchors moved to another net keep their state
+ */
+BOOST_AUTO_TEST_CASE( MoveAnchors )
+{
+    const VECTOR2I points[] = { { 0, 0 }, { 100, 0 } };
+    auto           net1 = std::make_shared<CN_NET_ANCHORS>();
+    auto           net2 = std::make_shared<CN_NET_ANCHORS>();
+    CN_ITEM        item( nullptr, false );
+
+    item.SetAnchors( net1, points, 2 );
+    item.Anchors()[1].SetNoLine( true );
+    item.MoveAnchors( net2 );
+
+    BOOST_CHECK( item.NetAnchors() == net2 );
+    BOOST_REQUIRE_EQUAL( item.Anchors().size(), 2u );
+
+    for( int i = 0; i < 2; i++ )
+    {
+        BOOST_CHECK_EQUAL( item.Anchors()[i].Pos(), points[i] );
+        BOOST_CHECK_EQUAL( item.Anchors()[i].Item(), &item );
+    }
+
+    BOOST_CHECK( !item.Anchors()[0].GetNoLine() );
+    BOOST_CHECK( item.Anchors()[1].GetNoLine() );
+    BOOST_CHECK_EQUAL( net1->RemovedCount(), 2 );
+}
+
+
+/**
+ * The anchors follow the items to their new net.  The arrays of anchors having more removed
+ * anchors than valid ones are replaced, the former ones keeping their size for the ratsnest.
+ */
+BOOST_AUTO_TEST_CASE( NetAnchors )
+{
+    BOARD                               board;
+    std::vector<std::unique_ptr<TRACK>> tracks;
+    CN_LIST                             list;
+
+    board.Add( new NETINFO_ITEM( &board, "N1", 1 ) );
+    board.Add( new NETINFO_ITEM( &board, "N2", 2 ) );
+
+    for( int i = 0; i < 4; i++ )
+    {
+        tracks.emplace_back( new TRACK( &board ) );
+        tracks.back()->SetStart( wxPoint( i * 1000, 0 ) );
+        tracks.back()->SetEnd( wxPoint( i * 1000, 1000 ) );
+        tracks.back()->SetNetCode( 1 );
+        list.Add( tracks.back().get() );
+    }
+
+    const CN_NET_ANCHORS_PTR net1 = list[0]->NetAnchors();
+
+    BOOST_REQUIRE_EQUAL( net1->Size(), 8 );
+
+    for( int i = 0; i < 4; i++ )
+    {
+        BOOST_CHECK( list[i]->NetAnchors() == net1 );
+        BOOST_CHECK_EQUAL( list[i]->FirstAnchor(), 2 * i );
+    }
+
+    // Net propagation changes the net of the items without adding them again
+    tracks[0]->SetNetCode( 2 );
+    list.UpdateNetAnchors();
+
+    BOOST_CHECK( list[0]->NetAnchors() != net1 );
+    BOOST_CHECK_EQUAL( list[0]->Anchors()[1].Pos(), VECTOR2I( 0, 1000 ) );
+    BOOST_CHECK_EQUAL( net1->RemovedCount(), 2 );
+    BOOST_CHECK( list[3]->NetAnchors() == net1 );
+
+    tracks[1]->SetNetCode( 2 );
+    tracks[2]->SetNetCode( 2 );
+    list.UpdateNetAnchors();
+
+    BOOST_CHECK( list[2]->NetAnchors() == list[0]->NetAnchors() );
+    BOOST_CHECK_EQUAL( list[0]->NetAnchors()->Size(), 6 );
+
+    BOOST_CHECK( list[3]->NetAnchors() != net1 );
+    BOOST_CHECK_EQUAL( list[3]->NetAnchors()->Size(), 2 );
+    BOOST_CHECK_EQUAL( list[3]->FirstAnchor(), 0 );
+    BOOST_CHECK_EQUAL( list[3]->Anchors()[0].Pos(), VECTOR2I( 3000, 0 ) );
+    BOOST_CHECK_EQUAL( net1->Size(), 8 );
+
+    list.Clear();
+}
+
+
+/**
+ * Items connected several times are only listed once
+ */
+BOOST_AUTO_TEST_CASE( SortConnections )
+{
+    CN_ITEM a( nullptr, false );
+    CN_ITEM b( nullptr, false );
+    CN_ITEM c( nullptr, false );
+
+    a.Connect( &c );
+    a.Connect( &b );
+    a.Connect( &c );
+    a.SortConnections();
+
+    BOOST_REQUIRE_EQUAL( a.ConnectedItems().size(), 2u );
+    BOOST_CHECK( std::is_sorted( a.ConnectedItems().begin(), a.ConnectedItems().end() ) );
+
+    c.SetValid( false );
+    a.RemoveInvalidRefs();
+
+    BOOST_REQUIRE_EQUAL( a.ConnectedItems().size(), 1u );
+    BOOST_CHECK_EQUAL( a.ConnectedItems()[0], &b );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,264 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_fp_cache.cpp
+ * Test suite for the footprint library cache of PCB_IO, which parses the footprints on demand
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <memory>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+#include <class_module.h>
+#include <fp_lib_table.h>
+
+// Code under test
+#include <footprint_info_impl.h>
+#include <kicad_plugin.h>
+
+
+/**
+ * A footprint library in a temporary folder, removed when going out of scope
+ */
+struct FP_CACHE_FIXTURE
+{
+    FP_CACHE_FIXTURE()
+    {
+        wxFileName dir( wxFileName::CreateTempFileName( "fpcache" ) );
+
+        wxRemoveFile( dir.GetFullPath() );
+        dir.SetExt( "pretty" );
+        wxFileName::Mkdir( dir.GetFullPath() );
+
+        m_path = dir.GetFullPath();
+    }
+
+    ~FP_CACHE_FIXTURE()
+    {
+        wxFileName::Rmdir( m_path, wxPATH_RMDIR_RECURSIVE );
+    }
+
+    static wxString footprintName( int aIndex )
+    {
+        return wxString::Format( "FP_%d", aIndex );
+    }
+
+    static int padCount( int aIndex )
+    {
+        return aIndex % 5 + 1;
+    }
+
+    wxString fileName( const wxString& aName ) const
+    {
+        return m_path + "/" + aName + ".kicad_mod";
+    }
+
+    void writeFile( const wxString& aName, const std::string& aText )
+    {
+        wxFFile file( fileName( aName ), "wb" );
+        file.Write( aText.c_str(), aText.size() );
+    }
+
+    std::string readFile( const wxString& aName ) const
+    {
+        wxString text;
+        wxFFile  file( fileName( aName ), "rb" );
+
+        file.ReadAll( &text );
+        return std::string( text.ToUTF8() );
+    }
+
+    /**
+     * Write footprint \a aIndex, with a description and a pad count depending on its index
+     */
+    void addFootprint( int aIndex )
+    {
+        std::string name( footprintName( aIndex ).ToUTF8() );
+        std::string text = "(module " + name + " (layer F.Cu)\n"
+                           "  (descr \"Footprint " + std::to_string( aIndex ) + "\")\n";
+
+        for( int ii = 0; ii < padCount( aIndex ); ++ii )
+        {
+            text += "  (pad " + std::to_string( ii + 1 ) + " smd rect (at " + std::to_string( ii )
+                    + " 0) (size 0.5 0.5) (layers F.Cu))\n";
+        }
+
+        text += ")\n";
+
+        writeFile( name, text );
+    }
+
+    void checkFootprint( const MODULE* aFootprint, int aIndex )
+    {
+        BOOST_TEST_CONTEXT( "Footprint " << aIndex )
+        {
+            BOOST_REQUIRE( aFootprint );
+            BOOST_CHECK_EQUAL( aFootprint->GetFPID().GetLibItemName(), footprintName( aIndex ) );
+            BOOST_CHECK_EQUAL( aFootprint->GetDescription(),
+                               wxString::Format( "Footprint %d", aIndex ) );
+            BOOST_CHECK_EQUAL( aFootprint->GetPadCount(), (unsigned) padCount( aIndex ) );
+        }
+    }
+
+    wxString m_path;
+};
+
+
+/**
+ * Gives the footprint list of a single library table to the FOOTPRINT_INFOs
+ */
+class TEST_FOOTPRINT_LIST : public FOOTPRINT_LIST_IMPL
+{
+public:
+    TEST_FOOTPRINT_LIST( FP_LIB_TABLE* aTable )
+    {
+        m_lib_table = aTable;
+    }
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( FpCache, FP_CACHE_FIXTURE )
+
+
+/**
+ * More footprints than the cache keeps parsed are all loaded, including the released ones
+ * when requested again
+ */
+BOOST_AUTO_TEST_CASE( Eviction )
+{
+    const int count = FP_CACHE_MAX_LOADED + 10;
+
+    for( int ii = 0; ii < count; ++ii )
+        addFootprint( ii );
+
+    PCB_IO        plugin;
+    wxArrayString names;
+
+    plugin.FootprintEnumerate( names, m_path );
+    BOOST_CHECK_EQUAL( names.size(), (size_t) count );
+
+    for( int ii = 0; ii < count; ++ii )
+        checkFootprint( plugin.GetEnumeratedFootprint( m_path, footprintName( ii ) ), ii );
+
+    // The first footprints were released to make room for the last ones
+    checkFootprint( plugin.GetEnumeratedFootprint( m_path, footprintName( 0 ) ), 0 );
+    checkFootprint( plugin.GetEnumeratedFootprint( m_path, footprintName( 1 ) ), 1 );
+
+    std::unique_ptr<MODULE> footprint( plugin.FootprintLoad( m_path, footprintName( 2 ) ) );
+    checkFootprint( footprint.get(), 2 );
+
+    BOOST_CHECK( !plugin.GetEnumeratedFootprint( m_path, "missing" ) );
+}
+
+
+/**
+ * Saving a footprint leaves the footprints which were never parsed, or were released, as they
+ * are on the disk
+ */
+BOOST_AUTO_TEST_CASE( SaveUnparsed )
+{
+    const int count = FP_CACHE_MAX_LOADED + 10;
+
+    for( int ii = 0; ii < count; ++ii )
+        addFootprint( ii );
+
+    const std::string unparsed = readFile( footprintName( count - 1 ) );
+    const std::string released = readFile( footprintName( 0 ) );
+
+    {
+        PCB_IO plugin;
+
+        for( int ii = 0; ii < count - 1; ++ii )
+            BOOST_REQUIRE( plugin.GetEnumeratedFootprint( m_path, footprintName( ii ) ) );
+
+        std::unique_ptr<MODULE> footprint( plugin.FootprintLoad( m_path, footprintName( 3 ) ) );
+
+        BOOST_REQUIRE( footprint );
+        footprint->SetFPID( LIB_ID( wxEmptyString, "NEW" ) );
+        plugin.FootprintSave( m_path, footprint.get() );
+
+        plugin.FootprintDelete( m_path, footprintName( 4 ) );
+    }
+
+    BOOST_CHECK_EQUAL( readFile( footprintName( count - 1 ) ), unparsed );
+    BOOST_CHECK_EQUAL( readFile( footprintName( 0 ) ), released );
+
+    PCB_IO        plugin;
+    wxArrayString names;
+
+    plugin.FootprintEnumerate( names, m_path );
+    BOOST_CHECK_EQUAL( names.size(), (size_t) count );
+    BOOST_CHECK( names.Index( "NEW" ) != wxNOT_FOUND );
+    BOOST_CHECK( names.Index( footprintName( 4 ) ) == wxNOT_FOUND );
+
+    const MODULE* saved = plugin.GetEnumeratedFootprint( m_path, "NEW" );
+
+    BOOST_REQUIRE( saved );
+    BOOST_CHECK_EQUAL( saved->GetPadCount(), (unsigned) padCount( 3 ) );
+
+    checkFootprint( plugin.GetEnumeratedFootprint( m_path, footprintName( count - 1 ) ),
+                    count - 1 );
+}
+
+
+/**
+ * A footprint file which cannot be parsed is reported when loaded rather than enumerated,
+ * and the footprint list shows it without pads
+ */
+BOOST_AUTO_TEST_CASE( ParseError )
+{
+    addFootprint( 1 );
+    writeFile( "broken", "(module broken (layer" );
+
+    {
+        PCB_IO        plugin;
+        wxArrayString names;
+
+        BOOST_CHECK_NO_THROW( plugin.FootprintEnumerate( names, m_path ) );
+        BOOST_CHECK_EQUAL( names.size(), 2u );
+        BOOST_CHECK_THROW( plugin.GetEnumeratedFootprint( m_path, "broken" ), IO_ERROR );
+        checkFootprint( plugin.GetEnumeratedFootprint( m_path, footprintName( 1 ) ), 1 );
+    }
+
+    FP_LIB_TABLE table;
+
+    table.InsertRow( new FP_LIB_TABLE_ROW( "lib", m_path, "KiCad", wxEmptyString ) );
+
+    TEST_FOOTPRINT_LIST                  list( &table );
+    std::unique_ptr<FOOTPRINT_INFO_IMPL> broken;
+
+    BOOST_CHECK_NO_THROW( broken.reset( new FOOTPRINT_INFO_IMPL( &list, "lib", "broken" ) ) );
+    BOOST_REQUIRE( broken );
+    BOOST_CHECK_EQUAL( broken->GetPadCount(), 0u );
+
+    FOOTPRINT_INFO_IMPL valid( &list, "lib", footprintName( 1 ) );
+
+    BOOST_CHECK_EQUAL( valid.GetPadCount(), (unsigned) padCount( 1 ) );
+    BOOST_CHECK_EQUAL( valid.GetDescription(), "Footprint 1" );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,206 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <wx/dir.h>
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+// Code under test
+#include <fp_lib_index.h>
+
+
+/**
+ * A footprint library in a temporary folder, removed when going out of scope
+ */
+class TEMP_FP_LIBRARY
+{
+public:
+    TEMP_FP_LIBRARY()
+    {
+        wxFileName dir( wxFileName::CreateTempFileName( "fplib" ) );
+
+        wxRemoveFile( dir.GetFullPath() );
+        dir.SetExt( "pretty" );
+        wxFileName::Mkdir( dir.GetFullPath() );
+
+        m_path = dir.GetFullPath();
+        m_index = m_path + ".idx";
+    }
+
+    ~TEMP_FP_LIBRARY()
+    {
+        wxFileName::Rmdir( m_path, wxPATH_RMDIR_RECURSIVE );
+        wxRemoveFile( m_index );
+    }
+
+    void AddFootprint( const wxString& aName, const std::string& aDescription, int aPadCount )
+    {
+        std::string text = "(module " + std::string( aName.ToUTF8() ) + " (layer F.Cu)\n"
+                           "  (descr \"" + aDescription + "\")\n";
+
+        for( int ii = 0; ii < aPadCount; ++ii )
+        {
+            text += "  (pad " + std::to_string( ii + 1 ) + " smd rect (at " + std::to_string( ii )
+                    + " 0) (size 0.5 0.5) (layers F.Cu))\n";
+        }
+
+        text += ")\n";
+
+        wxFFile file( m_path + "/" + aName + ".kicad_mod", "wb" );
+        file.Write( text.c_str(), text.size() );
+    }
+
+    void RemoveFootprint( const wxString& aName )
+    {
+        wxRemoveFile( m_path + "/" + aName + ".kicad_mod" );
+    }
+
+    const wxString& GetPath() const { return m_path; }
+    const wxString& GetIndex() const { return m_index; }
+
+private:
+    wxString m_path;
+    wxString m_index;
+};
+
+
+static const FP_LIB_INDEX::ENTRY* findEntry( const FP_LIB_INDEX& aIndex, const wxString& aName )
+{
+    for( const FP_LIB_INDEX::ENTRY& entry : aIndex.GetEntries() )
+    {
+        if( entry.m_name == aName )
+            return &entry;
+    }
+
+    return nullptr;
+}
+
+
+BOOST_AUTO_TEST_SUITE( FpLibIndex )
+
+
+/**
+ * Only the new and modified footprints are parsed again
+ */
+BOOST_AUTO_TEST_CASE( IncrementalUpdate )
+{
+    TEMP_FP_LIBRARY library;
+
+    library.AddFootprint( "R_0603", "Resistor", 2 );
+    library.AddFootprint( "SOT-23", "Transistor", 3 );
+
+    {
+        FP_LIB_INDEX index( library.GetPath(), library.GetIndex() );
+
+        index.Update();
+
+        BOOST_CHECK_EQUAL( index.GetParsedCount(), 2 );
+        BOOST_REQUIRE_EQUAL( index.GetEntries().size(), 2u );
+
+        const FP_LIB_INDEX::ENTRY* entry = findEntry( index, "SOT-23" );
+
+        BOOST_REQUIRE( entry );
+        BOOST_CHECK_EQUAL( entry->m_description, "Transistor" );
+        BOOST_CHECK_EQUAL( entry->m_padCount, 3u );
+        BOOST_CHECK_EQUAL( entry->m_uniquePadCount, 3u );
+    }
+
+    // Nothing changed: everything comes from the index file
+    {
+        FP_LIB_INDEX index( library.GetPath(), library.GetIndex() );
+
+        index.Update();
+
+        BOOST_CHECK_EQUAL( index.GetParsedCount(), 0 );
+        BOOST_REQUIRE_EQUAL( index.GetEntries().size(), 2u );
+        BOOST_REQUIRE( findEntry( index, "R_0603" ) );
+        BOOST_CHECK_EQUAL( findEntry( index, "R_0603" )->m_description, "Resistor" );
+        BOOST_CHECK_EQUAL( findEntry( index, "R_0603" )->m_padCount, 2u );
+    }
+
+    // A modified, a new and a removed footprint
+    library.AddFootprint( "R_0603", "Resistor, 0603", 2 );
+    library.AddFootprint( "C_0402", "Capacitor", 2 );
+    library.RemoveFootprint( "SOT-23" );
+
+    {
+        FP_LIB_INDEX index( library.GetPath(), library.GetIndex() );
+
+        index.Update();
+
+        BOOST_CHECK_EQUAL( index.GetParsedCount(), 2 );
+        BOOST_CHECK_EQUAL( index.GetEntries().size(), 2u );
+        BOOST_CHECK( !findEntry( index, "SOT-23" ) );
+        BOOST_REQUIRE( findEntry( index, "R_0603" ) );
+        BOOST_CHECK_EQUAL( findEntry( index, "R_0603" )->m_description, "Resistor, 0603" );
+    }
+}
+
+
+/**
+ * A footprint which cannot be parsed is reported, and the others are still indexed
+ */
+BOOST_AUTO_TEST_CASE( ParseError )
+{
+    TEMP_FP_LIBRARY library;
+
+    library.AddFootprint( "R_0603", "Resistor", 2 );
+
+    wxFFile file( library.GetPath() + "/broken.kicad_mod", "wb" );
+    file.Write( wxString( "(module broken (layer" ) );
+    file.Close();
+
+    {
+        FP_LIB_INDEX index( library.GetPath(), library.GetIndex() );
+
+        BOOST_CHECK_THROW( index.Update(), IO_ERROR );
+        BOOST_CHECK_EQUAL( index.GetParsedCount(), 2 );
+        BOOST_CHECK_EQUAL( index.GetEntries().size(), 1u );
+    }
+
+    // The broken file is still reported, but it is not parsed again while it is unchanged
+    {
+        FP_LIB_INDEX index( library.GetPath(), library.GetIndex() );
+
+        BOOST_CHECK_THROW( index.Update(), IO_ERROR );
+        BOOST_CHECK_EQUAL( index.GetParsedCount(), 0 );
+        BOOST_CHECK_EQUAL( index.GetEntries().size(), 1u );
+    }
+
+    // Once repaired, it is parsed and indexed
+    library.AddFootprint( "broken", "Fixed", 1 );
+
+    {
+        FP_LIB_INDEX index( library.GetPath(), library.GetIndex() );
+
+        BOOST_CHECK_NO_THROW( index.Update() );
+        BOOST_CHECK_EQUAL( index.GetParsedCount(), 1 );
+        BOOST_CHECK_EQUAL( index.GetEntries().size(), 2u );
+        BOOST_REQUIRE( findEntry( index, "broken" ) );
+        BOOST_CHECK_EQUAL( findEntry( index, "broken" )->m_description, "Fixed" );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,376 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_pcb_parser.cpp
+ * Test suite for PCB_PARSER, which parses the footprints, tracks and zones of a board in
+ * parallel
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <algorithm>
+#include <memory>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_track.h>
+#include <class_zone.h>
+#include <kicad_plugin.h>
+#include <richio.h>
+
+// Code under test
+#include <pcb_parser.h>
+
+
+/**
+ * Builds the text of a board, keeping the line number of each footprint, track and zone
+ */
+class BOARD_TEXT
+{
+public:
+    enum ITEM_TYPE
+    {
+        MODULE_ITEM,
+        TRACK_ITEM,
+        ZONE_ITEM
+    };
+
+    struct ITEM
+    {
+        ITEM_TYPE   m_type;
+        std::string m_text;
+        int         m_lineNumber;
+    };
+
+    void Add( ITEM_TYPE aType, const std::string& aText )
+    {
+        m_items.push_back( { aType, aText, m_lineCount + 1 } );
+        m_lineCount += std::count( aText.begin(), aText.end(), '\n' );
+    }
+
+    void AddModule( int aIndex )
+    {
+        std::string pos = std::to_string( aIndex * 5 ) + " 0";
+
+        Add( MODULE_ITEM,
+             "  (module R (layer F.Cu) (tedit 0) (tstamp 0)\n"
+             "    (at " + pos + ")\n"
+             "    (fp_text reference R" + std::to_string( aIndex ) + " (at 0 -2) (layer F.SilkS)\n"
+             "      (effects (font (size 1 1) (thickness 0.15)))\n"
+             "    )\n"
+             "    (fp_text value R (at 0 2) (layer F.Fab)\n"
+             "      (effects (font (size 1 1) (thickness 0.15)))\n"
+             "    )\n"
+             "    (pad 1 smd rect (at -1 0) (size 1 1) (layers F.Cu) (net 1 GND))\n"
+             "    (pad 2 smd rect (at 1 0) (size 1 1) (layers F.Cu) (net 2 SIG))\n"
+             "  )\n" );
+    }
+
+    void AddSegment( int aIndex )
+    {
+        std::string y = std::to_string( 10 + aIndex );
+
+        Add( TRACK_ITEM, "  (segment (start 0 " + y + ") (end 50 " + y
+                                 + ") (width 0.25) (layer F.Cu) (net 2))\n" );
+    }
+
+    void AddVia( int aIndex )
+    {
+        Add( TRACK_ITEM, "  (via (at " + std::to_string( aIndex * 2 )
+                                 + " 5) (size 0.8) (drill 0.4) (layers F.Cu B.Cu) (net 1))\n" );
+    }
+
+    void AddZone( int aIndex, int aNetCode = 1, const std::string& aNetName = "GND" )
+    {
+        std::string x0 = std::to_string( aIndex * 20 );
+        std::string x1 = std::to_string( aIndex * 20 + 10 );
+
+        Add( ZONE_ITEM,
+             "  (zone (net " + std::to_string( aNetCode ) + ") (net_name " + aNetName
+                     + ") (layer B.Cu) (tstamp 0) (hatch edge 0.508)\n"
+             "    (connect_pads (clearance 0.2))\n"
+             "    (min_thickness 0.2)\n"
+             "    (fill (thermal_gap 0.5) (thermal_bridge_width 0.5))\n"
+             "    (polygon\n"
+             "      (pts\n"
+             "        (xy " + x0 + " 50) (xy " + x1 + " 50) (xy " + x1 + " 60) (xy " + x0 + " 60)\n"
+             "      )\n"
+             "    )\n"
+             "  )\n" );
+    }
+
+    /**
+     * Add an item which cannot be parsed, on a single line
+     */
+    void AddBrokenSegment()
+    {
+        Add( TRACK_ITEM, "  (segment (start 0 0) (end 1 1) (bogus 1) (layer F.Cu) (net 2))\n" );
+    }
+
+    /**
+     * @return the text of a board with some of the items
+     */
+    std::string GetText( const std::vector<ITEM>& aItems ) const
+    {
+        std::string text = header();
+
+        for( const ITEM& item : aItems )
+            text += item.m_text;
+
+        return text + ")\n";
+    }
+
+    std::string GetText() const
+    {
+        return GetText( m_items );
+    }
+
+    const std::vector<ITEM>& GetItems() const
+    {
+        return m_items;
+    }
+
+private:
+    static std::string header()
+    {
+        return "(kicad_pcb (version 20190516) (host pcbnew \"qa\")\n"
+               "  (net 0 \"\")\n"
+               "  (net 1 GND)\n"
+               "  (net 2 SIG)\n";
+    }
+
+    std::vector<ITEM> m_items;
+    int               m_lineCount = 4;      // the header lines
+};
+
+
+static std::unique_ptr<BOARD> parseBoard( const std::string& aText )
+{
+    STRING_LINE_READER     reader( aText, "test board" );
+    PCB_PARSER             parser;
+    std::unique_ptr<BOARD> board( new BOARD );
+
+    // The board is owned here, to be released when the parser throws
+    parser.SetLineReader( &reader );
+    parser.SetBoard( board.get() );
+
+    BOOST_REQUIRE( parser.Parse() == board.get() );
+
+    return board;
+}
+
+
+/**
+ * @return the line number of the parse error of a board
+ */
+static int parseErrorLine( const std::string& aText )
+{
+    try
+    {
+        parseBoard( aText );
+    }
+    catch( const PARSE_ERROR& error )
+    {
+        return error.lineNumber;
+    }
+
+    BOOST_ERROR( "The board parsed without error" );
+    return 0;
+}
+
+
+static std::string format( BOARD_ITEM* aItem )
+{
+    PCB_IO io;
+
+    io.Format( aItem );
+    return io.GetStringOutput( true );
+}
+
+
+/**
+ * @return the formatted footprints, tracks and zones of a board, in board order
+ */
+static std::vector<std::string> formatItems( BOARD& aBoard )
+{
+    std::vector<std::string> items;
+
+    for( MODULE* module : aBoard.Modules() )
+        items.push_back( format( module ) );
+
+    for( TRACK* track : aBoard.Tracks() )
+        items.push_back( format( track ) );
+
+    for( ZONE_CONTAINER* zone : aBoard.Zones() )
+        items.push_back( format( zone ) );
+
+    return items;
+}
+
+
+/**
+ * Footprints, tracks and zones mixed together, more of them than parser threads
+ */
+static BOARD_TEXT makeBoard()
+{
+    BOARD_TEXT board;
+
+    for( int ii = 0; ii < 40; ++ii )
+    {
+        board.AddModule( ii );
+        board.AddSegment( ii );
+        board.AddVia( ii );
+
+        if( ii % 4 == 0 )
+            board.AddZone( ii );
+    }
+
+    return board;
+}
+
+
+BOOST_AUTO_TEST_SUITE( PcbParser )
+
+
+/**
+ * The items parsed in parallel are the same, and in the same order, as when each of them is
+ * parsed on its own
+ */
+BOOST_AUTO_TEST_CASE( DeferredItems )
+{
+    BOARD_TEXT             text = makeBoard();
+    std::unique_ptr<BOARD> board = parseBoard( text.GetText() );
+
+    BOOST_CHECK_EQUAL( board->Modules().size(), 40u );
+    BOOST_CHECK_EQUAL( board->Tracks().size(), 80u );
+    BOOST_CHECK_EQUAL( board->Zones().size(), 10u );
+
+    // The items in the order a sequential parse adds them: the tracks are inserted at the
+    // front of their list, the footprints and zones appended to theirs
+    std::vector<std::string> modules;
+    std::vector<std::string> tracks;
+    std::vector<std::string> zones;
+
+    for( const BOARD_TEXT::ITEM& item : text.GetItems() )
+    {
+        std::unique_ptr<BOARD>   single = parseBoard( text.GetText( { item } ) );
+        std::vector<std::string> formatted = formatItems( *single );
+
+        BOOST_REQUIRE_EQUAL( formatted.size(), 1u );
+
+        switch( item.m_type )
+        {
+        case BOARD_TEXT::MODULE_ITEM: modules.push_back( formatted[0] ); break;
+        case BOARD_TEXT::TRACK_ITEM:  tracks.insert( tracks.begin(), formatted[0] ); break;
+        case BOARD_TEXT::ZONE_ITEM:   zones.push_back( formatted[0] ); break;
+        }
+    }
+
+    std::vector<std::string> expected = modules;
+
+    expected.insert( expected.end(), tracks.begin(), tracks.end() );
+    expected.insert( expected.end(), zones.begin(), zones.end() );
+
+    std::vector<std::string> actual = formatItems( *board );
+
+    BOOST_REQUIRE_EQUAL( actual.size(), expected.size() );
+
+    for( size_t ii = 0; ii < expected.size(); ++ii )
+    {
+        BOOST_TEST_CONTEXT( "Item " << ii )
+        {
+            BOOST_CHECK_EQUAL( actual[ii], expected[ii] );
+        }
+    }
+}
+
+
+/**
+ * The error reported is the one of the first broken item of the file, whichever thread
+ * fails first
+ */
+BOOST_AUTO_TEST_CASE( FirstError )
+{
+    BOARD_TEXT text;
+
+    for( int ii = 0; ii < 200; ++ii )
+    {
+        // The later broken items are parsed first by some threads
+        if( ii == 30 || ii == 120 || ii == 190 )
+            text.AddBrokenSegment();
+        else
+            text.AddSegment( ii );
+    }
+
+    const int expectedLine = text.GetItems()[30].m_lineNumber;
+
+    for( int run = 0; run < 20; ++run )
+    {
+        BOOST_TEST_CONTEXT( "Run " << run )
+        {
+            BOOST_CHECK_EQUAL( parseErrorLine( text.GetText() ), expectedLine );
+        }
+    }
+
+    // The line of an error in an item of several lines
+    BOARD_TEXT modules = makeBoard();
+
+    modules.Add( BOARD_TEXT::MODULE_ITEM,
+                 "  (module R (layer F.Cu) (tedit 0) (tstamp 0)\n"
+                 "    (at 0 0)\n"
+                 "    (bogus)\n"
+                 "  )\n" );
+
+    BOOST_CHECK_EQUAL( parseErrorLine( modules.GetText() ),
+                       modules.GetItems().back().m_lineNumber + 2 );
+}
+
+
+/**
+ * A zone whose net name does not match its net code is fixed by the board parser, as a worker
+ * thread cannot change the board
+ */
+BOOST_AUTO_TEST_CASE( MainThreadFallback )
+{
+    BOARD_TEXT text = makeBoard();
+
+    // The net name wins over the net code
+    text.AddZone( 50, 1, "SIG" );
+
+    for( int ii = 0; ii < 40; ++ii )
+        text.AddSegment( 100 + ii );
+
+    std::unique_ptr<BOARD> board = parseBoard( text.GetText() );
+
+    BOOST_REQUIRE_EQUAL( board->Zones().size(), 11u );
+    BOOST_CHECK_EQUAL( board->Tracks().size(), 120u );
+
+    for( int ii = 0; ii < 10; ++ii )
+        BOOST_CHECK_EQUAL( board->Zones()[ii]->GetNetCode(), 1 );
+
+    BOOST_CHECK_EQUAL( board->Zones()[10]->GetNetCode(), 2 );
+    BOOST_CHECK_EQUAL( board->Zones()[10]->GetNetname(), "SIG" );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
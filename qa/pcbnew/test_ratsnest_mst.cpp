@@ -0,0 +1,179 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_ratsnest_mst.cpp
+ * Test suite for the spanning tree of RN_NET, updated incrementally
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <functional>
+#include <memory>
+#include <random>
+
+// Code under test
+#include <ratsnest_data.h>
+
+
+/**
+ * A net of single anchor items, each of them in its own cluster, so the ratsnest links all
+ * of them.  The items are moved around between the updates of the net.
+ */
+class MOVING_NET
+{
+public:
+    void AddNode( const VECTOR2I& aPos )
+    {
+        m_items.emplace_back( new CN_ITEM( nullptr, false, 1 ) );
+        m_clusters.emplace_back( new CN_CLUSTER() );
+
+        m_clusters.back()->Add( m_items.back().get() );
+        MoveNode( m_items.size() - 1, aPos );
+    }
+
+    void MoveNode( size_t aIndex, const VECTOR2I& aPos )
+    {
+        m_items[aIndex]->SetAnchors( m_anchors, &aPos, 1 );
+    }
+
+    size_t NodeCount() const
+    {
+        return m_items.size();
+    }
+
+    /**
+     * Fills aNet with the nodes in their current position and computes its ratsnest
+     */
+    void Update( RN_NET& aNet )
+    {
+        aNet.Clear();
+
+        for( const CN_CLUSTER_PTR& cluster : m_clusters )
+            aNet.AddCluster( cluster );
+
+        aNet.Update();
+    }
+
+private:
+    ///> anchors of the net, declared first as the items remove their anchors from it
+    CN_NET_ANCHORS_PTR                    m_anchors = std::make_shared<CN_NET_ANCHORS>();
+    std::vector<std::unique_ptr<CN_ITEM>> m_items;
+    std::vector<CN_CLUSTER_PTR>           m_clusters;
+};
+
+
+static uint64_t totalWeight( const RN_NET& aNet )
+{
+    uint64_t total = 0;
+
+    for( const CN_EDGE& edge : aNet.GetUnconnected() )
+        total += edge.GetWeight();
+
+    return total;
+}
+
+
+/**
+ * Moves a few nodes at a time and checks that the net, which keeps its triangulation between
+ * updates, gets a spanning tree as short as the one of a net computed from scratch.  The
+ * trees themselves may differ when edges have the same length.
+ */
+static void checkMovingNodes( MOVING_NET& aNodes, std::mt19937& aRng,
+                              const std::function<VECTOR2I()>& aRandomPos )
+{
+    std::uniform_int_distribution<size_t> nodeIndex( 0, aNodes.NodeCount() - 1 );
+    std::uniform_int_distribution<int>    moveCount( 1, 6 );
+    RN_NET                                incremental;
+
+    aNodes.Update( incremental );
+
+    for( int step = 0; step < 100; ++step )
+    {
+        BOOST_TEST_CONTEXT( "Step " << step )
+        {
+            for( int count = moveCount( aRng ); count > 0; --count )
+                aNodes.MoveNode( nodeIndex( aRng ), aRandomPos() );
+
+            RN_NET rebuilt;
+
+            aNodes.Update( incremental );
+            aNodes.Update( rebuilt );
+
+            BOOST_CHECK_EQUAL( incremental.GetUnconnected().size(),
+                               rebuilt.GetUnconnected().size() );
+            BOOST_CHECK_EQUAL( totalWeight( incremental ), totalWeight( rebuilt ) );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE( RatsnestMst )
+
+
+/**
+ * Nodes scattered at random
+ */
+BOOST_AUTO_TEST_CASE( RandomNodes )
+{
+    std::mt19937                       rng( 42 );
+    std::uniform_int_distribution<int> coord( -1000000, 1000000 );
+    MOVING_NET                         nodes;
+
+    auto randomPos = [&]()
+    {
+        return VECTOR2I( coord( rng ), coord( rng ) );
+    };
+
+    for( int i = 0; i < 300; ++i )
+        nodes.AddNode( randomPos() );
+
+    checkMovingNodes( nodes, rng, randomPos );
+}
+
+
+/**
+ * Nodes on a grid, where each square has four cocircular corners and many edges have the same
+ * length.  Nodes also move onto each other.
+ */
+BOOST_AUTO_TEST_CASE( CocircularNodes )
+{
+    std::mt19937                       rng( 42 );
+    std::uniform_int_distribution<int> coord( 0, 14 );
+    MOVING_NET                         nodes;
+
+    auto randomPos = [&]()
+    {
+        return VECTOR2I( coord( rng ) * 1000, coord( rng ) * 1000 );
+    };
+
+    for( int x = 0; x < 15; ++x )
+    {
+        for( int y = 0; y < 15; ++y )
+            nodes.AddNode( VECTOR2I( x * 1000, y * 1000 ) );
+    }
+
+    checkMovingNodes( nodes, rng, randomPos );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
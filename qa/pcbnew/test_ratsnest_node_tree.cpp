@@ -0,0 +1,99 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_ratsnest_node_tree.cpp
+ * Test suite for RN_NODE_TREE
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <random>
+
+// Code under test
+#include <ratsnest_data.h>
+
+
+BOOST_AUTO_TEST_SUITE( RatsnestNodeTree )
+
+
+/**
+ * An empty tree has no nearest node
+ */
+BOOST_AUTO_TEST_CASE( Empty )
+{
+    RN_NODE_TREE            tree( {} );
+    VECTOR2I::extended_type squaredDist;
+
+    BOOST_CHECK( tree.Empty() );
+    BOOST_CHECK_EQUAL( tree.Nearest( VECTOR2I( 0, 0 ), squaredDist ), -1 );
+}
+
+
+/**
+ * The tree finds the same nearest nodes as comparing with all of them
+ */
+BOOST_AUTO_TEST_CASE( SameAsBruteForce )
+{
+    std::mt19937 rng( 42 );
+
+    // Grid snapped coordinates, so there are ties
+    std::uniform_int_distribution<int> coord( -2000, 2000 );
+
+    for( int count : { 1, 2, 7, 1000 } )
+    {
+        BOOST_TEST_CONTEXT( count << " nodes" )
+        {
+            std::vector<RN_NODE_TREE::NODE> nodes;
+
+            for( int i = 0; i < count; i++ )
+            {
+                VECTOR2I pos( coord( rng ) * 1000, coord( rng ) * 500 );
+                nodes.push_back( { pos, i } );
+            }
+
+            RN_NODE_TREE tree( nodes );
+
+            BOOST_CHECK( !tree.Empty() );
+
+            for( int query = 0; query < 200; query++ )
+            {
+                VECTOR2I                pos( coord( rng ) * 1500, coord( rng ) * 700 );
+                VECTOR2I::extended_type squaredDist;
+                VECTOR2I::extended_type expected = VECTOR2I::ECOORD_MAX;
+
+                for( const auto& node : nodes )
+                    expected = std::min( expected, ( node.m_pos - pos ).SquaredEuclideanNorm() );
+
+                int nearest = tree.Nearest( pos, squaredDist );
+
+                BOOST_REQUIRE( nearest >= 0 && nearest < count );
+                BOOST_CHECK_EQUAL( squaredDist, expected );
+                BOOST_CHECK_EQUAL( ( nodes[nearest].m_pos - pos ).SquaredEuclideanNorm(),
+                                   expected );
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,182 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_snapshot_plugin.cpp
+ * Test suite for SNAPSHOT_PLUGIN
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <climits>
+#include <memory>
+
+#include <wx/filename.h>
+
+#include <class_board.h>
+#include <class_zone.h>
+
+// Code under test
+#include <snapshot_plugin.h>
+
+
+/**
+ * A board with filled zones, removed from the disk when going out of scope
+ */
+struct SNAPSHOT_PLUGIN_FIXTURE
+{
+    SNAPSHOT_PLUGIN_FIXTURE()
+    {
+        m_fileName = wxFileName::CreateTempFileName( "snapshot" );
+
+        m_board.Add( new NETINFO_ITEM( &m_board, "GND", 1 ) );
+    }
+
+    ~SNAPSHOT_PLUGIN_FIXTURE()
+    {
+        wxRemoveFile( m_fileName );
+    }
+
+    static SHAPE_LINE_CHAIN contour( const std::vector<VECTOR2I>& aPoints )
+    {
+        SHAPE_LINE_CHAIN chain;
+
+        for( const VECTOR2I& pt : aPoints )
+            chain.Append( pt, true );
+
+        chain.SetClosed( true );
+        return chain;
+    }
+
+    ZONE_CONTAINER* addZone( SHAPE_POLY_SET& aFill )
+    {
+        ZONE_CONTAINER* zone = new ZONE_CONTAINER( &m_board );
+
+        m_board.Add( zone );
+        zone->SetLayer( F_Cu );
+        zone->SetNetCode( 1 );
+        zone->Outline()->AddOutline( contour( { { 0, 0 }, { 100000, 0 }, { 100000, 100000 } } ) );
+        zone->SetFilledPolysList( aFill );
+        zone->SetIsFilled( aFill.OutlineCount() > 0 );
+
+        return zone;
+    }
+
+    /**
+     * Saves the board as a snapshot and loads it back
+     */
+    std::unique_ptr<BOARD> roundTrip()
+    {
+        SNAPSHOT_PLUGIN plugin;
+
+        plugin.Save( m_fileName, &m_board );
+
+        return std::unique_ptr<BOARD>( plugin.Load( m_fileName, nullptr ) );
+    }
+
+    static void checkSameFill( const SHAPE_POLY_SET& aExpected, const SHAPE_POLY_SET& aFill )
+    {
+        BOOST_REQUIRE_EQUAL( aFill.OutlineCount(), aExpected.OutlineCount() );
+
+        for( int ipoly = 0; ipoly < aExpected.OutlineCount(); ++ipoly )
+        {
+            BOOST_REQUIRE_EQUAL( aFill.HoleCount( ipoly ), aExpected.HoleCount( ipoly ) );
+
+            for( int icontour = 0; icontour <= aExpected.HoleCount( ipoly ); ++icontour )
+            {
+                const SHAPE_LINE_CHAIN& expected = icontour == 0
+                                                   ? aExpected.COutline( ipoly )
+                                                   : aExpected.CHole( ipoly, icontour - 1 );
+                const SHAPE_LINE_CHAIN& actual = icontour == 0
+                                                 ? aFill.COutline( ipoly )
+                                                 : aFill.CHole( ipoly, icontour - 1 );
+
+                BOOST_TEST_CONTEXT( "Polygon " << ipoly << " contour " << icontour )
+                {
+                    BOOST_REQUIRE_EQUAL( actual.PointCount(), expected.PointCount() );
+
+                    for( int ipt = 0; ipt < expected.PointCount(); ++ipt )
+                        BOOST_CHECK_EQUAL( actual.CPoint( ipt ), expected.CPoint( ipt ) );
+                }
+            }
+        }
+    }
+
+    BOARD    m_board;
+    wxString m_fileName;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( SnapshotPlugin, SNAPSHOT_PLUGIN_FIXTURE )
+
+
+/**
+ * The delta encoded coordinates survive a round trip, including the deltas which do not fit
+ * in an int and the ones going backwards
+ */
+BOOST_AUTO_TEST_CASE( ExtremeCoordinates )
+{
+    SHAPE_POLY_SET fill;
+
+    // The deltas between these points span up to 2^32 - 1 either way, beyond the int range
+    fill.AddOutline( contour( { { INT_MIN, INT_MIN }, { INT_MAX, INT_MIN }, { INT_MAX, INT_MAX },
+                                { INT_MIN, INT_MAX }, { 0, 0 }, { INT_MAX, INT_MAX } } ) );
+
+    // Decreasing coordinates, and a hole starting back from the end of the outline
+    fill.AddOutline( contour( { { 500, 500 }, { -500, 400 }, { -600, -700 }, { 300, -800 } } ) );
+    fill.AddHole( contour( { { -100, -100 }, { -200, -100 }, { -200, -200 } } ) );
+
+    addZone( fill );
+
+    std::unique_ptr<BOARD> board = roundTrip();
+
+    BOOST_REQUIRE_EQUAL( board->GetAreaCount(), 1 );
+    checkSameFill( fill, board->GetArea( 0 )->GetFilledPolysList() );
+}
+
+
+/**
+ * Unfilled zones and empty contours are read back as they were written
+ */
+BOOST_AUTO_TEST_CASE( EmptyPolygons )
+{
+    SHAPE_POLY_SET noFill;
+    SHAPE_POLY_SET emptyContours;
+
+    emptyContours.AddOutline( contour( {} ) );
+    emptyContours.AddOutline( contour( { { -10, -10 }, { 10, -10 }, { 10, 10 } } ) );
+    emptyContours.AddHole( contour( {} ) );
+
+    addZone( noFill );
+    addZone( emptyContours );
+    addZone( noFill );
+
+    std::unique_ptr<BOARD> board = roundTrip();
+
+    BOOST_REQUIRE_EQUAL( board->GetAreaCount(), 3 );
+    checkSameFill( noFill, board->GetArea( 0 )->GetFilledPolysList() );
+    checkSameFill( emptyContours, board->GetArea( 1 )->GetFilledPolysList() );
+    checkSameFill( noFill, board->GetArea( 2 )->GetFilledPolysList() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,226 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_zone_fill_tracker.cpp
+ * Test suite for ZONE_FILL_TRACKER
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <algorithm>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <class_zone.h>
+
+// Code under test
+#include <zone_filler.h>
+
+
+/**
+ * A GND zone, connected to a GND pad, with a footprint and a GND track away from it.  The
+ * footprint pad has a local clearance much larger than the netclass clearances.
+ */
+struct ZONE_FILL_TRACKER_FIXTURE
+{
+    ZONE_FILL_TRACKER_FIXTURE()
+    {
+        m_board.Add( new NETINFO_ITEM( &m_board, "GND", 1 ) );
+        m_board.Add( new NETINFO_ITEM( &m_board, "SIG", 2 ) );
+
+        m_zone = new ZONE_CONTAINER( &m_board );
+        m_board.Add( m_zone );
+        m_zone->SetLayer( F_Cu );
+        m_zone->SetNetCode( 1 );
+        m_zone->SetZoneClearance( Millimeter2iu( 0.2 ) );
+        m_zone->SetThermalReliefGap( Millimeter2iu( 0.2 ) );
+        m_zone->SetMinThickness( Millimeter2iu( 0.25 ) );
+        m_zone->Outline()->NewOutline();
+
+        for( VECTOR2I pt : { VECTOR2I( 0, 0 ), VECTOR2I( 20, 0 ), VECTOR2I( 20, 20 ),
+                             VECTOR2I( 0, 20 ) } )
+        {
+            m_zone->Outline()->Append( Millimeter2iu( pt.x ), Millimeter2iu( pt.y ) );
+        }
+
+        addFootprint( wxPoint( Millimeter2iu( 10 ), Millimeter2iu( 10 ) ), 1, 0 );
+        m_footprint = addFootprint( wxPoint( Millimeter2iu( 40 ), Millimeter2iu( 10 ) ), 2,
+                                    Millimeter2iu( 3 ) );
+
+        m_track = new TRACK( &m_board );
+        m_board.Add( m_track );
+        m_track->SetLayer( F_Cu );
+        m_track->SetNetCode( 1 );
+        m_track->SetWidth( Millimeter2iu( 0.25 ) );
+        m_track->SetStart( wxPoint( Millimeter2iu( 40 ), Millimeter2iu( 30 ) ) );
+        m_track->SetEnd( wxPoint( Millimeter2iu( 50 ), Millimeter2iu( 30 ) ) );
+
+        fill( allZones() );
+        m_tracker.SetFilled( &m_board );
+    }
+
+    MODULE* addFootprint( const wxPoint& aPos, int aNetCode, int aLocalClearance )
+    {
+        MODULE* module = new MODULE( &m_board );
+        m_board.Add( module );
+        module->SetPosition( aPos );
+
+        D_PAD* pad = new D_PAD( module );
+        module->Add( pad );
+        pad->SetShape( PAD_SHAPE_RECT );
+        pad->SetAttribute( PAD_ATTRIB_SMD );
+        pad->SetLayerSet( D_PAD::SMDMask() );
+        pad->SetSize( wxSize( Millimeter2iu( 1 ), Millimeter2iu( 1 ) ) );
+        pad->SetPosition( aPos );
+        pad->SetNetCode( aNetCode );
+        pad->SetLocalClearance( aLocalClearance );
+
+        return module;
+    }
+
+    std::vector<ZONE_CONTAINER*> allZones()
+    {
+        return std::vector<ZONE_CONTAINER*>( m_board.Zones().begin(), m_board.Zones().end() );
+    }
+
+    void fill( const std::vector<ZONE_CONTAINER*>& aZones )
+    {
+        // Island removal relies on the connectivity, which is up to date after an edit
+        m_board.BuildConnectivity();
+
+        ZONE_FILLER filler( &m_board );
+        BOOST_REQUIRE( filler.Fill( aZones ) );
+    }
+
+    std::vector<ZONE_CONTAINER*> dirtyZones()
+    {
+        std::vector<ZONE_CONTAINER*> zones;
+
+        m_tracker.CollectDirtyZones( &m_board, zones );
+        return zones;
+    }
+
+    static void checkSameFill( const SHAPE_POLY_SET& aExpected, const SHAPE_POLY_SET& aFill )
+    {
+        BOOST_REQUIRE_EQUAL( aFill.OutlineCount(), aExpected.OutlineCount() );
+
+        for( int ipoly = 0; ipoly < aExpected.OutlineCount(); ++ipoly )
+        {
+            const SHAPE_LINE_CHAIN& expected = aExpected.COutline( ipoly );
+            const SHAPE_LINE_CHAIN& actual = aFill.COutline( ipoly );
+
+            BOOST_TEST_CONTEXT( "Polygon " << ipoly )
+            {
+                BOOST_REQUIRE_EQUAL( actual.PointCount(), expected.PointCount() );
+
+                for( int ipt = 0; ipt < expected.PointCount(); ++ipt )
+                    BOOST_CHECK_EQUAL( actual.CPoint( ipt ), expected.CPoint( ipt ) );
+            }
+        }
+    }
+
+    BOARD             m_board;
+    ZONE_CONTAINER*   m_zone;
+    MODULE*           m_footprint;
+    TRACK*            m_track;
+    ZONE_FILL_TRACKER m_tracker;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ZoneFillTracker, ZONE_FILL_TRACKER_FIXTURE )
+
+
+/**
+ * A pad moved near the zone, closer than its own clearance but further than the netclass
+ * clearances, changes the fill: the incremental fill gives the same result as a full one
+ */
+BOOST_AUTO_TEST_CASE( PadLocalClearance )
+{
+    const SHAPE_POLY_SET before = m_zone->GetFilledPolysList();
+
+    m_tracker.MarkDirty( m_footprint );
+    m_footprint->SetPosition( wxPoint( Millimeter2iu( 22 ), Millimeter2iu( 10 ) ) );
+    m_tracker.MarkDirty( m_footprint );
+
+    std::vector<ZONE_CONTAINER*> dirty = dirtyZones();
+
+    BOOST_REQUIRE_EQUAL( dirty.size(), 1u );
+    BOOST_CHECK_EQUAL( dirty[0], m_zone );
+
+    fill( dirty );
+    m_tracker.SetFilled( &m_board );
+
+    const SHAPE_POLY_SET incremental = m_zone->GetFilledPolysList();
+
+    // The pad clearance cuts into the zone
+    BOOST_CHECK_NE( incremental.TotalVertices(), before.TotalVertices() );
+
+    fill( allZones() );
+    checkSameFill( m_zone->GetFilledPolysList(), incremental );
+
+    BOOST_CHECK( dirtyZones().empty() );
+}
+
+
+/**
+ * A change of the items of the zone net can add or remove islands anywhere in the zone,
+ * while the far away changes of other nets do not affect it
+ */
+BOOST_AUTO_TEST_CASE( NetConnectivity )
+{
+    m_tracker.MarkDirty( m_footprint );
+    m_footprint->SetPosition( wxPoint( Millimeter2iu( 60 ), Millimeter2iu( 10 ) ) );
+    m_tracker.MarkDirty( m_footprint );
+
+    BOOST_CHECK( dirtyZones().empty() );
+
+    m_tracker.MarkDirty( m_track );
+    m_track->SetEnd( wxPoint( Millimeter2iu( 60 ), Millimeter2iu( 30 ) ) );
+    m_tracker.MarkDirty( m_track );
+
+    std::vector<ZONE_CONTAINER*> dirty = dirtyZones();
+
+    BOOST_REQUIRE_EQUAL( dirty.size(), 1u );
+    BOOST_CHECK_EQUAL( dirty[0], m_zone );
+}
+
+
+/**
+ * Changes of the design rules and untracked changes affect all the zones
+ */
+BOOST_AUTO_TEST_CASE( Invalidate )
+{
+    m_board.InvalidateClearanceResolver();
+    BOOST_CHECK_EQUAL( dirtyZones().size(), 1u );
+
+    m_tracker.SetFilled( &m_board );
+    BOOST_CHECK( dirtyZones().empty() );
+
+    m_tracker.Invalidate();
+    BOOST_CHECK_EQUAL( dirtyZones().size(), 1u );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -27,6 +27,7 @@
 #include "tools/pcb_parser/pcb_parser_tool.h"
 #include "tools/polygon_generator/polygon_generator.h"
 #include "tools/polygon_triangulation/polygon_triangulation.h"
+#include "tools/rtree_benchmark/rtree_benchmark.h"
 
 /**
  * List of registered tools.
@@ -39,6 +40,7 @@ const static std::vector<KI_TEST::UTILITY_PROGRAM*> known_tools = {
     &pcb_parser_tool,
     &polygon_generator_tool,
     &polygon_triangulation_tool,
+    &rtree_benchmark_tool,
 };
 
 
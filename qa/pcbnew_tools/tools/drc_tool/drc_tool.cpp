@@ -24,10 +24,12 @@
 #include "drc_tool.h"
 
 #include <cstdio>
+#include <fstream>
 #include <string>
 
 #include <common.h>
 #include <profile.h>
+#include <convert_to_biu.h>
 
 #include <wx/cmdline.h>
 
@@ -36,6 +38,7 @@
 // DRC
 #include <drc/courtyard_overlap.h>
 #include <drc/drc_marker_factory.h>
+#include <tools/drc.h>
 
 #include <qa_utils/stdstream_line_reader.h>
 
@@ -72,6 +75,9 @@ public:
             std::cout << "Running DRC check: " << getRunnerIntro() << std::endl;
         }
 
+        // The checks of this runner use their own rules: the board keeps its rules for the
+        // other runners
+        const BOARD_DESIGN_SETTINGS boardSettings = aBoard.GetDesignSettings();
         aBoard.SetDesignSettings( getDesignSettings() );
 
         std::vector<std::unique_ptr<MARKER_PCB>> markers;
@@ -88,6 +94,8 @@ public:
             drc_prov->RunDRC( aBoard );
         }
 
+        aBoard.SetDesignSettings( boardSettings );
+
         // report results
         if( m_exec_context.m_print_times )
             reportDuration( duration );
@@ -208,6 +216,208 @@ private:
 };
 
 
+/**
+ * Runner for the complete DRC, as run by the DRC dialog of the board editor, but without
+ * an editor frame.  It reports the timings of each DRC phase, and can write a
+ * machine-readable report of the run.
+ */
+class FULL_DRC_RUNNER
+{
+public:
+    FULL_DRC_RUNNER( const DRC_RUNNER::EXECUTION_CONTEXT& aExecCtx, bool aRefillZones,
+                     const std::string& aJsonReport ) :
+            m_exec_context( aExecCtx ),
+            m_refill_zones( aRefillZones ),
+            m_json_report( aJsonReport )
+    {
+    }
+
+    /**
+     * Run the DRC on a board
+     * @return the number of problems found (markers and unconnected items)
+     */
+    int Execute( BOARD& aBoard )
+    {
+        if( m_exec_context.m_verbose )
+        {
+            std::cout << "Running DRC check: Full DRC" << std::endl;
+        }
+
+        std::vector<std::unique_ptr<MARKER_PCB>> markers;
+
+        auto marker_handler = [&]( MARKER_PCB* aMarker ) {
+            markers.push_back( std::unique_ptr<MARKER_PCB>( aMarker ) );
+        };
+
+        DRC drc;
+        drc.SetSettings( true, true, false, true, m_refill_zones, false );
+
+        DRC_DURATION duration;
+        {
+            SCOPED_PROF_COUNTER<DRC_DURATION> timer( duration );
+            drc.RunTests( &aBoard, marker_handler, EDA_UNITS_T::MILLIMETRES );
+        }
+
+        if( m_exec_context.m_print_times )
+            reportPhases( drc.GetPhaseStats(), duration );
+
+        if( m_exec_context.m_print_markers )
+            reportMarkers( markers, drc.GetUnconnectedItems() );
+
+        if( !m_json_report.empty() )
+            writeJsonReport( aBoard, drc, markers, duration );
+
+        return markers.size() + drc.GetUnconnectedItems().size();
+    }
+
+private:
+    void reportPhases( const std::vector<DRC_PHASE_STATS>& aPhases,
+                       const DRC_DURATION& aDuration ) const
+    {
+        for( const DRC_PHASE_STATS& phase : aPhases )
+        {
+            std::cout << phase.m_Name << ": " << phase.m_Duration << "ms, "
+                      << phase.m_ItemCount << " items, "
+                      << phase.m_MarkerCount << " markers" << std::endl;
+        }
+
+        std::cout << "Took: " << aDuration.count() << "us" << std::endl;
+    }
+
+    void reportMarkers( const std::vector<std::unique_ptr<MARKER_PCB>>& aMarkers,
+                        const DRC_LIST& aUnconnected ) const
+    {
+        std::cout << "DRC markers: " << aMarkers.size() << std::endl;
+
+        int index = 0;
+        for( const auto& m : aMarkers )
+        {
+            std::cout << index++ << ": " << m->GetReporter().ShowReport( EDA_UNITS_T::MILLIMETRES );
+        }
+
+        std::cout << "Unconnected items: " << aUnconnected.size() << std::endl;
+
+        index = 0;
+        for( const DRC_ITEM* item : aUnconnected )
+        {
+            std::cout << index++ << ": " << item->ShowReport( EDA_UNITS_T::MILLIMETRES );
+        }
+    }
+
+    /**
+     * Quote and escape a string for a JSON document
+     */
+    static std::string jsonString( const wxString& aStr )
+    {
+        std::string out = "\"";
+
+        for( char c : std::string( aStr.ToUTF8() ) )
+        {
+            switch( c )
+            {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if( (unsigned char) c < 0x20 )
+                {
+                    char buf[8];
+                    snprintf( buf, sizeof( buf ), "\\u%04x", c );
+                    out += buf;
+                }
+                else
+                {
+                    out += c;
+                }
+            }
+        }
+
+        return out + "\"";
+    }
+
+    static void writeJsonItem( std::ostream& aOut, const DRC_ITEM& aItem )
+    {
+        aOut << "{ \"code\": " << aItem.GetErrorCode()
+             << ", \"description\": " << jsonString( aItem.GetErrorText() )
+             << ", \"items\": [ { \"text\": " << jsonString( aItem.GetTextA() )
+             << ", \"x_mm\": " << Iu2Millimeter( aItem.GetPointA().x )
+             << ", \"y_mm\": " << Iu2Millimeter( aItem.GetPointA().y ) << " }";
+
+        if( aItem.HasSecondItem() )
+        {
+            aOut << ", { \"text\": " << jsonString( aItem.GetTextB() )
+                 << ", \"x_mm\": " << Iu2Millimeter( aItem.GetPointB().x )
+                 << ", \"y_mm\": " << Iu2Millimeter( aItem.GetPointB().y ) << " }";
+        }
+
+        aOut << " ] }";
+    }
+
+    void writeJsonReport( const BOARD& aBoard, const DRC& aDrc,
+                          const std::vector<std::unique_ptr<MARKER_PCB>>& aMarkers,
+                          const DRC_DURATION& aDuration ) const
+    {
+        std::ofstream out( m_json_report );
+
+        if( !out )
+        {
+            std::cerr << "Cannot write the DRC report " << m_json_report << std::endl;
+            return;
+        }
+
+        out << "{\n";
+        out << "  \"board\": " << jsonString( aBoard.GetFileName() ) << ",\n";
+        out << "  \"duration_ms\": " << aDuration.count() / 1000.0 << ",\n";
+
+        out << "  \"phases\": [";
+
+        const char* sep = "\n";
+
+        for( const DRC_PHASE_STATS& phase : aDrc.GetPhaseStats() )
+        {
+            out << sep << "    { \"name\": " << jsonString( phase.m_Name )
+                << ", \"duration_ms\": " << phase.m_Duration
+                << ", \"items\": " << phase.m_ItemCount
+                << ", \"markers\": " << phase.m_MarkerCount << " }";
+            sep = ",\n";
+        }
+
+        out << "\n  ],\n";
+
+        out << "  \"markers\": [";
+        sep = "\n";
+
+        for( const auto& marker : aMarkers )
+        {
+            out << sep << "    ";
+            writeJsonItem( out, marker->GetReporter() );
+            sep = ",\n";
+        }
+
+        out << "\n  ],\n";
+
+        out << "  \"unconnected\": [";
+        sep = "\n";
+
+        for( const DRC_ITEM* item : aDrc.GetUnconnectedItems() )
+        {
+            out << sep << "    ";
+            writeJsonItem( out, *item );
+            sep = ",\n";
+        }
+
+        out << "\n  ]\n";
+        out << "}\n";
+    }
+
+    const DRC_RUNNER::EXECUTION_CONTEXT m_exec_context;
+    const bool                          m_refill_zones;
+    const std::string                   m_json_report;
+};
+
+
 static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
     {
             wxCMD_LINE_SWITCH,
@@ -253,6 +463,25 @@ static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
             "courtyard-missing",
             _( "perform courtyard-missing checking" ).mb_str(),
     },
+    {
+            wxCMD_LINE_SWITCH,
+            "F",
+            "full",
+            _( "perform the complete DRC of the board editor" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "z",
+            "refill-zones",
+            _( "refill the zones before the complete DRC" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "j",
+            "json",
+            _( "write a JSON report of the complete DRC to the given file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
     {
             wxCMD_LINE_PARAM,
             nullptr,
@@ -270,6 +499,9 @@ static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
 enum PARSER_RET_CODES
 {
     PARSE_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+
+    /// The complete DRC found problems on the board
+    DRC_ERRORS,
 };
 
 
@@ -328,6 +560,18 @@ int drc_main_func( int argc, char** argv )
         runner.Execute( *board );
     }
 
+    wxString json_report;
+    cl_parser.Found( "json", &json_report );
+
+    if( all || cl_parser.Found( "full" ) || !json_report.IsEmpty() )
+    {
+        FULL_DRC_RUNNER runner( exec_context, cl_parser.Found( "refill-zones" ),
+                                json_report.ToStdString() );
+
+        if( runner.Execute( *board ) > 0 )
+            return PARSER_RET_CODES::DRC_ERRORS;
+    }
+
     return KI_TEST::RET_CODES::OK;
 }
 
@@ -0,0 +1,252 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "rtree_benchmark.h"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <common.h>
+#include <profile.h>
+
+#include <wx/cmdline.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_track.h>
+#include <class_zone.h>
+#include <geometry/rtree.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+
+using BENCH_TREE = RTree<BOARD_ITEM*, int, 2, double>;
+
+
+/**
+ * An item to index, with its bounding box in R-tree form
+ */
+using BENCH_ITEM = BENCH_TREE::BulkItem;
+
+
+static void addItem( std::vector<BENCH_ITEM>& aItems, BOARD_ITEM* aItem )
+{
+    EDA_RECT bbox = aItem->GetBoundingBox();
+    bbox.Normalize();
+
+    aItems.push_back( { { bbox.GetX(), bbox.GetY() }, { bbox.GetRight(), bbox.GetBottom() },
+                        aItem } );
+}
+
+
+/**
+ * Collect the items of the board the way the connectivity and view indexes see them
+ */
+static std::vector<BENCH_ITEM> collectItems( BOARD& aBoard )
+{
+    std::vector<BENCH_ITEM> items;
+
+    for( TRACK* track : aBoard.Tracks() )
+        addItem( items, track );
+
+    for( MODULE* module : aBoard.Modules() )
+    {
+        addItem( items, module );
+
+        for( D_PAD* pad : module->Pads() )
+            addItem( items, pad );
+
+        for( BOARD_ITEM* item : module->GraphicalItems() )
+            addItem( items, item );
+    }
+
+    for( BOARD_ITEM* item : aBoard.Drawings() )
+        addItem( items, item );
+
+    for( int ii = 0; ii < aBoard.GetAreaCount(); ii++ )
+        addItem( items, aBoard.GetArea( ii ) );
+
+    return items;
+}
+
+
+static void buildByInsertion( BENCH_TREE& aTree, const std::vector<BENCH_ITEM>& aItems )
+{
+    for( const BENCH_ITEM& item : aItems )
+        aTree.Insert( item.m_min, item.m_max, item.m_data );
+}
+
+
+static void buildByBulkLoad( BENCH_TREE& aTree, const std::vector<BENCH_ITEM>& aItems )
+{
+    aTree.BulkLoad( aItems );
+}
+
+
+/**
+ * Query the tree with the bounding box of each item
+ *
+ * @return the total number of hits
+ */
+static long long queryAll( BENCH_TREE& aTree, const std::vector<BENCH_ITEM>& aItems )
+{
+    long long hits = 0;
+
+    auto visitor = [&hits]( BOARD_ITEM* aItem ) -> bool
+    {
+        hits++;
+        return true;
+    };
+
+    for( const BENCH_ITEM& item : aItems )
+        aTree.Search( item.m_min, item.m_max, visitor );
+
+    return hits;
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "r",
+            "repeat",
+            _( "number of times each operation is run (default 10)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "input file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum RTREE_BENCH_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+};
+
+
+int rtree_benchmark_main( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program times the building, querying and clearing of an R-tree "
+               "holding the items of the given PCB file, with pooled and individually "
+               "allocated nodes." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long repeat = 10;
+    cl_parser.Found( "repeat", &repeat );
+    repeat = std::max( repeat, 1L );
+
+    std::string filename;
+
+    if( cl_parser.GetParamCount() )
+        filename = cl_parser.GetParam( 0 ).ToStdString();
+
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+    if( !board )
+        return RTREE_BENCH_RET_CODES::LOAD_FAILED;
+
+    const std::vector<BENCH_ITEM> items = collectItems( *board );
+
+    std::cout << "Items: " << items.size() << std::endl;
+
+    const std::pair<const char*, void ( * )( BENCH_TREE&, const std::vector<BENCH_ITEM>& )>
+            builders[] = {
+                { "Insertion", buildByInsertion },
+                { "Bulk load", buildByBulkLoad },
+            };
+
+    // Time each build with the nodes allocated from the pool of the tree and one by one
+    for( const auto& builder : builders )
+    {
+        for( bool useMemPool : { true, false } )
+        {
+            double    buildTime = 0.0;
+            double    queryTime = 0.0;
+            double    clearTime = 0.0;
+            long long hits = 0;
+
+            for( long ii = 0; ii < repeat; ii++ )
+            {
+                std::unique_ptr<BENCH_TREE> tree( new BENCH_TREE( useMemPool ) );
+
+                PROF_COUNTER timer;
+                builder.second( *tree, items );
+                buildTime += timer.msecs();
+
+                timer.Start();
+                hits = queryAll( *tree, items );
+                queryTime += timer.msecs();
+
+                timer.Start();
+                tree.reset();
+                clearTime += timer.msecs();
+            }
+
+            std::cout << builder.first << ", " << ( useMemPool ? "pooled" : "individual" )
+                      << " nodes:" << std::endl;
+            std::cout << "  Build: " << buildTime / repeat << " ms" << std::endl;
+            std::cout << "  Query: " << queryTime / repeat << " ms (" << hits << " hits)"
+                      << std::endl;
+            std::cout << "  Clear: " << clearTime / repeat << " ms" << std::endl;
+        }
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+/*
+ * Define the tool interface
+ */
+KI_TEST::UTILITY_PROGRAM rtree_benchmark_tool = {
+    "rtree_benchmark",
+    "Time the R-tree building and queries on the items of a PCB",
+    rtree_benchmark_main,
+};